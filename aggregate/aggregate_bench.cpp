@@ -0,0 +1,225 @@
+/*
+ * aggregate_bench.cpp
+ * Checks and times SensorAggregate.cpp from the sketch folder on the host.
+ *
+ * The sorting network is checked for every count up to AGGREGATE_MAX with
+ * all inputs of zeros and ones: a compare-exchange network that sorts those
+ * sorts everything (the 0-1 principle). aggregate() is checked against a
+ * plain reference on random readings, with and without outliers. Then each
+ * count is timed, with an insertion sort next to the network for scale, on
+ * random readings and on readings in reverse, its worst case.
+ * The host is much faster than the ATmega4809, but the ratios hold: the
+ * network does the same compare-exchanges for any readings.
+ *
+ * Usage: aggregate_bench [--rounds N]
+ */
+
+#include "SensorAggregate.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace {
+
+const AggregateLimits LIMITS[] = {
+  {1, 3, 10},                       //Moisture probes in the sketch.
+  {0, 0, 0},                        //Plain mean.
+  {2, 2, 0},                        //Tight outliers, no spread floor.
+};
+
+unsigned long seed = 1;
+
+//Small fixed generator, so runs can be compared.
+unsigned random16() {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) & 0x7FFF;
+}
+
+bool checkNetwork() {
+  for (unsigned count = 1; count <= AGGREGATE_MAX; count++) {
+    int16_t values[AGGREGATE_MAX];
+    for (unsigned long bits = 0; bits < (1UL << count); bits++) {
+      for (unsigned i = 0; i < count; i++) {
+        values[i] = (bits >> i) & 1;
+      }
+      aggregateSort(values, count);
+      for (unsigned i = 1; i < count; i++) {
+        if (values[i - 1] > values[i]) {
+          fprintf(stderr, "network for %u does not sort %#lx\n", count, bits);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+long median(const std::vector<long> &sorted) {
+  size_t n = sorted.size();
+  return n % 2 == 1 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+}
+
+//Same definitions as aggregate(), written the obvious way.
+AggregateResult reference(const int16_t *readings, unsigned count, const AggregateLimits &limits) {
+  std::vector<long> sorted(readings, readings + count);
+  std::sort(sorted.begin(), sorted.end());
+  AggregateResult result = {0, 0, 0, 0, 0, 0};
+  result.count = count;
+  result.median = median(sorted);
+  std::vector<long> deviation;
+  for (size_t i = 0; i < sorted.size(); i++) {
+    deviation.push_back(labs(sorted[i] - result.median));
+  }
+  std::sort(deviation.begin(), deviation.end());
+  result.spread = median(deviation);
+
+  std::vector<long> kept;
+  long spread = std::max<long>(result.spread, limits.minSpread);
+  for (size_t i = 0; i < sorted.size(); i++) {
+    if (limits.outlierSpread == 0 || labs(sorted[i] - result.median) <= limits.outlierSpread * spread * 89 / 60) {
+      kept.push_back(sorted[i]);
+    }
+  }
+  result.outliers = count - kept.size();
+  if (kept.size() >= 2u * limits.trim + 2) {
+    kept.erase(kept.end() - limits.trim, kept.end());
+    kept.erase(kept.begin(), kept.begin() + limits.trim);
+  }
+  long sum = 0;
+  for (size_t i = 0; i < kept.size(); i++) {
+    sum += kept[i];
+  }
+  result.used = kept.size();
+  result.mean = sum / (long)kept.size();
+  return result;
+}
+
+//Readings around a level with some noise, and now and then a broken sensor.
+void randomReadings(int16_t *readings, unsigned count) {
+  int level = 300 + random16() % 600;
+  for (unsigned i = 0; i < count; i++) {
+    readings[i] = level + (int)(random16() % 41) - 20;
+    if (random16() % 8 == 0) {
+      readings[i] = random16() % 2 ? random16() % 100 : 1500 + random16() % 500;
+    }
+  }
+}
+
+bool checkAggregate(unsigned rounds) {
+  for (unsigned round = 0; round < rounds; round++) {
+    unsigned count = 1 + random16() % AGGREGATE_MAX;
+    int16_t readings[AGGREGATE_MAX];
+    randomReadings(readings, count);
+    for (size_t l = 0; l < sizeof(LIMITS) / sizeof(LIMITS[0]); l++) {
+      AggregateResult got = aggregate(readings, count, LIMITS[l]);
+      AggregateResult want = reference(readings, count, LIMITS[l]);
+      bool same = got.mean == want.mean && got.median == want.median && got.spread == want.spread &&
+                  got.count == want.count && got.used == want.used && got.outliers == want.outliers;
+      if (!same) {
+        fprintf(stderr, "aggregate of %u readings, limits %zu: mean %d median %d spread %d used %u outliers %u,"
+                " expected %d %d %d %u %u\n", count, l, got.mean, got.median, got.spread, got.used, got.outliers,
+                want.mean, want.median, want.spread, want.used, want.outliers);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void insertionSort(int16_t *values, unsigned count) {
+  for (unsigned i = 1; i < count; i++) {
+    int16_t value = values[i];
+    unsigned j = i;
+    for (; j > 0 && values[j - 1] > value; j--) {
+      values[j] = values[j - 1];
+    }
+    values[j] = value;
+  }
+}
+
+double nanoseconds(clock_t start, unsigned long calls) {
+  return 1e9 * (clock() - start) / CLOCKS_PER_SEC / calls;
+}
+
+//Keeps the results alive so the timed calls are not optimized away.
+volatile long sink;
+
+void timeCount(unsigned count, unsigned long calls) {
+  const unsigned SETS = 256;
+  std::vector<int16_t> sets(SETS * AGGREGATE_MAX);
+  for (unsigned s = 0; s < SETS; s++) {
+    randomReadings(&sets[s * AGGREGATE_MAX], count);
+  }
+  int16_t values[AGGREGATE_MAX];
+
+  clock_t start = clock();
+  for (unsigned long n = 0; n < calls; n++) {
+    memcpy(values, &sets[(n % SETS) * AGGREGATE_MAX], count * sizeof(int16_t));
+    aggregateSort(values, count);
+    sink += values[count / 2];
+  }
+  double network = nanoseconds(start, calls);
+
+  start = clock();
+  for (unsigned long n = 0; n < calls; n++) {
+    memcpy(values, &sets[(n % SETS) * AGGREGATE_MAX], count * sizeof(int16_t));
+    insertionSort(values, count);
+    sink += values[count / 2];
+  }
+  double insertion = nanoseconds(start, calls);
+
+  //Insertion sort depends on the order, readings in reverse are its worst case. The network does not care.
+  std::vector<int16_t> reversed(sets);
+  for (unsigned s = 0; s < SETS; s++) {
+    std::sort(&reversed[s * AGGREGATE_MAX], &reversed[s * AGGREGATE_MAX] + count, std::greater<int16_t>());
+  }
+  start = clock();
+  for (unsigned long n = 0; n < calls; n++) {
+    memcpy(values, &reversed[(n % SETS) * AGGREGATE_MAX], count * sizeof(int16_t));
+    insertionSort(values, count);
+    sink += values[count / 2];
+  }
+  double worst = nanoseconds(start, calls);
+
+  start = clock();
+  for (unsigned long n = 0; n < calls; n++) {
+    sink += aggregate(&sets[(n % SETS) * AGGREGATE_MAX], count, LIMITS[0]).mean;
+  }
+  double whole = nanoseconds(start, calls);
+
+  int16_t probe[AGGREGATE_MAX] = {0};
+  printf("%5u %9u %11.1f %13.1f %10.1f %14.1f\n", count, aggregateSort(probe, count), network, insertion, worst,
+         whole);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned long rounds = 2000000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--rounds") && i + 1 < argc) {
+      rounds = strtoul(argv[++i], NULL, 10);
+    }
+    else {
+      fprintf(stderr, "usage: aggregate_bench [--rounds N]\n");
+      return 2;
+    }
+  }
+
+  if (!checkNetwork() || !checkAggregate(100000)) {
+    fprintf(stderr, "check failed, this is a bug\n");
+    return 1;
+  }
+  printf("network sorts all 0-1 inputs up to %d readings, aggregate() matches the reference\n\n", AGGREGATE_MAX);
+  printf("count exchanges  network ns  insertion ns  worst ns  aggregate() ns\n");
+  for (unsigned count = 2; count <= AGGREGATE_MAX; count *= 2) {
+    timeCount(count, rounds);
+  }
+  return 0;
+}
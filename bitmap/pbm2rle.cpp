@@ -0,0 +1,234 @@
+/*
+ * pbm2rle.cpp
+ * Converts a PBM image into the packed image format drawn by
+ * SeeedGrayOLED::drawCompressedBitmap() and prints it as a PROGMEM C array.
+ *
+ * The image is laid out the way the SH1107G holds it: pages of 8 pixel rows,
+ * one byte per column with the top pixel in bit 0, so drawing needs no bit
+ * shuffling. The bytes are packed with PackBits: runs of 3 or more equal
+ * bytes become a count and the byte, anything else is copied with a count in
+ * front. Blank areas, borders and fills shrink to a few bytes.
+ *
+ * Usage: pbm2rle [--name NAME] IMAGE.pbm
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+const unsigned MAX_COLUMNS = 128;
+const unsigned MAX_PAGES = 16;
+
+struct Image {
+  unsigned width;
+  unsigned height;
+  std::vector<uint8_t> pixels;      //One per pixel, row by row. 1 = lit.
+};
+
+//Next header number, skipping white space and comments.
+bool readNumber(FILE *in, unsigned &value) {
+  int c = fgetc(in);
+  while (c == '#' || c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+    if (c == '#') {
+      while (c != '\n' && c != EOF) {
+        c = fgetc(in);
+      }
+    }
+    c = fgetc(in);
+  }
+  if (c < '0' || c > '9') {
+    return false;
+  }
+  value = 0;
+  while (c >= '0' && c <= '9') {
+    value = value * 10 + (c - '0');
+    c = fgetc(in);
+  }
+  return true;                      //The single white space after the number is used up.
+}
+
+bool readPbm(FILE *in, Image &image) {
+  char magic[2];
+  if (fread(magic, 1, 2, in) != 2 || magic[0] != 'P' || (magic[1] != '1' && magic[1] != '4')) {
+    return false;
+  }
+  if (!readNumber(in, image.width) || !readNumber(in, image.height)) {
+    return false;
+  }
+  image.pixels.assign(image.width * image.height, 0);
+
+  if (magic[1] == '4') {
+    unsigned rowBytes = (image.width + 7) / 8;
+    std::vector<uint8_t> row(rowBytes);
+    for (unsigned y = 0; y < image.height; y++) {
+      if (fread(row.data(), 1, rowBytes, in) != rowBytes) {
+        return false;
+      }
+      for (unsigned x = 0; x < image.width; x++) {
+        image.pixels[y * image.width + x] = (row[x / 8] >> (7 - x % 8)) & 1;
+      }
+    }
+    return true;
+  }
+
+  for (size_t i = 0; i < image.pixels.size(); i++) {
+    int c;
+    do {
+      c = fgetc(in);
+    } while (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+    if (c != '0' && c != '1') {
+      return false;
+    }
+    image.pixels[i] = c == '1';
+  }
+  return true;
+}
+
+//Display RAM bytes, page by page. Rows below the image in the last page are blank.
+std::vector<uint8_t> displayBytes(const Image &image, unsigned pages) {
+  std::vector<uint8_t> bytes;
+  for (unsigned page = 0; page < pages; page++) {
+    for (unsigned x = 0; x < image.width; x++) {
+      uint8_t byte = 0;
+      for (unsigned bit = 0; bit < 8; bit++) {
+        unsigned y = page * 8 + bit;
+        if (y < image.height && image.pixels[y * image.width + x]) {
+          byte |= 1 << bit;
+        }
+      }
+      bytes.push_back(byte);
+    }
+  }
+  return bytes;
+}
+
+std::vector<uint8_t> pack(const std::vector<uint8_t> &in) {
+  std::vector<uint8_t> out;
+  size_t i = 0;
+  while (i < in.size()) {
+    size_t run = 1;
+    while (i + run < in.size() && run < 128 && in[i + run] == in[i]) {
+      run++;
+    }
+    if (run >= 3) {
+      out.push_back((uint8_t)(257 - run));
+      out.push_back(in[i]);
+      i += run;
+      continue;
+    }
+
+    //Copy up to where a run of 3 starts.
+    size_t start = i;
+    while (i < in.size() && i - start < 128) {
+      if (i + 2 < in.size() && in[i] == in[i + 1] && in[i] == in[i + 2]) {
+        break;
+      }
+      i++;
+    }
+    out.push_back((uint8_t)(i - start - 1));
+    out.insert(out.end(), in.begin() + start, in.begin() + i);
+  }
+  return out;
+}
+
+//Same decoding as drawCompressedBitmap(), to check the packed bytes.
+std::vector<uint8_t> unpack(const std::vector<uint8_t> &in, size_t length) {
+  std::vector<uint8_t> out;
+  size_t i = 0;
+  while (out.size() < length && i < in.size()) {
+    uint8_t n = in[i++];
+    if (n < 128) {
+      out.insert(out.end(), in.begin() + i, in.begin() + i + n + 1);
+      i += n + 1;
+    }
+    else if (n > 128) {
+      out.insert(out.end(), 257 - n, in[i++]);
+    }
+  }
+  return out;
+}
+
+std::string arrayName(const char *path) {
+  const char *base = strrchr(path, '/');
+  std::string name = base ? base + 1 : path;
+  name = name.substr(0, name.find('.'));
+  for (size_t i = 0; i < name.size(); i++) {
+    char c = name[i];
+    bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9' && i > 0);
+    if (!ok) {
+      name[i] = '_';
+    }
+  }
+  return name;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const char *path = NULL;
+  std::string name;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--name") && i + 1 < argc) {
+      name = argv[++i];
+    }
+    else if (argv[i][0] != '-' && path == NULL) {
+      path = argv[i];
+    }
+    else {
+      path = NULL;
+      break;
+    }
+  }
+  if (path == NULL) {
+    fprintf(stderr, "usage: pbm2rle [--name NAME] IMAGE.pbm\n");
+    return 2;
+  }
+  if (name.empty()) {
+    name = arrayName(path);
+  }
+
+  FILE *in = fopen(path, "rb");
+  if (in == NULL) {
+    perror(path);
+    return 1;
+  }
+  Image image;
+  bool read = readPbm(in, image);
+  fclose(in);
+  if (!read) {
+    fprintf(stderr, "%s: not a PBM image\n", path);
+    return 1;
+  }
+  unsigned pages = (image.height + 7) / 8;
+  if (image.width == 0 || image.width > MAX_COLUMNS || pages == 0 || pages > MAX_PAGES) {
+    fprintf(stderr, "%s: %u x %u does not fit the %u x %u display\n", path, image.width, image.height,
+            MAX_COLUMNS, MAX_PAGES * 8);
+    return 1;
+  }
+
+  std::vector<uint8_t> raw = displayBytes(image, pages);
+  std::vector<uint8_t> packed = pack(raw);
+  if (unpack(packed, raw.size()) != raw) {
+    fprintf(stderr, "%s: packed image does not decode back, this is a bug\n", path);
+    return 1;
+  }
+
+  const char *base = strrchr(path, '/');
+  printf("//%s, %u x %u pixels: %zu bytes packed from %zu (bitmap/pbm2rle).\n", base ? base + 1 : path,
+         image.width, image.height, packed.size() + 2, raw.size());
+  printf("const unsigned char %s[] PROGMEM = {\n", name.c_str());
+  printf("  %u, %u,\n", image.width, pages);
+  for (size_t i = 0; i < packed.size(); i++) {
+    printf("%s0x%02X%s", i % 16 == 0 ? "  " : "", packed[i],
+           i + 1 == packed.size() ? "\n" : (i % 16 == 15 ? ",\n" : ", "));
+  }
+  printf("};\n");
+  fprintf(stderr, "%s: %u x %u, %zu bytes raw, %zu packed (%.0f%%)\n", path, image.width, image.height,
+          raw.size(), packed.size() + 2, 100.0 * (packed.size() + 2) / raw.size());
+  return 0;
+}
@@ -6,158 +6,157 @@ written by Adafruit Industries
 
 #include <math.h>
 #include "DHT.h"
-//#define NAN 0
 
-DHT::DHT(uint8_t pin, uint8_t type, uint8_t count) {
+DHT *DHT::_receiving = NULL;
+
+DHT::DHT(uint8_t pin, uint8_t type) {
   _pin = pin;
   _type = type;
-  _count = count;
-  firstreading = true;
+  _state = IDLE;
+  _status = DHT_NO_DATA;
+  _firstStart = true;
+  _valid = false;
+  _temperature = NAN;
+  _humidity = NAN;
 }
 
 void DHT::begin(void) {
   // set up the pins!
   pinMode(_pin, INPUT);
   digitalWrite(_pin, HIGH);
-  _lastreadtime = 0;
+  _lastStart = 0;
 }
 
-//boolean S == Scale.  True == Farenheit; False == Celcius
-float DHT::readTemperature(bool S) {
-  float f;
-
-  if (read()) {
-    switch (_type) {
-    case DHT11:
-      f = data[2];
-      if(S)
-      	f = convertCtoF(f);
-      	
-      return f;
-    case DHT22:
-    case DHT21:
-      f = data[2] & 0x7F;
-      f *= 256;
-      f += data[3];
-      f /= 10;
-      if (data[2] & 0x80)
-	f *= -1;
-      if(S)
-	f = convertCtoF(f);
-
-      return f;
-    }
+// Runs one step of the read cycle, never waits for the sensor. Returns the
+// number of milliseconds until the next step is due.
+unsigned long DHT::update(void) {
+  switch (_state) {
+  case IDLE:
+    if (!_firstStart && (millis() - _lastStart < DHT_MIN_INTERVAL))
+      return DHT_MIN_INTERVAL - (millis() - _lastStart);
+    _firstStart = false;
+    _lastStart = millis();
+    // pull the line low to ask for a frame
+    pinMode(_pin, OUTPUT);
+    digitalWrite(_pin, LOW);
+    _startedAt = micros();
+    _state = START;
+    if (_type == DHT11)
+      return DHT11_START_LOW / 1000 + 1;  // released on a later call, the sensor waits for it
+    delayMicroseconds(DHT22_START_LOW);
+    // fall through
+  case START:
+    if ((_type == DHT11) && (micros() - _startedAt < DHT11_START_LOW))
+      return (DHT11_START_LOW - (micros() - _startedAt)) / 1000 + 1;
+    if (_receiving != NULL)
+      return 1;                 // another sensor is receiving, keep holding the line
+    _data[0] = _data[1] = _data[2] = _data[3] = _data[4] = 0;
+    _edges = 0;
+    _receiving = this;
+    attachInterrupt(digitalPinToInterrupt(_pin), edgeISR, FALLING);
+    // release the line, the pull-up takes it high and the sensor answers
+    pinMode(_pin, INPUT);
+    _startedAt = micros();
+    _state = RECEIVING;
+    return DHT_FRAME_TIMEOUT / 1000;
+  case RECEIVING:
+    if (_edges < DHT_FRAME_EDGES && (micros() - _startedAt < DHT_FRAME_TIMEOUT))
+      return (DHT_FRAME_TIMEOUT - (micros() - _startedAt)) / 1000 + 1;
+    detachInterrupt(digitalPinToInterrupt(_pin));
+    _receiving = NULL;
+    finishFrame();
+    _state = IDLE;
+    break;
   }
-  Serial.print("Read fail");
-  return NAN;
+  // the frame may finish late, e.g. after a blocking delay() in the sketch
+  if (millis() - _lastStart < DHT_MIN_INTERVAL)
+    return DHT_MIN_INTERVAL - (millis() - _lastStart);
+  return 0;
 }
 
-float DHT::convertCtoF(float c) {
-	return c * 9 / 5 + 32;
+// A frame has been asked for and not finished yet. update() only starts a
+// new one when it is called while not busy.
+boolean DHT::busy(void) {
+  return _state != IDLE;
 }
 
-float DHT::readHumidity(void) {
-  float f;
-  if (read()) {
-    switch (_type) {
-    case DHT11:
-      f = data[0];
-      return f;
-    case DHT22:
-    case DHT21:
-      f = data[0];
-      f *= 256;
-      f += data[1];
-      f /= 10;
-      return f;
-    }
+// Falling edge on the data line. The time since the previous falling edge is
+// the 50 us low that starts a bit plus its high time, which carries the value.
+void DHT::edgeISR(void) {
+  DHT *self = _receiving;
+  if (self == NULL)
+    return;
+  unsigned long now = micros();
+  uint8_t edge = self->_edges;
+  if (edge >= DHT_FRAME_EDGES)
+    return;
+  if (edge >= 2) {
+    uint8_t bit = edge - 2;
+    self->_data[bit/8] <<= 1;
+    if (now - self->_lastEdge > DHT_ONE_PERIOD)
+      self->_data[bit/8] |= 1;
   }
-  Serial.print("Read fail");
-  return NAN;
+  self->_lastEdge = now;
+  self->_edges = edge + 1;
 }
 
-
-boolean DHT::read(void) {
-  uint8_t laststate = HIGH;
-  uint8_t counter = 0;
-  uint8_t j = 0, i;
-  unsigned long currenttime;
-
-  // pull the pin high and wait 250 milliseconds
-  digitalWrite(_pin, HIGH);
-  delay(250);
-
-  currenttime = millis();
-  if (currenttime < _lastreadtime) {
-    // ie there was a rollover
-    _lastreadtime = 0;
+void DHT::finishFrame(void) {
+  if (_edges < DHT_FRAME_EDGES) {
+    _status = DHT_TIMEOUT;
+    return;
   }
-  if (!firstreading && ((currenttime - _lastreadtime) < 2000)) {
-    return true; // return last correct measurement
-    //delay(2000 - (currenttime - _lastreadtime));
+  // check that the checksum matches
+  if (_data[4] != ((_data[0] + _data[1] + _data[2] + _data[3]) & 0xFF)) {
+    _status = DHT_CHECKSUM_ERROR;
+    return;
   }
-  firstreading = false;
-  /*
-    Serial.print("Currtime: "); Serial.print(currenttime);
-    Serial.print(" Lasttime: "); Serial.print(_lastreadtime);
-  */
-  _lastreadtime = millis();
-
-  data[0] = data[1] = data[2] = data[3] = data[4] = 0;
-  
-  // now pull it low for ~20 milliseconds
-  pinMode(_pin, OUTPUT);
-  digitalWrite(_pin, LOW);
-  delay(20);
-  //cli();
-  digitalWrite(_pin, HIGH);
-  delayMicroseconds(40);
-  pinMode(_pin, INPUT);
-
-  // read in timings
-  for ( i=0; i< MAXTIMINGS; i++) {
-    counter = 0;
-    while (digitalRead(_pin) == laststate) {
-      counter++;
-      delayMicroseconds(1);
-      if (counter == 255) {
-        break;
-      }
-    }
-    laststate = digitalRead(_pin);
-
-    if (counter == 255) break;
-
-    // ignore first 3 transitions
-    if ((i >= 4) && (i%2 == 0)) {
-      // shove each bit into the storage bytes
-      data[j/8] <<= 1;
-      if (counter > _count)
-        data[j/8] |= 1;
-      j++;
-    }
-
+  switch (_type) {
+  case DHT11:
+    _humidity = _data[0];
+    _temperature = _data[2];
+    break;
+  case DHT22:
+  case DHT21:
+    _humidity = _data[0];
+    _humidity *= 256;
+    _humidity += _data[1];
+    _humidity /= 10;
+    _temperature = _data[2] & 0x7F;
+    _temperature *= 256;
+    _temperature += _data[3];
+    _temperature /= 10;
+    if (_data[2] & 0x80)
+      _temperature *= -1;
+    break;
   }
+  _status = DHT_OK;
+  _valid = true;
+  _readAt = millis();
+}
 
-  //sei();
-  
-  /*
-  Serial.println(j, DEC);
-  Serial.print(data[0], HEX); Serial.print(", ");
-  Serial.print(data[1], HEX); Serial.print(", ");
-  Serial.print(data[2], HEX); Serial.print(", ");
-  Serial.print(data[3], HEX); Serial.print(", ");
-  Serial.print(data[4], HEX); Serial.print(" =? ");
-  Serial.println(data[0] + data[1] + data[2] + data[3], HEX);
-  */
+//boolean S == Scale.  True == Farenheit; False == Celcius
+//Last good reading, NAN until the first frame has been received.
+float DHT::readTemperature(bool S) {
+  if (S)
+    return convertCtoF(_temperature);
+  return _temperature;
+}
 
-  // check we read 40 bits and that the checksum matches
-  if ((j >= 40) && 
-      (data[4] == ((data[0] + data[1] + data[2] + data[3]) & 0xFF)) ) {
-    return true;
-  }
-  
+float DHT::convertCtoF(float c) {
+	return c * 9 / 5 + 32;
+}
 
-  return false;
+float DHT::readHumidity(void) {
+  return _humidity;
+}
+
+// Milliseconds since the last good frame, or the largest value if there is none.
+unsigned long DHT::age(void) {
+  if (!_valid)
+    return (unsigned long)-1;
+  return millis() - _readAt;
+}
 
+uint8_t DHT::status(void) {
+  return _status;
 }
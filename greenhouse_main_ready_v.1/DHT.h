@@ -6,50 +6,67 @@
  #include "WProgram.h"
 #endif
 
-// WioLTE STM32F405 compatibility
-#define STM32F405
-
-
-// 8 MHz(ish) AVR ---------------------------------------------------------
-#if (F_CPU >= 7400000UL) && (F_CPU <= 9500000UL)
-#define COUNT 3
-// 16 MHz(ish) AVR --------------------------------------------------------
-#elif (F_CPU >= 15400000UL) && (F_CPU <= 19000000L)
-#define COUNT 6
-#elif defined(STM32F405)
-#define COUNT 40
-#else
-#error "CPU SPEED NOT SUPPORTED"
-#endif
-
 /* DHT library
 
 MIT license
 written by Adafruit Industries
 */
 
-// how many timing transitions we need to keep track of. 2 * number bits + extra
-#define MAXTIMINGS 85
+/* Non-blocking driver. update() is called from the main loop and walks the
+   sensor through start pulse, response and idle without waiting. It returns
+   how many milliseconds may pass before it needs to be called again. The 40-bit
+   frame is decoded from falling-edge timestamps taken with micros() in a pin
+   interrupt, so it does not depend on the CPU clock. Readings are cached and
+   served in O(1) together with their age and the status of the last frame.
+   Only one DHT can be receiving at a time. */
 
 #define DHT11 11
 #define DHT22 22
 #define DHT21 21
 #define AM2301 21
 
+// Status of the last frame
+#define DHT_OK 0
+#define DHT_NO_DATA 1           // no frame received yet
+#define DHT_TIMEOUT 2           // fewer than 42 falling edges arrived
+#define DHT_CHECKSUM_ERROR 3
+
+#define DHT_MIN_INTERVAL 2000   // ms between start pulses, the sensors need 1-2 s
+#define DHT11_START_LOW 20000   // us, at least 18 ms for DHT11
+#define DHT22_START_LOW 1100    // us, 1-10 ms for DHT21/DHT22
+#define DHT_FRAME_TIMEOUT 10000 // us, a frame takes about 5 ms
+#define DHT_ONE_PERIOD 100      // us between falling edges: 50 low + 26-28 high = 0, 50 + 70 = 1
+#define DHT_FRAME_EDGES 42      // response start, start of bit 0, and the end of each of the 40 bits
+
 class DHT {
  private:
-  uint8_t data[6];
-  uint8_t _pin, _type, _count;
-  boolean read(void);
-  unsigned long _lastreadtime;
-  boolean firstreading;
+  enum { IDLE, START, RECEIVING };
+
+  uint8_t _pin, _type, _state, _status;
+  unsigned long _startedAt;     // micros() when the current phase began
+  unsigned long _lastStart;     // millis() of the last start pulse
+  unsigned long _readAt;        // millis() of the last good frame
+  boolean _firstStart, _valid;
+  float _temperature, _humidity;
+
+  volatile uint8_t _data[5];
+  volatile uint8_t _edges;
+  volatile unsigned long _lastEdge;
+
+  static DHT *_receiving;
+  static void edgeISR(void);
+  void finishFrame(void);
 
  public:
-  DHT(uint8_t pin, uint8_t type, uint8_t count=COUNT);
+  DHT(uint8_t pin, uint8_t type);
   void begin(void);
+  unsigned long update(void);
+  boolean busy(void);
   float readTemperature(bool S=false);
   float convertCtoF(float);
   float readHumidity(void);
+  unsigned long age(void);
+  uint8_t status(void);
 
 };
 #endif
@@ -0,0 +1,36 @@
+#include "EventQueue.h"
+
+EventQueue::EventQueue() {
+  head = 0;
+  tail = 0;
+  droppedCount = 0;
+}
+
+//The event is written before 'head' moves, so pop() never sees a slot that is half written.
+bool EventQueue::push(uint8_t type, int16_t value) {
+  uint8_t at = head;
+  if ((uint8_t)(at - tail) >= EVENT_QUEUE_SIZE) {
+    droppedCount++;
+    return false;
+  }
+  events[at & (EVENT_QUEUE_SIZE - 1)].type = type;
+  events[at & (EVENT_QUEUE_SIZE - 1)].value = value;
+  head = at + 1;
+  return true;
+}
+
+//The event is read before 'tail' moves, so push() does not reuse the slot before that.
+bool EventQueue::pop(Event &event) {
+  uint8_t at = tail;
+  if (at == head) {
+    return false;
+  }
+  event.type = events[at & (EVENT_QUEUE_SIZE - 1)].type;
+  event.value = events[at & (EVENT_QUEUE_SIZE - 1)].value;
+  tail = at + 1;
+  return true;
+}
+
+uint8_t EventQueue::dropped() {
+  return droppedCount;
+}
@@ -0,0 +1,45 @@
+#ifndef EventQueue_H_
+#define EventQueue_H_
+#include "Arduino.h"
+/*------------------------------------------------------//
+  Queue of small events from interrupts to loop().
+
+  Interrupts only push an event, a type and a 16-bit value, and return.
+  loop() pops the events and does the work: changing display state,
+  printing, reading the clock. An interrupt then takes a few microseconds
+  whatever the work is, so it cannot hold off the pulse counting interrupts
+  or wait on a full serial buffer.
+
+  Single producer, single consumer, without disabling interrupts: push()
+  only moves 'head' and pop() only moves 'tail', both one byte. On the AVR
+  interrupts do not nest, so all interrupts together are the one producer.
+  A push to a full queue drops the event and counts it.
+*/
+
+#define EVENT_QUEUE_SIZE 16         //Power of two, at most 128.
+
+struct Event {
+  uint8_t type;                     //Defined by the sketch.
+  int16_t value;
+};
+
+class EventQueue {
+
+  volatile Event events[EVENT_QUEUE_SIZE];
+  volatile uint8_t head;            //Events pushed, wraps. Only changed by push().
+  volatile uint8_t tail;            //Events popped, wraps. Only changed by pop().
+  volatile uint8_t droppedCount;
+
+  public:
+    EventQueue();
+
+    //Interrupt side. Returns false, and counts the event, if the queue is full.
+    bool push(uint8_t type, int16_t value);
+    //loop() side. Returns false if the queue is empty.
+    bool pop(Event &event);
+
+    //Events dropped because the queue was full, for tuning.
+    uint8_t dropped();
+};
+
+#endif  /* EventQueue_H_ */
@@ -0,0 +1,229 @@
+#include "History.h"
+
+/*
+  ===================
+  || Tier storage. ||
+  =================== */
+void HistoryTier::begin(uint8_t *memory, uint16_t bytes, uint16_t blockSize, uint8_t width) {
+  this->memory = memory;
+  this->blockSize = blockSize;
+  this->width = width;
+  blocks = bytes / blockSize;
+  oldest = 0;
+  used = 0;
+  fill = 0;
+  stored = 0;
+}
+
+uint8_t *HistoryTier::blockAt(uint8_t fromOldest) {
+  return memory + (uint16_t)((oldest + fromOldest) % blocks) * blockSize;
+}
+
+//Bit mask of changed fields, then each change as a zig-zag varint: 0, -1, 1, -2, 2 ... become 0, 1, 2, 3, 4 ...
+uint8_t HistoryTier::encode(const int16_t *row, const int16_t *base, uint8_t *out) {
+  uint8_t maskBytes = (width + 7) / 8;
+  uint8_t length = maskBytes;
+  memset(out, 0, maskBytes);
+  for (uint8_t i = 0; i < width; i++) {
+    long delta = (long)row[i] - base[i];
+    if (delta == 0) {
+      continue;
+    }
+    out[i / 8] |= 1 << (i % 8);
+    unsigned long zigzag = delta < 0 ? ((unsigned long)(-delta) << 1) - 1 : (unsigned long)delta << 1;
+    while (zigzag >= 0x80) {
+      out[length++] = (zigzag & 0x7F) | 0x80;
+      zigzag >>= 7;
+    }
+    out[length++] = zigzag;
+  }
+  return length;
+}
+
+void HistoryTier::append(const int16_t *row) {
+  uint8_t encoded[HISTORY_MAX_WIDTH * 3 + HISTORY_MAX_WIDTH / 8 + 1];
+  uint8_t length = used > 0 ? encode(row, last, encoded) : 0;
+
+  if (used == 0 || fill + length > blockSize) {
+    //Start a new block, dropping the oldest when all are in use. Its first row is stored against zero.
+    if (used == blocks) {
+      stored -= blockAt(0)[0];
+      oldest = (oldest + 1) % blocks;
+      used--;
+    }
+    used++;
+    blockAt(used - 1)[0] = 0;
+    fill = 1;
+    int16_t zero[HISTORY_MAX_WIDTH];
+    memset(zero, 0, sizeof(zero));
+    length = encode(row, zero, encoded);
+  }
+
+  uint8_t *block = blockAt(used - 1);
+  memcpy(block + fill, encoded, length);
+  fill += length;
+  block[0]++;
+  stored++;
+  memcpy(last, row, width * sizeof(int16_t));
+}
+
+uint16_t HistoryTier::rows() {
+  return stored;
+}
+
+const int16_t *HistoryTier::newest() {
+  return last;
+}
+
+void HistoryTier::rewind(HistoryCursor &cursor) {
+  cursor.block = 0;
+  cursor.rowsLeft = used > 0 ? blockAt(0)[0] : 0;
+  cursor.offset = 1;
+  memset(cursor.values, 0, sizeof(cursor.values));
+}
+
+bool HistoryTier::next(HistoryCursor &cursor) {
+  while (cursor.rowsLeft == 0) {
+    if (cursor.block + 1 >= used) {
+      return false;
+    }
+    cursor.block++;
+    cursor.rowsLeft = blockAt(cursor.block)[0];
+    cursor.offset = 1;
+    memset(cursor.values, 0, sizeof(cursor.values));
+  }
+
+  const uint8_t *block = blockAt(cursor.block);
+  const uint8_t *mask = block + cursor.offset;
+  uint16_t offset = cursor.offset + (width + 7) / 8;
+  for (uint8_t i = 0; i < width; i++) {
+    if ((mask[i / 8] & (1 << (i % 8))) == 0) {
+      continue;
+    }
+    unsigned long zigzag = 0;
+    uint8_t shift = 0;
+    uint8_t b;
+    do {
+      b = block[offset++];
+      zigzag |= (unsigned long)(b & 0x7F) << shift;
+      shift += 7;
+    } while (b & 0x80);
+    long delta = zigzag & 1 ? -(long)((zigzag + 1) >> 1) : (long)(zigzag >> 1);
+    cursor.values[i] += delta;
+  }
+  cursor.offset = offset;
+  cursor.rowsLeft--;
+  return true;
+}
+
+/*
+  ================
+  || Hour sums. ||
+  ================ */
+void History::Accumulator::clear() {
+  count = 0;
+}
+
+void History::Accumulator::add(const int16_t *values) {
+  for (uint8_t i = 0; i < HISTORY_CHANNELS; i++) {
+    if (count == 0) {
+      min[i] = values[i];
+      max[i] = values[i];
+      sum[i] = 0;
+    }
+    min[i] = values[i] < min[i] ? values[i] : min[i];
+    max[i] = values[i] > max[i] ? values[i] : max[i];
+    sum[i] += values[i];
+  }
+  count++;
+}
+
+void History::Accumulator::row(int16_t *out) {
+  for (uint8_t i = 0; i < HISTORY_CHANNELS; i++) {
+    out[3 * i] = sum[i] / count;
+    out[3 * i + 1] = min[i];
+    out[3 * i + 2] = max[i];
+  }
+}
+
+/*
+  ==============
+  || History. ||
+  ============== */
+History::History() {
+  minuteTier.begin(minuteMemory, HISTORY_MINUTE_BYTES, HISTORY_MINUTE_BLOCK, HISTORY_CHANNELS);
+  hourTier.begin(hourMemory, HISTORY_HOUR_BYTES, HISTORY_HOUR_BLOCK, HISTORY_MAX_WIDTH);
+  hourOpen.clear();
+  samples = 0;
+}
+
+void History::add(const int16_t *values) {
+  minuteTier.append(values);
+  samples++;
+
+  hourOpen.add(values);
+  if (hourOpen.count == 60) {
+    int16_t row[HISTORY_MAX_WIDTH];
+    hourOpen.row(row);
+    hourTier.append(row);
+    hourOpen.clear();
+  }
+}
+
+unsigned long History::count() {
+  return samples;
+}
+
+bool History::summary(uint8_t channel, uint16_t minutes, HistorySummary &out) {
+  if (samples == 0 || channel >= HISTORY_CHANNELS) {
+    return false;
+  }
+
+  //Every sample if the minute tier reaches back far enough, else the current hour and enough whole hours before it.
+  HistoryTier *tier = &minuteTier;
+  uint8_t period = 1;
+  uint16_t wanted = minutes;
+  long sum = 0;
+  uint16_t covered = 0;
+  out.min = 32767;
+  out.max = -32768;
+  if (wanted > minuteTier.rows()) {
+    tier = &hourTier;
+    period = 60;
+    wanted = minutes > hourOpen.count ? (minutes - hourOpen.count + 59) / 60 : 0;
+    if (hourOpen.count > 0) {
+      sum = hourOpen.sum[channel];
+      covered = hourOpen.count;
+      out.min = hourOpen.min[channel];
+      out.max = hourOpen.max[channel];
+    }
+  }
+  if (wanted > tier->rows()) {
+    wanted = tier->rows();
+  }
+
+  HistoryCursor cursor;
+  uint16_t skip = tier->rows() - wanted;
+  tier->rewind(cursor);
+  while (tier->next(cursor)) {
+    if (skip > 0) {
+      skip--;
+      continue;
+    }
+    //Samples have one value per channel, hours have mean, min and max.
+    const int16_t *field = period == 1 ? &cursor.values[channel] : &cursor.values[3 * channel];
+    int16_t low = period == 1 ? field[0] : field[1];
+    int16_t high = period == 1 ? field[0] : field[2];
+    sum += (long)field[0] * period;
+    covered += period;
+    out.min = low < out.min ? low : out.min;
+    out.max = high > out.max ? high : out.max;
+  }
+
+  if (covered == 0) {
+    return false;                                           //Nothing asked for, or nothing stored in the tier used.
+  }
+  out.mean = sum / covered;
+  out.minutes = covered;
+  return true;
+}
@@ -0,0 +1,106 @@
+#ifndef History_H_
+#define History_H_
+#include "Arduino.h"
+/*------------------------------------------------------//
+  Compressed in-RAM history of the sensor channels.
+
+  History keeps one sample of every channel per minute in two tiers with a
+  fixed RAM budget each:
+    minutes   every sample, as long as it fits (an hour or more)
+    hours     mean, min and max per channel for each hour (a day or more)
+  When a tier is full its oldest block is dropped.
+
+  A tier is a ring of fixed-size blocks. A block starts with its row count,
+  each row with a bit mask of the fields that changed since the row before,
+  followed by the changes as zig-zag varints (small steps up or down take one
+  byte, a field that did not change takes one bit). The first row of a block
+  is stored against zero, so every block can be decoded on its own.
+
+  Mean, min and max of the current hour are kept as it builds up, so
+  summary() only decodes one tier: O(tier size). Samples are used as long as
+  the minute tier reaches back far enough, then hours.
+*/
+
+#define HISTORY_CHANNELS 10
+#define HISTORY_MAX_WIDTH (3 * HISTORY_CHANNELS)      //Values per row in an aggregate tier.
+#define HISTORY_MINUTE_BYTES 768
+#define HISTORY_HOUR_BYTES 1280
+#define HISTORY_MINUTE_BLOCK 128                      //Must hold one worst-case row: mask + 3 bytes per value.
+#define HISTORY_HOUR_BLOCK 256                        //The first row of a block costs most, larger blocks hold more.
+
+struct HistoryCursor {
+  uint8_t block;                    //Blocks from the oldest.
+  uint8_t rowsLeft;                 //Rows left in the block.
+  uint16_t offset;                  //Byte offset of the next row.
+  int16_t values[HISTORY_MAX_WIDTH];  //Row just read.
+};
+
+struct HistorySummary {
+  int16_t mean;
+  int16_t min;
+  int16_t max;
+  uint16_t minutes;                 //Minutes covered, samples or whole hours plus the current one.
+};
+
+class HistoryTier {
+
+  uint8_t *memory;
+  uint16_t blockSize;
+  uint8_t blocks;
+  uint8_t oldest;                   //Block index of the oldest block.
+  uint8_t used;                     //Blocks holding rows.
+  uint16_t fill;                    //Bytes used in the newest block.
+  uint16_t stored;                  //Rows in all blocks.
+  uint8_t width;                    //Values per row.
+  int16_t last[HISTORY_MAX_WIDTH];  //Newest row, the next row is stored as changes from it.
+
+  uint8_t encode(const int16_t *row, const int16_t *base, uint8_t *out);
+  uint8_t *blockAt(uint8_t fromOldest);
+
+  public:
+    void begin(uint8_t *memory, uint16_t bytes, uint16_t blockSize, uint8_t width);
+    void append(const int16_t *row);
+    uint16_t rows();
+    //Row appended last, valid when rows() > 0.
+    const int16_t *newest();
+
+    //Read rows oldest first: rewind() and then next() until it returns false.
+    void rewind(HistoryCursor &cursor);
+    bool next(HistoryCursor &cursor);
+};
+
+class History {
+
+  struct Accumulator {
+    int16_t min[HISTORY_CHANNELS];
+    int16_t max[HISTORY_CHANNELS];
+    long sum[HISTORY_CHANNELS];
+    uint8_t count;
+
+    void clear();
+    void add(const int16_t *values);
+    //Mean, min and max of each channel after each other.
+    void row(int16_t *out);
+  };
+
+  uint8_t minuteMemory[HISTORY_MINUTE_BYTES];
+  uint8_t hourMemory[HISTORY_HOUR_BYTES];
+  Accumulator hourOpen;             //Current hour, not yet in the hour tier.
+  unsigned long samples;
+
+  public:
+    HistoryTier minuteTier;         //Rows of HISTORY_CHANNELS values.
+    HistoryTier hourTier;           //Rows of mean, min, max per channel.
+
+    History();
+
+    //Add the per-minute sample, one value per channel.
+    void add(const int16_t *values);
+    //Samples added since start.
+    unsigned long count();
+    //Mean, min and max of one channel over at least the last 'minutes', or
+    //as far back as history goes. False if no sample is covered, e.g. 'minutes' is 0.
+    bool summary(uint8_t channel, uint16_t minutes, HistorySummary &out);
+};
+
+#endif  /* History_H_ */
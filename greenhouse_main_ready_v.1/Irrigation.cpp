@@ -0,0 +1,102 @@
+#include "Irrigation.h"
+#include <string.h>
+
+IrrigationScheduler::IrrigationScheduler(const IrrigationZone *zones, uint8_t count) {
+  this->zones = zones;
+  this->count = count < IRRIGATION_ZONES_MAX ? count : IRRIGATION_ZONES_MAX;
+  memset(state, 0, sizeof(state));
+  running = IRRIGATION_IDLE;
+  after = this->count - 1;                                  //The first zone is looked at first.
+}
+
+uint8_t IrrigationScheduler::size() {
+  return count;
+}
+
+const IrrigationZone &IrrigationScheduler::zone(uint8_t index) {
+  return zones[index < count ? index : 0];
+}
+
+void IrrigationScheduler::evaluate(uint8_t index, const AggregateResult &moisture) {
+  if (index >= count) {
+    return;
+  }
+  ZoneState &s = state[index];
+  s.known = moisture.count > 0;
+  s.moisture = moisture.mean;
+  s.dry = s.known == true && moisture.mean <= zones[index].dryBelow;
+  s.wet = s.known == true && moisture.mean > zones[index].wetAbove;
+}
+
+//Round robin from the zone after the one watered last.
+uint8_t IrrigationScheduler::next() {
+  for (uint8_t n = 1; n <= count; n++) {
+    uint8_t index = (after + n) % count;
+    if (state[index].dry == true && state[index].wet == false) {
+      return index;
+    }
+  }
+  return IRRIGATION_IDLE;
+}
+
+void IrrigationScheduler::start(uint8_t index) {
+  if (index < count) {
+    running = index;
+    after = index;
+  }
+}
+
+void IrrigationScheduler::finish(unsigned long pulses) {
+  if (running != IRRIGATION_IDLE) {
+    state[running].pulses += pulses;
+  }
+  running = IRRIGATION_IDLE;
+}
+
+uint8_t IrrigationScheduler::active() {
+  return running;
+}
+
+bool IrrigationScheduler::known(uint8_t index) {
+  return index < count && state[index].known == true;
+}
+
+bool IrrigationScheduler::dry(uint8_t index) {
+  return index < count && state[index].dry == true;
+}
+
+bool IrrigationScheduler::wet(uint8_t index) {
+  return index < count && state[index].wet == true;
+}
+
+int16_t IrrigationScheduler::moisture(uint8_t index) {
+  return index < count ? state[index].moisture : 0;
+}
+
+bool IrrigationScheduler::anyDry() {
+  for (uint8_t i = 0; i < count; i++) {
+    if (state[i].dry == true) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IrrigationScheduler::anyWet() {
+  for (uint8_t i = 0; i < count; i++) {
+    if (state[i].wet == true) {
+      return true;
+    }
+  }
+  return false;
+}
+
+unsigned long IrrigationScheduler::pulses(uint8_t index) {
+  return index < count ? state[index].pulses : 0;
+}
+
+void IrrigationScheduler::newDay() {
+  for (uint8_t i = 0; i < count; i++) {
+    state[i].pulses = 0;
+  }
+}
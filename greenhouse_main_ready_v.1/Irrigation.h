@@ -0,0 +1,85 @@
+#ifndef Irrigation_H_
+#define Irrigation_H_
+#include "Arduino.h"
+#include "SensorAggregate.h"
+/*------------------------------------------------------//
+  Irrigation zones sharing one water pump and one flow sensor.
+
+  A zone is a group of pots watered together: the moisture probes in them,
+  the relay channel of the valve that lets water into them, its moisture
+  thresholds and the water dose of one watering. A zone without a valve is
+  watered by the pump alone, which is how a single bed is plumbed.
+
+  The sketch aggregates each zone's probes and hands the result to
+  evaluate(). next() picks the zone to water: dry, not wet, and after the
+  zone watered last, so that every dry zone gets its turn before any zone
+  gets a second one. Only one zone is watered at a time: start() marks the
+  zone whose valve is open, finish() closes the run and adds the flow
+  sensor pulses counted during it to that zone. The pump and flow sensor
+  are shared, so whatever they measure between start() and finish() is the
+  active zone's water.
+
+  The relay, the pump and the flow sensor stay in the sketch. This class
+  only decides and keeps count.
+*/
+
+#define IRRIGATION_ZONES_MAX 8      //One valve on each channel of an 8-channel relay board.
+#define IRRIGATION_IDLE 0xFF        //No zone.
+
+struct IrrigationZone {
+  const char *name;                 //Shown on the display, at most 5 characters.
+  uint8_t probes;                   //Bit n: moisture probe n, the n:th sensor added to the group (0x36 + n as wired).
+  uint8_t valve;                    //Relay channel of the zone's valve, 0 for no valve.
+  unsigned short dryBelow;          //Moisture at or below this is dry, the zone is watered.
+  unsigned short wetAbove;          //Moisture above this is wet.
+  unsigned short dose;              //Milliliters per watering.
+};
+
+class IrrigationScheduler {
+
+  struct ZoneState {
+    int16_t moisture;               //Aggregate of the zone's usable probes.
+    bool known;                     //At least one probe could be used.
+    bool dry;
+    bool wet;
+    unsigned long pulses;           //Flow sensor pulses of the zone's runs since newDay().
+  };
+
+  const IrrigationZone *zones;
+  ZoneState state[IRRIGATION_ZONES_MAX];
+  uint8_t count;
+  uint8_t running;                  //Zone being watered, IRRIGATION_IDLE when none.
+  uint8_t after;                    //Zone watered last, next() starts looking after it.
+
+  public:
+    IrrigationScheduler(const IrrigationZone *zones, uint8_t count);
+
+    uint8_t size();
+    const IrrigationZone &zone(uint8_t index);
+
+    //New moisture of a zone from its probes. No readings (count 0) makes the zone neither dry nor wet.
+    void evaluate(uint8_t index, const AggregateResult &moisture);
+    //Zone to water next, IRRIGATION_IDLE if none is dry. Nothing changes until start().
+    uint8_t next();
+    //The zone's valve is open and the pump runs.
+    void start(uint8_t index);
+    //The run has ended, 'pulses' flow sensor pulses were counted during it.
+    void finish(unsigned long pulses);
+    //Zone being watered, IRRIGATION_IDLE when none.
+    uint8_t active();
+
+    bool known(uint8_t index);
+    bool dry(uint8_t index);
+    bool wet(uint8_t index);
+    int16_t moisture(uint8_t index);
+    //Some zone is dry, some zone is wet.
+    bool anyDry();
+    bool anyWet();
+
+    //Flow sensor pulses of a zone since newDay().
+    unsigned long pulses(uint8_t index);
+    //Start counting water over, at local midnight.
+    void newDay();
+};
+
+#endif  /* Irrigation_H_ */
@@ -1,10 +1,98 @@
 #include "MoistureSensor.h"
 
+void MoistureSensor::start(byte address) {
+  this->address = address;
+  ss.begin(address);
+}
+
 /*
 ======================================================================
 || Reads moisture value from moisture sensor and returns its value. ||
 ====================================================================== */
+int MoistureSensor::moistureRead() {
+  return ss.touchRead(0);
+}
+
+//Same register access as one attempt of Adafruit_seesaw::touchRead(0), with the conversion wait left to the caller.
+void MoistureSensor::startRead() {
+  Wire.beginTransmission(address);
+  Wire.write(SEESAW_TOUCH_BASE);
+  Wire.write(SEESAW_TOUCH_CHANNEL_OFFSET);
+  Wire.endTransmission();
+}
+
+int MoistureSensor::finishRead() {
+  if (Wire.requestFrom(address, (uint8_t)2) != 2) {
+    while (Wire.available() > 0) {
+      Wire.read();                      //Drop what came of a short read.
+    }
+    return MOISTURE_NO_READING;
+  }
+  uint16_t high = Wire.read() & 0xFF;
+  uint16_t low = Wire.read() & 0xFF;
+  return high << 8 | low;
+}
+
+/*
+  =======================
+  || Group of sensors. ||
+  ======================= */
+MoistureSensorGroup::MoistureSensorGroup() {
+  count = 0;
+  converting = 0;
+}
+
+bool MoistureSensorGroup::add(byte address) {
+  if (count == MOISTURE_GROUP_MAX) {
+    return false;
+  }
+  sensors[count].start(address);
+  values[count] = 0;
+  count++;
+  return true;
+}
+
+uint8_t MoistureSensorGroup::size() {
+  return count;
+}
+
+void MoistureSensorGroup::startRead() {
+  startRead(0xFF);
+}
+
+void MoistureSensorGroup::startRead(uint8_t which) {
+  converting = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (which & (1 << i)) {
+      sensors[i].startRead();
+      converting |= 1 << i;
+    }
+  }
+  startedAt = micros();
+}
+
+void MoistureSensorGroup::finishRead() {
+  if (converting == 0) {
+    return;
+  }
+  //startedAt is after the last sensor was started, so when its time is up all conversions are done.
+  unsigned long elapsed = micros() - startedAt;
+  if (elapsed < MOISTURE_CONVERSION_TIME) {
+    delayMicroseconds(MOISTURE_CONVERSION_TIME - elapsed);
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    if (converting & (1 << i)) {
+      values[i] = sensors[i].finishRead();
+    }
+  }
+  converting = 0;
+}
+
+void MoistureSensorGroup::read() {
+  startRead();
+  finishRead();
+}
 
- 
- 
- 
+int MoistureSensorGroup::value(uint8_t index) {
+  return index < count ? values[index] : 0;
+}
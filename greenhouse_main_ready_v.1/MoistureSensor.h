@@ -4,25 +4,71 @@
 #include "Adafruit_seesaw.h"
 /*------------------------------------------------------//
   Moisture sensors.
+
+  A reading is a touch conversion on the seesaw: select the touch register,
+  wait MOISTURE_CONVERSION_TIME while the sensor converts, then read the
+  result. moistureRead() does all three and waits. startRead() and
+  finishRead() split it, so that several sensors can convert at the same
+  time, or other work can be done during the wait.
+
+  MoistureSensorGroup does that for up to MOISTURE_GROUP_MAX sensors: all
+  conversions are started first and all results collected after a single
+  conversion time, instead of one conversion time per sensor. A read can be
+  limited to some of the sensors, the others keep their last value.
+
+  The wait is the one Adafruit_seesaw 1.4 and later use in touchRead()
+  before their first read attempt. touchRead() then tries up to 5 times
+  while the result is 65535. The split read makes one attempt: a sensor
+  that is not done reads 65535 and one that does not answer in full reads
+  MOISTURE_NO_READING, both out of any sensible range.
 */
 
+#define MOISTURE_CONVERSION_TIME 3000     //us, seesaw touch conversion, as in Adafruit_seesaw::touchRead().
+#define MOISTURE_NO_READING -1            //finishRead() when the sensor did not answer with 2 bytes.
+#define MOISTURE_GROUP_MAX 8
+
 class MoistureSensor {
 
   Adafruit_seesaw ss;
+  byte address;
   
   public:
-    void start(byte address)
-    {
-      ss.begin(address);
-    }
-  public:
+    void start(byte address);
     //Declaring function below with all its variables.
-    int moistureRead()
-    {
-      return ss.touchRead(0);
-    }
+    int moistureRead();
+
+    //Start a conversion, the result can be read MOISTURE_CONVERSION_TIME later.
+    void startRead();
+    //Result of the conversion started by startRead().
+    int finishRead();
 };
 
+class MoistureSensorGroup {
 
+  MoistureSensor sensors[MOISTURE_GROUP_MAX];
+  int values[MOISTURE_GROUP_MAX];
+  uint8_t count;
+  unsigned long startedAt;          //micros() when the last conversion was started.
+  uint8_t converting;               //Sensors converting, one bit each.
+
+  public:
+    MoistureSensorGroup();
+
+    //Start the sensor on I2C 'address'. Returns false if the group is full.
+    bool add(byte address);
+    uint8_t size();
+
+    //Start a conversion on every sensor.
+    void startRead();
+    //Start a conversion on the sensors in 'which', bit 0 is the first sensor added.
+    void startRead(uint8_t which);
+    //Collect every result started, waiting for what is left of the conversion time first.
+    void finishRead();
+    //Both, one conversion time for the whole group.
+    void read();
+
+    //Value from the last finishRead() that read sensor 'index', in the order they were added.
+    int value(uint8_t index);
+};
 
 #endif  /* MoistureSensor_H_ */
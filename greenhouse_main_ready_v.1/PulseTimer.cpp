@@ -0,0 +1,59 @@
+#include "PulseTimer.h"
+
+PulseTimer::PulseTimer() {
+  next = 0;
+  stored = 0;
+  total = 0;
+}
+
+void PulseTimer::edge() {
+  stamps[next] = micros();
+  next = next + 1 < PULSE_WINDOW ? next + 1 : 0;
+  if (stored < PULSE_WINDOW) {
+    stored++;
+  }
+  total++;
+}
+
+void PulseTimer::reset() {
+  noInterrupts();
+  next = 0;
+  stored = 0;
+  total = 0;
+  interrupts();
+}
+
+PulseSnapshot PulseTimer::snapshot() {
+  PulseSnapshot pulses;
+  noInterrupts();
+  uint8_t oldest = stored < PULSE_WINDOW ? 0 : next;
+  uint8_t newest = next > 0 ? next - 1 : PULSE_WINDOW - 1;
+  pulses.count = total;
+  pulses.first = stamps[oldest];
+  pulses.last = stamps[newest];
+  pulses.intervals = stored > 1 ? stored - 1 : 0;
+  interrupts();
+  return pulses;
+}
+
+float PulseTimer::perSecond(const PulseSnapshot &pulses, unsigned long now) {
+  unsigned long sinceLast = now - pulses.last;
+  if (pulses.intervals == 0 || sinceLast >= PULSE_TIMEOUT) {
+    return 0;
+  }
+  unsigned long span = pulses.last - pulses.first;
+  if (span == 0) {
+    return 0;
+  }
+
+  //The next pulse is later than the mean interval: the rate is at most one pulse in the time waited so far.
+  if (sinceLast * pulses.intervals > span) {
+    return 1000000.0 / sinceLast;
+  }
+  return pulses.intervals * 1000000.0 / span;
+}
+
+float PulseTimer::perSecond() {
+  PulseSnapshot pulses = snapshot();
+  return perSecond(pulses, micros());
+}
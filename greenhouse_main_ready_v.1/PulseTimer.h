@@ -0,0 +1,51 @@
+#ifndef PulseTimer_H_
+#define PulseTimer_H_
+#include "Arduino.h"
+/*------------------------------------------------------//
+  Pulse rate of a flow meter or fan tachometer from the time between pulses.
+
+  edge() is called from the pin interrupt and stamps the pulse with
+  micros(). The rate is the number of intervals between the last
+  PULSE_WINDOW pulses divided by the time they span, so it is known two
+  pulses after a start and follows a change within a few pulses. Slow
+  pulse trains are measured as exactly as fast ones, and the rate does not
+  depend on how often it is read or on which clock the sketch runs.
+
+  A pulse that is late lowers the rate to what the time since the last pulse
+  allows, and with no pulse for PULSE_TIMEOUT the rate is 0.
+*/
+
+#define PULSE_WINDOW 8                  //Pulses kept, the rate is averaged over one less intervals.
+#define PULSE_TIMEOUT 2000000UL         //Microseconds without a pulse before the rate is 0.
+
+//Pulses as they were at one moment, taken with interrupts held off.
+struct PulseSnapshot {
+  unsigned long count;                  //Pulses since begin or reset().
+  unsigned long first;                  //micros() of the oldest pulse in the window.
+  unsigned long last;                   //micros() of the newest pulse.
+  uint8_t intervals;                    //Intervals between 'first' and 'last', 0 if fewer than two pulses.
+};
+
+class PulseTimer {
+
+  volatile unsigned long stamps[PULSE_WINDOW];  //micros() of the last pulses, a ring.
+  volatile uint8_t next;                //Slot the next pulse goes in.
+  volatile uint8_t stored;              //Pulses in the ring, up to PULSE_WINDOW.
+  volatile unsigned long total;
+
+  public:
+    PulseTimer();
+
+    //Call from the pin interrupt at every pulse.
+    void edge();
+    //Forget the pulses so far, e.g. when the pump starts.
+    void reset();
+
+    PulseSnapshot snapshot();
+    //Pulses per second from 'pulses' at micros() 'now'.
+    static float perSecond(const PulseSnapshot &pulses, unsigned long now);
+    //Pulses per second now.
+    float perSecond();
+};
+
+#endif  /* PulseTimer_H_ */
@@ -0,0 +1,121 @@
+#include "RtcClock.h"
+
+#define RTC_RATE_PER_PPM 68719L     //One ppm in RTC counts per tick, 1/2^24: 4096 * 2^24 / 10^6.
+#define RTC_PERBUSY 0x04            //STATUS bit, PER register is being synchronized.
+
+RtcClock::RtcClock() {
+  seconds = 0;
+  ticks = 0;
+  tickMicros = 0;
+  rate = 0;
+  slew = 0;
+  slewTicks = 0;
+  carry = 0;
+}
+
+void RtcClock::begin() {
+  noInterrupts();
+  tickMicros = micros();
+  interrupts();
+}
+
+/*
+  =========================
+  || Overflow interrupt. ||
+  ========================= */
+bool RtcClock::tick() {
+  tickMicros = micros();
+
+  //Length of the period that just started: nominal plus corrections, whole counts now and the fraction later.
+  carry += rate;
+  if (slewTicks > 0) {
+    carry += slew;
+    slewTicks--;
+  }
+  long whole = carry >> 24;
+  if ((RTC.STATUS & RTC_PERBUSY) == 0) {
+    unsigned int period = RTC_TICK_COUNTS - 1 + whole;
+    RTC.PERL = period & 0xFF;
+    RTC.PERH = period >> 8;
+    carry -= whole << 24;
+  }
+
+  ticks++;
+  if (ticks < RTC_TICKS_PER_SECOND) {
+    return false;
+  }
+  ticks = 0;
+  seconds++;
+  return true;
+}
+
+/*
+  ===================
+  || Reading time. ||
+  =================== */
+uint64_t RtcClock::now() {
+  noInterrupts();
+  unsigned long s = seconds;
+  uint8_t t = ticks;
+  unsigned long sinceTick = micros() - tickMicros;
+  interrupts();
+
+  if (sinceTick >= RTC_TICK_MICROS) {
+    sinceTick = RTC_TICK_MICROS - 1;  //Corrected ticks may be a little longer than nominal.
+  }
+  uint64_t fraction = ((uint64_t)t << 29) + ((uint64_t)sinceTick << 32) / 1000000UL;
+  return ((uint64_t)(s + NTP_UNIX_EPOCH) << 32) + fraction;
+}
+
+//Read twice so that a tick between the bytes of 'seconds' can not give a torn value. Safe with interrupts off.
+unsigned long RtcClock::unixTime() {
+  unsigned long s;
+  do {
+    s = seconds;
+  } while (s != seconds);
+  return s;
+}
+
+/*
+  =================
+  || Correction. ||
+  ================= */
+void RtcClock::stepTicks(int64_t count) {
+  noInterrupts();
+  int64_t total = (int64_t)seconds * RTC_TICKS_PER_SECOND + ticks + count;
+  seconds = total / RTC_TICKS_PER_SECOND;
+  ticks = total % RTC_TICKS_PER_SECOND;
+  interrupts();
+}
+
+//A positive offset means the clock is behind: its ticks have been too long, so they are made shorter.
+bool RtcClock::discipline(int64_t offset, unsigned long interval) {
+  long newRate = rate;
+  //An offset of 2^56 or more (about 200 days) is a step, e.g. the first sync, not drift. Below it * 128 can not overflow.
+  if (interval > 0 && offset < (1LL << 56) && offset > -(1LL << 56)) {
+    int64_t counts = offset * 128;                         //32.32 seconds to RTC counts in 1/2^24: * 32768 * 2^24 / 2^32.
+    //Half of the drift seen over the interval, so that one noisy offset does not throw the estimate.
+    newRate -= counts / ((int64_t)interval * RTC_TICKS_PER_SECOND * 2);
+    newRate = constrain(newRate, -RTC_MAX_DRIFT * RTC_RATE_PER_PPM, RTC_MAX_DRIFT * RTC_RATE_PER_PPM);
+  }
+
+  //Whole ticks are stepped, a tick is 2^29 in 32.32 seconds. Only the rest is slewed.
+  bool stepped = offset >= (1LL << 29) || offset <= -(1LL << 29);
+  if (stepped) {
+    int64_t tickOffset = (offset + (1LL << 28)) >> 29;
+    offset -= tickOffset << 29;
+    stepTicks(tickOffset);
+  }
+  long newSlew = -(offset * 128) / RTC_SLEW_TICKS;          //Less than a tick is left, in RTC counts.
+
+  noInterrupts();
+  rate = newRate;
+  slew = newSlew;
+  slewTicks = RTC_SLEW_TICKS;
+  interrupts();
+  return stepped;
+}
+
+long RtcClock::drift() {
+  return rate / RTC_RATE_PER_PPM;
+}
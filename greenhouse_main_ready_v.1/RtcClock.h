@@ -0,0 +1,60 @@
+#ifndef RtcClock_H_
+#define RtcClock_H_
+#include "Arduino.h"
+/*------------------------------------------------------//
+  Disciplined UTC clock on the RTC overflow interrupt.
+
+  The RTC overflows 8 times per second (4096 counts of 32.768 kHz) and tick()
+  is called from the overflow interrupt to count UTC seconds. The oscillator
+  is not exact, so the length of every period is corrected by a frequency part
+  that cancels the drift estimated from NTP offsets, and a phase part that
+  slews the last measured offset away over RTC_SLEW_TICKS. Fractions of an
+  RTC count are carried from period to period. Offsets larger than a tick are
+  stepped in whole ticks and the rest is slewed.
+
+  Timestamps and offsets are NTP 32.32 fixed point: seconds since 1900 in the
+  upper 32 bits and the fraction of a second in the lower 32 bits.
+*/
+
+#define RTC_TICKS_PER_SECOND 8
+#define RTC_TICK_COUNTS 4096        //RTC counts per tick, 32768 / 8.
+#define RTC_TICK_MICROS 125000UL
+#define RTC_SLEW_TICKS 256          //Ticks (32 s) over which a measured offset is slewed away.
+#define RTC_MAX_DRIFT 10000         //ppm, largest frequency correction.
+#define NTP_UNIX_EPOCH 2208988800UL //Seconds from 1900-01-01 (NTP) to 1970-01-01 (Unix time).
+
+class RtcClock {
+
+  volatile unsigned long seconds;   //Unix time.
+  volatile uint8_t ticks;           //Ticks into the current second.
+  volatile unsigned long tickMicros;  //micros() at the last tick, to read time between ticks.
+  volatile long rate;               //Frequency correction, RTC counts per tick in 1/2^24.
+  volatile long slew;               //Phase correction, RTC counts per tick in 1/2^24 ...
+  volatile uint16_t slewTicks;      //... for this many more ticks.
+  long carry;                       //Fraction of a count not yet applied, 1/2^24.
+
+  void stepTicks(int64_t count);
+
+  public:
+    RtcClock();
+
+    //Call right after the RTC has been started, time between ticks is counted from here.
+    void begin();
+    //Call from the RTC overflow interrupt. Returns true when a new second starts.
+    bool tick();
+
+    //Current time as NTP timestamp.
+    uint64_t now();
+    //Current time as Unix time, whole seconds.
+    unsigned long unixTime();
+
+    //Correct a measured 'offset' (signed 32.32 seconds, positive when the
+    //clock is behind) that built up over 'interval' seconds since the last
+    //correction. Use 'interval' 0 for the first one, the drift estimate is
+    //only updated when it is known. Returns true if the clock was stepped.
+    bool discipline(int64_t offset, unsigned long interval);
+    //Current drift correction in ppm, positive when the RTC runs fast.
+    long drift();
+};
+
+#endif  /* RtcClock_H_ */
@@ -214,7 +214,79 @@ uint16_t SI114X::ReadUV(void)
 {
   return (ReadHalfWord(SI114X_AUX_DATA0_UVINDEX0)); 	
 }
- 
- 
- 
- 
+/*--------------------------------------------------------//
+Set how often the sensor measures in auto mode, in steps
+of 31.25us (32000 = 1s). 0 stops auto measuring
+
+ */
+void SI114X::SetMeasRate(uint16_t Rate)
+{
+  WriteByte(SI114X_MEAS_RATE0, Rate & 0xFF);
+  WriteByte(SI114X_MEAS_RATE1, Rate >> 8);
+}
+/*--------------------------------------------------------//
+Measure visible, IR and UV once. With the INT pin enabled
+(the default) the sensor signals the results like an auto
+measurement. For use with a MEAS_RATE of 0
+
+ */
+void SI114X::ForceALS(void)
+{
+  WriteByte(SI114X_COMMAND, SI114X_ALS_FORCE);
+}
+/*--------------------------------------------------------//
+Set gain and recovery counter of the visible and IR ADCs
+Gain: SI114X_ADC_GAIN_DIVx, integration time is 2^Gain
+Counter: SI114X_ADC_COUNTER_xADCCLK, the datasheet asks for
+the one complementing the gain (511 clocks for gain 0)
+
+ */
+void SI114X::SetALSADC(uint8_t Gain, uint8_t Counter)
+{
+  //the recovery counter sits in bits 6:4 of the parameter
+  WriteParamData(SI114X_ALS_VIS_ADC_GAIN, Gain);
+  WriteParamData(SI114X_ALS_VIS_ADC_COUNTER, Counter << 4);
+  WriteParamData(SI114X_ALS_IR_ADC_GAIN, Gain);
+  WriteParamData(SI114X_ALS_IR_ADC_COUNTER, Counter << 4);
+}
+/*--------------------------------------------------------//
+Read all results of the last measurement cycle in one
+transaction, starting at IRQ_STATUS, then clear the
+interrupts that were pending. This releases the INT pin.
+Returns false, with Sample unchanged, if the sensor did not
+answer with all 13 bytes. The INT pin then stays low
+
+ */
+bool SI114X::ReadSample(SI114XSample &Sample)
+{
+  uint16_t Value[6];
+  uint8_t Status;
+  Wire.beginTransmission(SI114X_ADDR);
+  Wire.write(SI114X_IRQ_STATUS);
+  Wire.endTransmission();
+  if (Wire.requestFrom(SI114X_ADDR, 1 + sizeof(Value)) != 1 + sizeof(Value))
+  {
+    while (Wire.available() > 0)
+    {
+      Wire.read();
+    }
+    return false;
+  }
+  Status = Wire.read();
+  for (uint8_t i = 0; i < 6; i++)
+  {
+    Value[i] = Wire.read();
+    Value[i] |= (uint16_t)Wire.read() << 8;
+  }
+  Sample.Visible = Value[0];
+  Sample.IR = Value[1];
+  Sample.Proximity[0] = Value[2];
+  Sample.Proximity[1] = Value[3];
+  Sample.Proximity[2] = Value[4];
+  Sample.UV = Value[5];
+  if (Status != 0)
+  {
+    WriteByte(SI114X_IRQ_STATUS, Status);
+  }
+  return true;
+}
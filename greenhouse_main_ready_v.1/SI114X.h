@@ -161,6 +161,15 @@ Registers,Parameters and commands
 
 #define SI114X_ADDR 0X60
 
+//
+//One measurement cycle, registers ALS_VIS_DATA0..AUX_DATA1_UVINDEX1
+//
+struct SI114XSample {
+  uint16_t Visible;
+  uint16_t IR;
+  uint16_t Proximity[3];
+  uint16_t UV;          //UV index times 100
+};
 
 class SI114X {
  public:
@@ -173,6 +182,10 @@ class SI114X {
   uint16_t ReadIR(void);
   uint16_t ReadProximity(uint8_t PSn);
   uint16_t ReadUV(void);
+  void SetMeasRate(uint16_t Rate);
+  void ForceALS(void);
+  void SetALSADC(uint8_t Gain, uint8_t Counter);
+  bool ReadSample(SI114XSample &Sample);
  private:
   void  WriteByte(uint8_t Reg, uint8_t Value);
   uint8_t  ReadByte(uint8_t Reg);
@@ -0,0 +1,154 @@
+#include "Scheduler.h"
+#include <avr/sleep.h>
+
+Scheduler::Scheduler() {
+  count = 0;
+  woken = false;
+}
+
+/*
+  ===================
+  || Heap helpers. ||
+  =================== */
+//Deadlines are compared as a signed difference so that millis() may wrap.
+bool Scheduler::before(uint8_t a, uint8_t b) {
+  return (long)(heap[a].due - heap[b].due) < 0;
+}
+
+void Scheduler::swap(uint8_t a, uint8_t b) {
+  Task tmp = heap[a];
+  heap[a] = heap[b];
+  heap[b] = tmp;
+}
+
+void Scheduler::siftUp(uint8_t i) {
+  while (i > 0) {
+    uint8_t parent = (i - 1) / 2;
+    if (!before(i, parent)) {
+      break;
+    }
+    swap(i, parent);
+    i = parent;
+  }
+}
+
+void Scheduler::siftDown(uint8_t i) {
+  for (;;) {
+    uint8_t first = i;
+    uint8_t left = 2 * i + 1;
+    uint8_t right = left + 1;
+    if (left < count && before(left, first)) {
+      first = left;
+    }
+    if (right < count && before(right, first)) {
+      first = right;
+    }
+    if (first == i) {
+      break;
+    }
+    swap(i, first);
+    i = first;
+  }
+}
+
+int8_t Scheduler::find(TaskFunction function) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (heap[i].function == function) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void Scheduler::removeAt(uint8_t i) {
+  count--;
+  if (i == count) {
+    return;
+  }
+  heap[i] = heap[count];
+  siftDown(i);
+  siftUp(i);
+}
+
+bool Scheduler::add(TaskFunction function, unsigned long wait, unsigned long period) {
+  int8_t i = find(function);
+  if (i >= 0) {
+    removeAt(i);
+  }
+  if (count == SCHEDULER_MAX_TASKS) {
+    return false;
+  }
+  heap[count].function = function;
+  heap[count].due = millis() + wait;
+  heap[count].period = period;
+  count++;
+  siftUp(count - 1);
+  return true;
+}
+
+/*
+  =================
+  || Scheduling. ||
+  ================= */
+bool Scheduler::every(unsigned long period, TaskFunction function) {
+  return add(function, period, period);
+}
+
+bool Scheduler::after(unsigned long wait, TaskFunction function) {
+  return add(function, wait, 0);
+}
+
+void Scheduler::cancel(TaskFunction function) {
+  int8_t i = find(function);
+  if (i >= 0) {
+    removeAt(i);
+  }
+}
+
+bool Scheduler::scheduled(TaskFunction function) {
+  return find(function) >= 0;
+}
+
+/*
+  ====================
+  || Run due tasks. ||
+  ==================== */
+void Scheduler::run() {
+  unsigned long now = millis();
+  while (count > 0 && (long)(now - heap[0].due) >= 0) {
+    TaskFunction function = heap[0].function;
+    if (heap[0].period > 0) {
+      heap[0].due += heap[0].period;
+      if ((long)(now - heap[0].due) >= 0) {
+        heap[0].due = now + heap[0].period;     //Fell behind, skip the missed runs.
+      }
+      siftDown(0);
+    }
+    else {
+      removeAt(0);
+    }
+    function();
+  }
+}
+
+unsigned long Scheduler::untilNext() {
+  if (count == 0) {
+    return (unsigned long)-1;
+  }
+  long wait = (long)(heap[0].due - millis());
+  return wait > 0 ? wait : 0;
+}
+
+void Scheduler::sleep() {
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  while (count > 0 && untilNext() > 0 && woken == false) {
+    sleep_cpu();
+  }
+  sleep_disable();
+  woken = false;                    //A wake() after this is for work loop() does before it sleeps again.
+}
+
+void Scheduler::wake() {
+  woken = true;
+}
@@ -0,0 +1,61 @@
+#ifndef Scheduler_H_
+#define Scheduler_H_
+#include "Arduino.h"
+/*------------------------------------------------------//
+  Cooperative task scheduler.
+
+  Fixed number of tasks kept in a min-heap ordered by deadline (millis()).
+  A task is a plain function and is identified by it, so each function is
+  scheduled at most once: scheduling it again only moves its deadline.
+  Periodic tasks keep their phase, a task that falls behind skips the runs it
+  missed instead of running several times in a row.
+*/
+
+#define SCHEDULER_MAX_TASKS 16
+
+typedef void (*TaskFunction)(void);
+
+class Scheduler {
+
+  struct Task {
+    TaskFunction function;
+    unsigned long due;              //millis() value when the task is run next.
+    unsigned long period;           //0 for a one-shot task.
+  };
+
+  Task heap[SCHEDULER_MAX_TASKS];   //heap[0] is the task due first.
+  uint8_t count;
+  volatile bool woken;              //Set by wake(), ends sleep().
+
+  bool before(uint8_t a, uint8_t b);
+  void swap(uint8_t a, uint8_t b);
+  void siftUp(uint8_t i);
+  void siftDown(uint8_t i);
+  int8_t find(TaskFunction function);
+  void removeAt(uint8_t i);
+  bool add(TaskFunction function, unsigned long wait, unsigned long period);
+
+  public:
+    Scheduler();
+
+    //Run 'function' every 'period' ms, the first time one period from now.
+    bool every(unsigned long period, TaskFunction function);
+    //Run 'function' once, 'wait' ms from now.
+    bool after(unsigned long wait, TaskFunction function);
+    void cancel(TaskFunction function);
+    bool scheduled(TaskFunction function);
+
+    //Run every task that is due. Tasks may schedule and cancel tasks.
+    void run();
+    //Milliseconds until the next task is due, 0 if one is due now.
+    unsigned long untilNext();
+    //Put the CPU in idle sleep until the next task is due or wake() is
+    //called. Interrupts still run, the millis() timer wakes the CPU every
+    //millisecond.
+    void sleep();
+    //Interrupt side: end sleep() at the next wake-up, because the interrupt
+    //left work for loop(). Also ends the next sleep() if none is running.
+    void wake();
+};
+
+#endif  /* Scheduler_H_ */
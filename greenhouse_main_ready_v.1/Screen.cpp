@@ -0,0 +1,99 @@
+#include "Screen.h"
+#include <string.h>
+
+ScreenRenderer::ScreenRenderer(SeeedGrayOLED &display) : display(display) {
+  shown = 0;
+  fieldWrites = 0;
+}
+
+//Digits of 'value' at the start of 'text', at most 'width'.
+static void formatNumber(char *text, uint8_t width, long value) {
+  char digits[11];
+  uint8_t length = 0;
+  unsigned long magnitude = value < 0 ? -(unsigned long)value : value;
+  do {
+    digits[length++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude > 0);
+  if (value < 0) {
+    digits[length++] = '-';
+  }
+  for (uint8_t i = 0; i < length && i < width; i++) {
+    text[i] = digits[length - 1 - i];
+  }
+}
+
+//'text' is 'field.width' blanks when called.
+void ScreenRenderer::format(const ScreenField &field, char *text) {
+  switch (field.format) {
+    case SCREEN_INT:
+      formatNumber(text, field.width, *(const int *)field.value);
+      break;
+    case SCREEN_UNSIGNED:
+      formatNumber(text, field.width, *(const unsigned short *)field.value);
+      break;
+    case SCREEN_FLOAT: {
+      float value = *(const float *)field.value;
+      if (isnan(value)) {
+        memcpy(text, "--", field.width < 2 ? field.width : 2);
+      }
+      else {
+        formatNumber(text, field.width, (long)value);
+      }
+      break;
+    }
+    case SCREEN_BOOL:
+      text[0] = *(const bool *)field.value ? '1' : '0';
+      break;
+    case SCREEN_TEXT: {
+      const char *value = field.text();
+      uint8_t length = strlen(value);
+      memcpy(text, value, length < field.width ? length : field.width);
+      break;
+    }
+  }
+}
+
+bool ScreenRenderer::draw(const ScreenLayout &layout) {
+  bool entered = shown != &layout;
+  if (entered == true) {
+    display.clearDisplay();
+    for (uint8_t i = 0; i < layout.labelCount; i++) {
+      display.setTextXY(layout.labels[i].row, layout.labels[i].column * 8);
+      display.putString(layout.labels[i].text);
+    }
+    shown = &layout;
+  }
+
+  char text[SCREEN_COLUMNS + 1];
+  uint8_t kept = 0;                                     //Characters of 'drawn' used by the fields before this one.
+  for (uint8_t i = 0; i < layout.fieldCount; i++) {
+    const ScreenField &field = layout.fields[i];
+    uint8_t width = field.width < SCREEN_COLUMNS ? field.width : SCREEN_COLUMNS;
+    memset(text, ' ', width);
+    text[width] = 0;
+    format(field, text);
+
+    bool fits = kept + width <= SCREEN_TEXT_POOL;
+    if (entered == false && fits == true && memcmp(drawn + kept, text, width) == 0) {
+      kept += width;
+      continue;
+    }
+    if (fits == true) {
+      memcpy(drawn + kept, text, width);
+      kept += width;
+    }
+    display.setTextXY(field.row, field.column * 8);
+    display.putString(text);
+    fieldWrites++;
+  }
+  return entered;
+}
+
+void ScreenRenderer::invalidate() {
+  shown = 0;
+}
+
+uint16_t ScreenRenderer::writes() {
+  return fieldWrites;
+}
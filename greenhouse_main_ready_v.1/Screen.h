@@ -0,0 +1,75 @@
+#ifndef Screen_H_
+#define Screen_H_
+#include "Arduino.h"
+#include "SeeedGrayOLED.h"
+/*------------------------------------------------------//
+  Declarative screen layouts for the OLED display.
+
+  A screen is a table of static labels and a table of fields. Rows and
+  columns count characters: 16 rows of 16 characters. A field has a fixed
+  width and is bound to a variable, shown in one of the number formats, or
+  to a function that returns its text.
+
+  ScreenRenderer::draw() clears the display and draws the labels when the
+  screen is not the one shown, and otherwise only redraws the fields whose
+  text changed since they were last drawn. Every field is padded with blanks
+  to its width, so a shorter text clears what was left of a longer one.
+  Text that does not fit is cut at the width.
+*/
+
+#define SCREEN_COLUMNS 16
+#define SCREEN_TEXT_POOL 96         //Characters kept of the fields last drawn, summed over a screen. Fields past it are drawn every time.
+
+enum ScreenFormat {
+  SCREEN_INT,                       //int
+  SCREEN_UNSIGNED,                  //unsigned short / uint16_t
+  SCREEN_FLOAT,                     //float, whole units, "--" when not a number.
+  SCREEN_BOOL,                      //bool, 0 or 1.
+  SCREEN_TEXT                       //Text returned by 'text'.
+};
+
+typedef const char *(*ScreenText)();
+
+struct ScreenLabel {
+  uint8_t row;
+  uint8_t column;
+  const char *text;
+};
+
+struct ScreenField {
+  uint8_t row;
+  uint8_t column;
+  uint8_t width;
+  uint8_t format;                   //ScreenFormat.
+  const void *value;                //Variable shown, unless SCREEN_TEXT.
+  ScreenText text;                  //SCREEN_TEXT only.
+};
+
+struct ScreenLayout {
+  const ScreenLabel *labels;
+  uint8_t labelCount;
+  const ScreenField *fields;
+  uint8_t fieldCount;
+};
+
+class ScreenRenderer {
+
+  SeeedGrayOLED &display;
+  const ScreenLayout *shown;        //Screen on the display, 0 if something else was drawn.
+  char drawn[SCREEN_TEXT_POOL];     //Text of each field when last drawn, fields one after the other.
+  uint16_t fieldWrites;
+
+  void format(const ScreenField &field, char *text);
+
+  public:
+    ScreenRenderer(SeeedGrayOLED &display);
+
+    //Bring 'layout' up to date on the display. Returns true if the display was cleared for it.
+    bool draw(const ScreenLayout &layout);
+    //Something else drew on the display: the next draw() starts from a cleared display.
+    void invalidate();
+    //Fields redrawn because their text changed, for tuning.
+    uint16_t writes();
+};
+
+#endif  /* Screen_H_ */
@@ -30,11 +30,24 @@
 
 #include <avr/pgmspace.h>
 
+#include <stdlib.h>
+#include <string.h>
+
 #if defined(__arm__) && !defined(PROGMEM)
   #define PROGMEM
   #define pgm_read_byte(STR) STR
 #endif
 
+// Size of the Wire transmit buffer; bytes beyond it are silently dropped.
+#ifndef BUFFER_LENGTH
+  #define BUFFER_LENGTH 32
+#endif
+
+// SSD1327 characters from RotatedFont: 768 bytes more flash, no bit shuffling per character.
+#ifndef SSD1327_ROTATED_FONT
+  #define SSD1327_ROTATED_FONT 0
+#endif
+
 // 8x8 Font ASCII 32 - 127 Implemented
 // Users can modify this to support more characters(glyphs)
 // BasicFont is placed in code memory.
@@ -140,6 +153,136 @@ const unsigned char BasicFont[][8] PROGMEM=
   {0x00,0x02,0x05,0x05,0x02,0x00,0x00,0x00} 
 };
 
+#if SSD1327_ROTATED_FONT
+// BasicFont turned for SSD1327 vertical mode: 2 bits per display byte,
+// four display bytes per font byte, most significant bits first.
+const unsigned char RotatedFont[][8] PROGMEM=
+{
+  {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+  {0x00,0x00,0xAA,0x88,0x00,0x00,0x00,0x00},
+  {0x00,0x00,0xA8,0x00,0xA8,0x00,0x00,0x00},
+  {0x04,0x40,0xAE,0xE8,0xAE,0xE8,0x00,0x00},
+  {0x04,0x10,0x77,0x74,0x32,0x60,0x00,0x00},
+  {0x50,0x10,0xA1,0x80,0x18,0x3C,0x00,0x00},
+  {0x14,0x50,0xC6,0x4C,0x20,0x64,0x00,0x00},
+  {0x00,0x00,0xD8,0x00,0x00,0x00,0x00,0x00},
+  {0x05,0x40,0x60,0x24,0x00,0x00,0x00,0x00},
+  {0x40,0x04,0x25,0x60,0x00,0x00,0x00,0x00},
+  {0x01,0x00,0x27,0x60,0x23,0x20,0x00,0x00},
+  {0x01,0x00,0x17,0x50,0x03,0x00,0x00,0x00},
+  {0x00,0x11,0x00,0x28,0x00,0x00,0x00,0x00},
+  {0x01,0x00,0x03,0x00,0x03,0x00,0x00,0x00},
+  {0x00,0x14,0x00,0x28,0x00,0x00,0x00,0x00},
+  {0x00,0x10,0x01,0x80,0x18,0x00,0x00,0x00},
+  {0x15,0x50,0xC1,0x8C,0x9D,0x58,0x00,0x00},
+  {0x00,0x00,0x75,0x5C,0x00,0x08,0x00,0x00},
+  {0x10,0x14,0xC1,0x8C,0x96,0x0C,0x00,0x00},
+  {0x10,0x10,0xC1,0x0C,0x96,0x58,0x00,0x00},
+  {0x01,0x40,0x18,0xC0,0xAA,0xE8,0x00,0x00},
+  {0x54,0x10,0xCC,0x0C,0xC9,0x58,0x00,0x00},
+  {0x05,0x50,0x63,0x0C,0x82,0x58,0x00,0x00},
+  {0x40,0x00,0xC1,0xA8,0xD8,0x00,0x00,0x00},
+  {0x14,0x50,0xC3,0x0C,0x96,0x58,0x00,0x00},
+  {0x14,0x00,0xC3,0x0C,0x97,0x60,0x00,0x00},
+  {0x00,0x00,0x3C,0xF0,0x00,0x00,0x00,0x00},
+  {0x00,0x00,0x0F,0x36,0x00,0x00,0x00,0x00},
+  {0x01,0x00,0x18,0x90,0x80,0x08,0x00,0x00},
+  {0x04,0x40,0x0C,0xC0,0x0C,0xC0,0x00,0x00},
+  {0x40,0x04,0x24,0x60,0x02,0x00,0x00,0x00},
+  {0x10,0x00,0xC0,0x44,0x96,0x00,0x00,0x00},
+  {0x10,0x50,0xC3,0x5C,0x95,0x58,0x00,0x00},
+  {0x15,0x54,0xC3,0x00,0x97,0x54,0x00,0x00},
+  {0x55,0x54,0xC3,0x0C,0x96,0x58,0x00,0x00},
+  {0x15,0x50,0xC0,0x0C,0x90,0x18,0x00,0x00},
+  {0x55,0x54,0xC0,0x0C,0x25,0x60,0x00,0x00},
+  {0x55,0x54,0xC3,0x0C,0xC2,0x0C,0x00,0x00},
+  {0x55,0x54,0xC3,0x00,0xC2,0x00,0x00,0x00},
+  {0x15,0x50,0xC0,0x0C,0x90,0xDC,0x00,0x00},
+  {0x55,0x54,0x03,0x00,0x57,0x54,0x00,0x00},
+  {0x40,0x04,0xEA,0xAC,0x00,0x00,0x00,0x00},
+  {0x00,0x10,0x40,0x0C,0xEA,0xA0,0x00,0x00},
+  {0x55,0x54,0x06,0x40,0x60,0x24,0x00,0x00},
+  {0x55,0x54,0x00,0x0C,0x00,0x0C,0x00,0x00},
+  {0x55,0x54,0x25,0x00,0x75,0x54,0x00,0x00},
+  {0x55,0x54,0x09,0x00,0x55,0xD4,0x00,0x00},
+  {0x15,0x50,0xC0,0x0C,0x95,0x58,0x00,0x00},
+  {0x55,0x54,0xC3,0x00,0x96,0x00,0x00,0x00},
+  {0x15,0x50,0xC0,0x4C,0x95,0x64,0x00,0x00},
+  {0x55,0x54,0xC3,0x40,0x96,0x24,0x00,0x00},
+  {0x14,0x10,0xC3,0x0C,0x92,0x58,0x00,0x00},
+  {0x40,0x00,0xD5,0x54,0xC0,0x00,0x00,0x00},
+  {0x55,0x50,0x00,0x0C,0x55,0x58,0x00,0x00},
+  {0x55,0x40,0x00,0x24,0x55,0x60,0x00,0x00},
+  {0x55,0x50,0x01,0x58,0x55,0x58,0x00,0x00},
+  {0x50,0x14,0x09,0x80,0x58,0x94,0x00,0x00},
+  {0x50,0x00,0x09,0x54,0x58,0x00,0x00,0x00},
+  {0x40,0x14,0xC1,0x8C,0xD8,0x0C,0x00,0x00},
+  {0x55,0x54,0xC0,0x0C,0x00,0x00,0x00,0x00},
+  {0x10,0x00,0x09,0x00,0x00,0x90,0x00,0x00},
+  {0x40,0x04,0xD5,0x5C,0x00,0x00,0x00,0x00},
+  {0x04,0x00,0x60,0x00,0x24,0x00,0x00,0x00},
+  {0x00,0x01,0x00,0x03,0x00,0x03,0x00,0x00},
+  {0x40,0x00,0x24,0x00,0x00,0x00,0x00,0x00},
+  {0x00,0x10,0x0C,0xCC,0x09,0xDC,0x00,0x00},
+  {0x55,0x54,0x06,0x0C,0x09,0x58,0x00,0x00},
+  {0x01,0x50,0x0C,0x0C,0x02,0x20,0x00,0x00},
+  {0x01,0x50,0x0C,0x0C,0x57,0x5C,0x00,0x00},
+  {0x01,0x50,0x0C,0xCC,0x09,0xC8,0x00,0x00},
+  {0x01,0x00,0x6B,0xA8,0x20,0x00,0x00,0x00},
+  {0x01,0x40,0x0C,0x33,0x0D,0x76,0x00,0x00},
+  {0x55,0x54,0x06,0x00,0x09,0x54,0x00,0x00},
+  {0x00,0x00,0x8A,0xA8,0x00,0x00,0x00,0x00},
+  {0x00,0x01,0x4D,0x56,0x00,0x00,0x00,0x00},
+  {0x55,0x54,0x01,0x90,0x08,0x08,0x00,0x00},
+  {0x40,0x04,0xAA,0xAC,0x00,0x00,0x00,0x00},
+  {0x05,0x54,0x09,0x40,0x09,0x54,0x00,0x00},
+  {0x05,0x54,0x06,0x00,0x0A,0xA8,0x00,0x00},
+  {0x01,0x50,0x0C,0x0C,0x02,0xA0,0x00,0x00},
+  {0x05,0x55,0x0C,0x30,0x02,0x80,0x00,0x00},
+  {0x01,0x40,0x0C,0x30,0x0A,0xAA,0x00,0x00},
+  {0x00,0x00,0x0B,0xA8,0x08,0x00,0x00,0x00},
+  {0x01,0x04,0x0C,0xCC,0x08,0x20,0x00,0x00},
+  {0x04,0x00,0xAE,0xAC,0x00,0x00,0x00,0x00},
+  {0x05,0x50,0x00,0x0C,0x0A,0xA8,0x00,0x00},
+  {0x05,0x40,0x00,0x24,0x05,0x60,0x00,0x00},
+  {0x05,0x50,0x00,0x58,0x05,0x58,0x00,0x00},
+  {0x04,0x04,0x02,0x60,0x06,0x24,0x00,0x00},
+  {0x05,0x40,0x00,0x33,0x0A,0xA8,0x00,0x00},
+  {0x04,0x04,0x0C,0x6C,0x0E,0x0C,0x00,0x00},
+  {0x01,0x00,0x68,0xA4,0x00,0x00,0x00,0x00},
+  {0x00,0x00,0xAA,0xA8,0x00,0x00,0x00,0x00},
+  {0x40,0x04,0x29,0xA0,0x00,0x00,0x00,0x00},
+  {0x10,0x00,0xC0,0x00,0x60,0x00,0x00,0x00},
+  {0x10,0x00,0xCC,0x00,0x20,0x00,0x00,0x00}
+};
+#endif
+
+// Byte with its bit order reversed, for bitmaps on the SH1107G.
+const unsigned char BitReverse[256] PROGMEM=
+{
+  0x00,0x80,0x40,0xC0,0x20,0xA0,0x60,0xE0,0x10,0x90,0x50,0xD0,0x30,0xB0,0x70,0xF0,
+  0x08,0x88,0x48,0xC8,0x28,0xA8,0x68,0xE8,0x18,0x98,0x58,0xD8,0x38,0xB8,0x78,0xF8,
+  0x04,0x84,0x44,0xC4,0x24,0xA4,0x64,0xE4,0x14,0x94,0x54,0xD4,0x34,0xB4,0x74,0xF4,
+  0x0C,0x8C,0x4C,0xCC,0x2C,0xAC,0x6C,0xEC,0x1C,0x9C,0x5C,0xDC,0x3C,0xBC,0x7C,0xFC,
+  0x02,0x82,0x42,0xC2,0x22,0xA2,0x62,0xE2,0x12,0x92,0x52,0xD2,0x32,0xB2,0x72,0xF2,
+  0x0A,0x8A,0x4A,0xCA,0x2A,0xAA,0x6A,0xEA,0x1A,0x9A,0x5A,0xDA,0x3A,0xBA,0x7A,0xFA,
+  0x06,0x86,0x46,0xC6,0x26,0xA6,0x66,0xE6,0x16,0x96,0x56,0xD6,0x36,0xB6,0x76,0xF6,
+  0x0E,0x8E,0x4E,0xCE,0x2E,0xAE,0x6E,0xEE,0x1E,0x9E,0x5E,0xDE,0x3E,0xBE,0x7E,0xFE,
+  0x01,0x81,0x41,0xC1,0x21,0xA1,0x61,0xE1,0x11,0x91,0x51,0xD1,0x31,0xB1,0x71,0xF1,
+  0x09,0x89,0x49,0xC9,0x29,0xA9,0x69,0xE9,0x19,0x99,0x59,0xD9,0x39,0xB9,0x79,0xF9,
+  0x05,0x85,0x45,0xC5,0x25,0xA5,0x65,0xE5,0x15,0x95,0x55,0xD5,0x35,0xB5,0x75,0xF5,
+  0x0D,0x8D,0x4D,0xCD,0x2D,0xAD,0x6D,0xED,0x1D,0x9D,0x5D,0xDD,0x3D,0xBD,0x7D,0xFD,
+  0x03,0x83,0x43,0xC3,0x23,0xA3,0x63,0xE3,0x13,0x93,0x53,0xD3,0x33,0xB3,0x73,0xF3,
+  0x0B,0x8B,0x4B,0xCB,0x2B,0xAB,0x6B,0xEB,0x1B,0x9B,0x5B,0xDB,0x3B,0xBB,0x7B,0xFB,
+  0x07,0x87,0x47,0xC7,0x27,0xA7,0x67,0xE7,0x17,0x97,0x57,0xD7,0x37,0xB7,0x77,0xF7,
+  0x0F,0x8F,0x4F,0xCF,0x2F,0xAF,0x6F,0xEF,0x1F,0x9F,0x5F,0xDF,0x3F,0xBF,0x7F,0xFF
+};
+
+SeeedGrayOLED::SeeedGrayOLED()
+{
+  frameBuffer = NULL;
+}
+
 void SeeedGrayOLED::init(int IC)
 {
   Drive_IC = IC;
@@ -190,8 +333,7 @@ void SeeedGrayOLED::init(int IC)
     sendCommand(0x37);    // End at  (8 + 47)th column. Each Column has 2 pixels(segments)
 
     // Init gray level for text. Default:Brightest White
-    grayH= 0xF0;
-    grayL= 0x0F;
+    setGrayLevel(0x0F);
   }
   else if(Drive_IC == SH1107G)
   {
@@ -283,6 +425,11 @@ void SeeedGrayOLED::setTextXY(unsigned char Row, unsigned char Column)
     sendCommand(0x00+(Row*8));     /* Start Row*/
     sendCommand(0x07+(Row*8));     /* End Row*/
   }
+  else if(frameBuffer)
+  {
+    bufferPage = Row & 0x0F;         // same wrapping as the page/column commands below
+    bufferColumn = Column & 0x7F;
+  }
   else if(Drive_IC == SH1107G)
   {
     sendCommand(0xb0 + (Row&0x0F));  // set page/row
@@ -293,47 +440,71 @@ void SeeedGrayOLED::setTextXY(unsigned char Row, unsigned char Column)
 
 void SeeedGrayOLED::clearDisplay()
 {
-    unsigned char i,j;
+    unsigned char i;
+    unsigned char blank[SH1107G_Columns];
+
+    memset(blank, 0x00, sizeof(blank));
 
   if(Drive_IC == SSD1327)
   {
-    for(j=0;j<48;j++)
+    for(i=0;i<48;i++)  //clear all columns, one row of 96 bytes at a time
     {
-        for(i=0;i<96;i++)  //clear all columns
-        {
-            sendData(0x00);
-        }
+        sendDataBurst(blank, 96);
     }
   }
   else if(Drive_IC == SH1107G)
   {
-    for(i=0; i<16;i++){
-      sendCommand(0xb0+i);
-      sendCommand(0x0);
-      sendCommand(0x10);
-      for(j=0; j<128;j++){ 
-        sendData(0x00);  
-      }
+    for(i=0; i<SH1107G_Pages; i++)
+    {
+      setTextXY(i, 0);
+      sendDataBurst(blank, SH1107G_Columns);
     }
   }
 }
 
 void SeeedGrayOLED::sendData(unsigned char Data)
 {
+    if(frameBuffer)
+    {
+        bufferData(Data);
+        return;
+    }
     Wire.beginTransmission(SeeedGrayOLED_Address); // begin I2C transmission
     Wire.write(SeeedGrayOLED_Data_Mode);            // data mode
     Wire.write(Data);
     Wire.endTransmission();                    // stop I2C transmission
 }
 
+void SeeedGrayOLED::sendDataBurst(const unsigned char *Data, size_t Length)
+{
+    if(frameBuffer)
+    {
+        while(Length--)
+        {
+            bufferData(*Data++);
+        }
+        return;
+    }
+    writeData(Data, Length);
+}
+
 void SeeedGrayOLED::setGrayLevel(unsigned char grayLevel)
 {
-    grayH = (grayLevel << 4) & 0xF0;
-    grayL =  grayLevel & 0x0F;
+    unsigned char grayH = (grayLevel << 4) & 0xF0;
+    unsigned char grayL =  grayLevel & 0x0F;
+
+    // Display byte for each pair of pixels: left pixel in the high bit, right in the low bit.
+    grayPair[0] = 0x00;
+    grayPair[1] = grayL;
+    grayPair[2] = grayH;
+    grayPair[3] = grayH | grayL;
 }
 
-void SeeedGrayOLED::putChar(unsigned char C)
+// Display RAM bytes for one character: 32 gray bytes on SSD1327, 8 on SH1107G.
+unsigned char SeeedGrayOLED::glyph(unsigned char C, unsigned char *Bytes)
 {
+    unsigned char n = 0;
+
     if(C < 32 || C > 127) //Ignore non-printable ASCII characters. This can be modified for multilingual font.
     {
         C=' '; //Space
@@ -341,59 +512,90 @@ void SeeedGrayOLED::putChar(unsigned char C)
 
   if(Drive_IC == SSD1327)
   {
-    for(char i=0;i<8;i=i+2)
+#if SSD1327_ROTATED_FONT
+    for(unsigned char i=0;i<8;i++)
     {
-        for(char j=0;j<8;j++)
+        unsigned char bits = pgm_read_byte(&RotatedFont[C-32][i]);
+        for(unsigned char j=0;j<4;j++)
         {
-            // Character is constructed two pixel at a time using vertical mode from the default 8x8 font
-            char c=0x00;
-            char bit1=(pgm_read_byte(&BasicFont[C-32][i]) >> j)  & 0x01;  
-            char bit2=(pgm_read_byte(&BasicFont[C-32][i+1]) >> j) & 0x01;
-           // Each bit is changed to a nibble
-            c|=(bit1)?grayH:0x00;
-            c|=(bit2)?grayL:0x00;
-
-            sendData(c);
+            Bytes[n++] = grayPair[bits >> 6];
+            bits <<= 2;
         }
     }
+#else
+    for(unsigned char i=0;i<8;i=i+2)
+    {
+        // Character is constructed two pixel at a time using vertical mode from the default 8x8 font
+        unsigned char left = pgm_read_byte(&BasicFont[C-32][i]);
+        unsigned char right = pgm_read_byte(&BasicFont[C-32][i+1]);
+        for(unsigned char j=0;j<8;j++)
+        {
+            Bytes[n++] = grayPair[(left & 0x01) << 1 | (right & 0x01)];
+            left >>= 1;
+            right >>= 1;
+        }
+    }
+#endif
   }
   else if(Drive_IC == SH1107G)
   {
     for(int i=0;i<8;i++)
     {
        //read bytes from code memory
-       sendData(pgm_read_byte(&BasicFont[C-32][i])); //font array starts at 0, ASCII starts at 32. Hence the translation
+       Bytes[n++] = pgm_read_byte(&BasicFont[C-32][i]); //font array starts at 0, ASCII starts at 32. Hence the translation
     }
   }
+  return n;
+}
+
+void SeeedGrayOLED::putChar(unsigned char C)
+{
+    unsigned char bytes[32];
+
+    sendDataBurst(bytes, glyph(C, bytes));
 }
 
 void SeeedGrayOLED::putString(const char *String)
 {
-    unsigned char i=0;
-    while(String[i])
+    // Glyphs are packed back to back so a whole row goes out in a few full bursts.
+    unsigned char bytes[32];
+    unsigned char burst[BUFFER_LENGTH - 1];
+    size_t used = 0;
+
+    for(unsigned char i=0; String[i]; i++)
     {
-        putChar(String[i]);
-        i++;
+        unsigned char n = glyph(String[i], bytes);
+        for(unsigned char k=0; k<n; k++)
+        {
+            burst[used++] = bytes[k];
+            if(used == sizeof(burst))
+            {
+                sendDataBurst(burst, used);
+                used = 0;
+            }
+        }
+    }
+    if(used)
+    {
+        sendDataBurst(burst, used);
     }
 }
 
 unsigned char SeeedGrayOLED::putNumber(long long_num)
 {
     unsigned char char_buffer[10]="";
+    char text[12];
     unsigned char i = 0;
     unsigned char f = 0;
 
     if (long_num < 0)
     {
-        f=1;
-        putChar('-');
+        text[f++] = '-';
         long_num = -long_num;
     }
     else if (long_num == 0)
     {
-        f=1;
-        putChar('0');
-        return f;
+        text[f++] = '0';
     }
 
     while (long_num > 0)
@@ -402,17 +604,21 @@ unsigned char SeeedGrayOLED::putNumber(long long_num)
         long_num /= 10;
     }
 
-    f=f+i;
     for(; i > 0; i--)
     {
-        putChar('0'+ char_buffer[i - 1]);
+        text[f++] = '0'+ char_buffer[i - 1];
     }
+    text[f] = '\0';
+    putString(text);
     return f;
 
 }
 
 void SeeedGrayOLED::drawBitmap(const unsigned char *bitmaparray,int bytes)
 {
+  unsigned char burst[BUFFER_LENGTH - 1];
+  size_t used = 0;
+
   if(Drive_IC == SSD1327)
   {
     char localAddressMode = addressingMode;
@@ -424,19 +630,22 @@ void SeeedGrayOLED::drawBitmap(const unsigned char *bitmaparray,int bytes)
 
     for(int i=0;i<bytes;i++)
     {
-
-      for(int j=0;j<8;j=j+2) 
+      unsigned char bits = pgm_read_byte(&bitmaparray[i]);
+      for(int j=0;j<8;j=j+2)
       {
-        char c=0x00;
-        char bit1=pgm_read_byte(&bitmaparray[i]) << j  & 0x80;
-        char bit2=pgm_read_byte(&bitmaparray[i]) << (j+1) & 0x80;
-
-        // Each bit is changed to a nibble
-        c|=(bit1)?grayH:0x00;
-        // Each bit is changed to a nibble
-        c|=(bit2)?grayL:0x00;
-        sendData(c);
-     }
+        // Each pair of bits is changed to a byte of two nibbles
+        burst[used++] = grayPair[bits >> 6];
+        bits <<= 2;
+        if(used == sizeof(burst))
+        {
+          sendDataBurst(burst, used);
+          used = 0;
+        }
+      }
+    }
+    if(used)
+    {
+      sendDataBurst(burst, used);
     }
     if(localAddressMode == VERTICAL_MODE)
     {
@@ -446,31 +655,82 @@ void SeeedGrayOLED::drawBitmap(const unsigned char *bitmaparray,int bytes)
   }
   else if(Drive_IC == SH1107G)
   {
-    int Row = 0, column_l = 0x00, column_h = 0x10;
-
+    // The bitmap runs down the 16 pages of a column before moving to the next
+    // column. Page by page the columns are contiguous, so each page is one
+    // address command followed by bursts.
     setHorizontalMode();
-    for(int i=0;i<bytes;i++)
+    for(int Row = 0; Row < SH1107G_Pages && Row < bytes; Row++)
     {
-      sendCommand(0xb0 + Row);
-      sendCommand(column_l);
-      sendCommand(column_h);
+      setTextXY(Row, 0);
+      for(int i = Row; i < bytes; i += SH1107G_Pages)
+      {
+        burst[used++] = pgm_read_byte(&BitReverse[pgm_read_byte(&bitmaparray[i])]);
+        if(used == sizeof(burst))
+        {
+          sendDataBurst(burst, used);
+          used = 0;
+        }
+      }
+      if(used)
+      {
+        sendDataBurst(burst, used);
+        used = 0;
+      }
+    }
+  }
+}
 
-      byte bits = (byte)pgm_read_byte(&bitmaparray[i]);
-      byte tmp = 0x00;
-      for(int b = 0; b < 8; b++)
+void SeeedGrayOLED::drawCompressedBitmap(const unsigned char *image, unsigned char Page, unsigned char Column)
+{
+  if(Drive_IC != SH1107G)
+  {
+    return;
+  }
+
+  // Runs are decoded straight into bursts. A burst ends where a page of the image does.
+  unsigned char columns = pgm_read_byte(&image[0]);
+  unsigned char pages = pgm_read_byte(&image[1]);
+  const unsigned char *next = &image[2];
+  unsigned char burst[BUFFER_LENGTH - 1];
+  size_t used = 0;
+  unsigned char x = 0;
+  unsigned char page = 0;
+  unsigned char run = 0;             // bytes left in the current run
+  bool repeat = false;
+  unsigned char value = 0;
+
+  setTextXY(Page, Column);
+  while(page < pages)
+  {
+    if(run == 0)
+    {
+      unsigned char n = pgm_read_byte(next++);
+      if(n == 128)
       {
-        tmp |= ((bits>>(7-b))&0x01)<<b;
+        continue;
       }
-      sendData(tmp);
-      // delay(10);
-      Row++;
-      if(Row >= 16){
-        Row = 0;
-        column_l++;
-        if(column_l >= 16){
-          column_l = 0x00;
-          column_h += 0x01;
-        }
+      repeat = n > 128;
+      run = repeat ? 257 - n : n + 1;
+      if(repeat)
+      {
+        value = pgm_read_byte(next++);
+      }
+    }
+    burst[used++] = repeat ? value : pgm_read_byte(next++);
+    run--;
+    x++;
+    if(used == sizeof(burst) || x == columns)
+    {
+      sendDataBurst(burst, used);
+      used = 0;
+    }
+    if(x == columns)
+    {
+      x = 0;
+      page++;
+      if(page < pages)
+      {
+        setTextXY(Page + page, Column);
       }
     }
   }
@@ -537,4 +797,93 @@ void SeeedGrayOLED::setInverseDisplay()
     sendCommand(SeeedGrayOLED_Inverse_Display_Cmd);
 }
 
+bool SeeedGrayOLED::beginFramebuffer()
+{
+  if(Drive_IC != SH1107G)
+  {
+    return false;
+  }
+  if(frameBuffer == NULL)
+  {
+    frameBuffer = (unsigned char *)malloc(SH1107G_Pages * SH1107G_Columns);
+    if(frameBuffer == NULL)
+    {
+      return false;
+    }
+  }
+  // What the panel shows is unknown, so the first flush() sends every tile.
+  memset(frameBuffer, 0x00, SH1107G_Pages * SH1107G_Columns);
+  memset(dirtyTiles, 0xFF, sizeof(dirtyTiles));
+  bufferPage = 0;
+  bufferColumn = 0;
+  return true;
+}
+
+void SeeedGrayOLED::endFramebuffer()
+{
+  flush();
+  free(frameBuffer);
+  frameBuffer = NULL;
+}
+
+void SeeedGrayOLED::bufferData(unsigned char Data)
+{
+  unsigned char *cell = &frameBuffer[bufferPage * SH1107G_Columns + bufferColumn];
+  if(*cell != Data)
+  {
+    *cell = Data;
+    unsigned char tile = bufferPage * SH1107G_Tiles_Per_Page + (bufferColumn >> 3);
+    dirtyTiles[tile >> 3] |= 1 << (tile & 0x07);
+  }
+  bufferColumn = (bufferColumn + 1) & 0x7F;  // column address wraps like the controller's
+}
+
+void SeeedGrayOLED::flush()
+{
+  if(frameBuffer == NULL)
+  {
+    return;
+  }
+  for(unsigned char page = 0; page < SH1107G_Pages; page++)
+  {
+    unsigned char *dirty = &dirtyTiles[page * SH1107G_Tiles_Per_Page / 8];
+    unsigned char tile = 0;
+    while(tile < SH1107G_Tiles_Per_Page)
+    {
+      if(!(dirty[tile >> 3] & (1 << (tile & 0x07))))
+      {
+        tile++;
+        continue;
+      }
+      // Neighbouring dirty tiles go out as one run, the column address auto-increments.
+      unsigned char first = tile;
+      while(tile < SH1107G_Tiles_Per_Page && (dirty[tile >> 3] & (1 << (tile & 0x07))))
+      {
+        dirty[tile >> 3] &= ~(1 << (tile & 0x07));
+        tile++;
+      }
+      unsigned char column = first * 8;
+      sendCommand(0xb0 + page);
+      sendCommand(0x10 + ((column >> 4) & 0x07));
+      sendCommand(column & 0x0F);
+      writeData(&frameBuffer[page * SH1107G_Columns + column], (tile - first) * 8);
+    }
+  }
+}
+
+void SeeedGrayOLED::writeData(const unsigned char *Data, size_t Length)
+{
+  while(Length > 0)
+  {
+    // One data-mode control byte per transaction, the rest fills the Wire buffer.
+    size_t chunk = Length < BUFFER_LENGTH - 1 ? Length : BUFFER_LENGTH - 1;
+    Wire.beginTransmission(SeeedGrayOLED_Address);
+    Wire.write(SeeedGrayOLED_Data_Mode);
+    Wire.write(Data, chunk);
+    Wire.endTransmission();
+    Data += chunk;
+    Length -= chunk;
+  }
+}
+
 SeeedGrayOLED SeeedGrayOled;  // Preinstantiate Objects
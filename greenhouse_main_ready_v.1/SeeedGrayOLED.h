@@ -61,11 +61,19 @@
 #define Scroll_128Frames        0x2
 #define Scroll_256Frames        0x3
 
+// SH1107G display RAM: 16 pages of 128 columns, one byte = 8 vertical pixels.
+// The framebuffer tracks changes per 8x8 tile, 16 tiles per page.
+#define SH1107G_Pages           16
+#define SH1107G_Columns         128
+#define SH1107G_Tiles_Per_Page  16
+
 
 class SeeedGrayOLED {
 
 public:
 
+SeeedGrayOLED();
+
 char addressingMode;
 
 void init(int IC);
@@ -75,6 +83,7 @@ void setInverseDisplay();
 
 void sendCommand(unsigned char command);
 void sendData(unsigned char Data);
+void sendDataBurst(const unsigned char *Data, size_t Length);
 void setGrayLevel(unsigned char grayLevel);
 
 void setVerticalMode();
@@ -91,16 +100,37 @@ unsigned char putFloat(float floatNumber);
 
 void drawBitmap(const unsigned char *bitmaparray,int bytes);
 
+// Packed image (SH1107G only), made from a PBM file by bitmap/pbm2rle:
+//   columns, pages, then PackBits runs of display RAM bytes page by page.
+//   Control byte n: 0..127 = n+1 bytes follow as they are,
+//   129..255 = the next byte repeated 257-n times, 128 = nothing.
+// Drawn with its top left corner at page 'Page' (8 pixel rows), pixel column 'Column'.
+void drawCompressedBitmap(const unsigned char *image, unsigned char Page = 0, unsigned char Column = 0);
+
 void setHorizontalScrollProperties(bool direction,unsigned char startRow, unsigned char endRow,unsigned char startColumn, unsigned char endColumn, unsigned char scrollSpeed);
 void activateScroll();
 void deactivateScroll();
 
+// Framebuffer mode (SH1107G only). Drawing calls write into a 2 KB RAM copy
+// of the display and flush() sends only the 8x8 tiles that changed.
+bool beginFramebuffer();
+void endFramebuffer();
+void flush();
+
 private:
 
-unsigned char grayH;
-unsigned char grayL;
+unsigned char grayPair[4];        // SSD1327 display byte for each 2-bit pixel pair at the current gray level.
 int Drive_IC;
 
+unsigned char *frameBuffer;
+unsigned char dirtyTiles[SH1107G_Pages * SH1107G_Tiles_Per_Page / 8];
+unsigned char bufferPage;
+unsigned char bufferColumn;
+
+void bufferData(unsigned char Data);
+void writeData(const unsigned char *Data, size_t Length);
+unsigned char glyph(unsigned char C, unsigned char *Bytes);
+
 };
 
 extern SeeedGrayOLED SeeedGrayOled;  // SeeedGrayOLED object 
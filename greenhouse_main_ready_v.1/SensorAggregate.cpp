@@ -0,0 +1,80 @@
+#include "SensorAggregate.h"
+#include <stdlib.h>
+
+//Iterative odd-even merge sort: merge sorted runs of 'run' values, comparing values 'step' apart.
+uint8_t aggregateSort(int16_t *values, uint8_t count) {
+  uint8_t exchanges = 0;
+  for (uint8_t run = 1; run < count; run <<= 1) {
+    for (uint8_t step = run; step > 0; step >>= 1) {
+      for (uint8_t j = step & (run - 1); j + step < count; j += 2 * step) {
+        for (uint8_t i = 0; i < step && i + j + step < count; i++) {
+          if ((((i + j) ^ (i + j + step)) & ~(2 * run - 1)) != 0) {
+            continue;                                       //Pair in different merges. Powers of two, no division.
+          }
+          int16_t a = values[i + j];
+          int16_t b = values[i + j + step];
+          values[i + j] = a < b ? a : b;
+          values[i + j + step] = a < b ? b : a;
+          exchanges++;
+        }
+      }
+    }
+  }
+  return exchanges;
+}
+
+//Median of sorted values.
+static int16_t sortedMedian(const int16_t *sorted, uint8_t count) {
+  uint8_t middle = count / 2;
+  return count % 2 == 1 ? sorted[middle] : ((long)sorted[middle - 1] + sorted[middle]) / 2;
+}
+
+AggregateResult aggregate(const int16_t *readings, uint8_t count, const AggregateLimits &limits) {
+  AggregateResult result = {0, 0, 0, 0, 0, 0};
+  count = count < AGGREGATE_MAX ? count : AGGREGATE_MAX;
+  if (count == 0) {
+    return result;
+  }
+  int16_t sorted[AGGREGATE_MAX];
+  int16_t deviation[AGGREGATE_MAX];
+  for (uint8_t i = 0; i < count; i++) {
+    sorted[i] = readings[i];
+  }
+  aggregateSort(sorted, count);
+  result.count = count;
+  result.median = sortedMedian(sorted, count);
+
+  for (uint8_t i = 0; i < count; i++) {
+    long distance = labs((long)sorted[i] - result.median);
+    deviation[i] = distance < 32767 ? distance : 32767;
+  }
+  aggregateSort(deviation, count);
+  result.spread = sortedMedian(deviation, count);
+
+  //Outliers are the values furthest from the median, so those left are one run of the sorted values.
+  uint8_t first = 0;
+  uint8_t last = count;                                     //One past.
+  if (limits.outlierSpread > 0) {
+    long spread = result.spread > limits.minSpread ? result.spread : limits.minSpread;
+    long bound = (long)limits.outlierSpread * spread * 89 / 60;         //Standard deviations: 1.4826 * MAD.
+    while (first < last && result.median - (long)sorted[first] > bound) {
+      first++;
+    }
+    while (last > first && (long)sorted[last - 1] - result.median > bound) {
+      last--;
+    }
+  }
+  result.outliers = count - (last - first);
+
+  if (last - first >= 2 * limits.trim + 2) {
+    first += limits.trim;
+    last -= limits.trim;
+  }
+  long sum = 0;
+  for (uint8_t i = first; i < last; i++) {
+    sum += sorted[i];
+  }
+  result.used = last - first;
+  result.mean = sum / result.used;                          //At least the median is always left.
+  return result;
+}
@@ -0,0 +1,54 @@
+#ifndef SensorAggregate_H_
+#define SensorAggregate_H_
+#include <stdint.h>
+/*------------------------------------------------------//
+  One robust value from several sensors that measure the same thing, e.g.
+  the moisture probes of a bed.
+
+  The readings are sorted with Batcher's odd-even merge sort network. Its
+  compare-exchanges are fixed by the number of readings, not their values:
+  4 readings take 5, 8 take 19, 16 take 63. The network is the one for the
+  next power of two, with the compare-exchanges past the last reading left
+  out. That is the same as padding with the largest value.
+
+  From the sorted readings:
+  - median,
+  - spread: median absolute deviation from the median (MAD),
+  - outliers: readings further from the median than 'outlierSpread'
+    standard deviations, estimated as 1.4826 * MAD. The spread used is at
+    least 'minSpread', so that readings that happen to be equal do not make
+    every other one an outlier,
+  - mean of the rest, 'trim' readings dropped at both ends first if at
+    least 2 * trim + 2 are left.
+  With 4 readings, trim 1 and no outliers, the mean is the mean of the
+  middle two.
+
+  Up to AGGREGATE_MAX readings, working copies are on the stack. Nothing is
+  stored and no globals are set, the caller decides what the result means.
+  No Arduino dependencies, the host benchmark in aggregate/ builds this
+  file too.
+*/
+
+#define AGGREGATE_MAX 16
+
+struct AggregateLimits {
+  uint8_t trim;                     //Readings dropped at each end before the mean.
+  uint8_t outlierSpread;            //Standard deviations from the median that make an outlier, 0 for no outliers.
+  int16_t minSpread;                //Smallest MAD used for outliers, about the noise of one sensor.
+};
+
+struct AggregateResult {
+  int16_t mean;                     //Trimmed mean of the readings that are not outliers.
+  int16_t median;
+  int16_t spread;                   //Median absolute deviation.
+  uint8_t count;                    //Readings given, 0 if there was nothing to aggregate.
+  uint8_t used;                     //Readings in the mean.
+  uint8_t outliers;                 //Readings left out as outliers.
+};
+
+//Sort 'count' values (up to AGGREGATE_MAX) in place with the sorting network. Returns the compare-exchanges done.
+uint8_t aggregateSort(int16_t *values, uint8_t count);
+//Aggregate 'count' readings, at most AGGREGATE_MAX are used. 'readings' is not changed.
+AggregateResult aggregate(const int16_t *readings, uint8_t count, const AggregateLimits &limits);
+
+#endif  /* SensorAggregate_H_ */
@@ -0,0 +1,97 @@
+#include "SensorCache.h"
+
+SensorCache::SensorCache(const SensorRate *rates, uint8_t count) {
+  this->rates = rates;
+  this->count = count < SENSOR_CHANNELS_MAX ? count : SENSOR_CHANNELS_MAX;
+  for (uint8_t i = 0; i < SENSOR_CHANNELS_MAX; i++) {
+    channels[i].value = 0;
+    channels[i].readAt = 0;
+    channels[i].interval = 0;
+    channels[i].valid = false;
+    channels[i].hurried = false;
+    channels[i].missed = false;
+    channels[i].triedAt = 0;
+  }
+  readingCount = 0;
+}
+
+bool SensorCache::due(uint8_t channel) {
+  return untilDue(channel) == 0;
+}
+
+unsigned long SensorCache::untilDue(uint8_t channel) {
+  if (channel >= count) {
+    return (unsigned long)-1;
+  }
+  const Channel &c = channels[channel];
+  if (c.hurried == true) {
+    return 0;
+  }
+  if (c.missed == true) {
+    unsigned long waited = millis() - c.triedAt;
+    return waited < rates[channel].fastest ? rates[channel].fastest - waited : 0;
+  }
+  if (c.valid == false) {
+    return 0;
+  }
+  unsigned long age = millis() - c.readAt;
+  return age < c.interval ? c.interval - age : 0;
+}
+
+void SensorCache::store(uint8_t channel, long value) {
+  if (channel >= count) {
+    return;
+  }
+  Channel &c = channels[channel];
+  const SensorRate &rate = rates[channel];
+  long moved = value - c.value;
+  bool moving = c.valid == false || c.hurried == true || moved >= rate.change || -moved >= rate.change;
+  bool near = rate.distance != 0 && rate.distance(value) <= rate.near;
+
+  //Back off by doubling, so that a value that starts to move is caught again within one slow interval.
+  if (moving == true || near == true) {
+    c.interval = rate.fastest;
+  }
+  else {
+    c.interval = c.interval < rate.slowest / 2 ? c.interval * 2 : rate.slowest;
+  }
+  c.value = value;
+  c.readAt = millis();
+  c.valid = true;
+  c.hurried = false;
+  c.missed = false;
+  readingCount++;
+}
+
+void SensorCache::hurry(uint8_t channel) {
+  if (channel < count) {
+    channels[channel].hurried = true;
+  }
+}
+
+void SensorCache::missed(uint8_t channel) {
+  if (channel < count) {
+    channels[channel].missed = true;
+    channels[channel].triedAt = millis();
+    channels[channel].hurried = false;
+  }
+}
+
+long SensorCache::value(uint8_t channel) {
+  return channel < count ? channels[channel].value : 0;
+}
+
+unsigned long SensorCache::age(uint8_t channel) {
+  if (channel >= count || channels[channel].valid == false) {
+    return (unsigned long)-1;
+  }
+  return millis() - channels[channel].readAt;
+}
+
+bool SensorCache::fresh(uint8_t channel) {
+  return channel < count && age(channel) <= rates[channel].ttl;
+}
+
+unsigned long SensorCache::readings() {
+  return readingCount;
+}
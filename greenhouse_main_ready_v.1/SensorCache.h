@@ -0,0 +1,80 @@
+#ifndef SensorCache_H_
+#define SensorCache_H_
+#include "Arduino.h"
+/*------------------------------------------------------//
+  Last reading of each sensor channel, and when to read it next.
+
+  The sketch reads a channel when due() says so and hands the reading to
+  store(). Everything else uses value() and age() instead of reading the
+  sensor. A reading older than the channel's ttl is not fresh(), and
+  decisions should not be made on it.
+
+  The time between readings adapts. A reading that moved 'change' or more
+  since the one before, or that is within 'near' of a threshold, brings
+  the channel back to 'fastest'. Otherwise the time doubles after every
+  reading up to 'slowest'. hurry() makes a channel due now, for when
+  the sketch knows the value is about to move: a pump run, the lights
+  switched, a threshold changed. missed() is for a reading that could not
+  be used: the channel is tried again after 'fastest', not straight away.
+
+  The channels are a table of SensorRate set by the sketch, one per
+  channel, indexed by the sketch's own channel numbers.
+*/
+
+#define SENSOR_CHANNELS_MAX 8
+
+//Distance from 'value' to the nearest threshold of a channel.
+typedef long (*SensorDistance)(long value);
+
+struct SensorRate {
+  unsigned long fastest;            //ms between readings while the value moves or is near a threshold.
+  unsigned long slowest;            //ms between readings while the value is stable.
+  unsigned long ttl;                //ms a reading may be used for.
+  long change;                      //Move since the reading before that counts as moving. Larger than the noise.
+  long near;                        //Distance to a threshold that counts as near.
+  SensorDistance distance;          //0 if the channel has no threshold.
+};
+
+class SensorCache {
+
+  struct Channel {
+    long value;
+    unsigned long readAt;           //millis() of the last reading.
+    unsigned long interval;         //ms from the last reading to the next.
+    bool valid;                     //At least one reading stored.
+    bool hurried;
+    bool missed;                    //The last try gave no reading, at 'triedAt'.
+    unsigned long triedAt;
+  };
+
+  const SensorRate *rates;
+  Channel channels[SENSOR_CHANNELS_MAX];
+  uint8_t count;
+  unsigned long readingCount;
+
+  public:
+    SensorCache(const SensorRate *rates, uint8_t count);
+
+    //The channel should be read now. Always true before the first reading.
+    bool due(uint8_t channel);
+    //Milliseconds until the channel is due, 0 if it is due now.
+    unsigned long untilDue(uint8_t channel);
+    //A new reading of the channel. Sets when it is due next.
+    void store(uint8_t channel, long value);
+    //Make the channel due now and read it at 'fastest' until it settles again.
+    void hurry(uint8_t channel);
+    //The channel was read but the reading was not usable. It is due again after 'fastest'.
+    void missed(uint8_t channel);
+
+    //Last reading of the channel, 0 before the first one.
+    long value(uint8_t channel);
+    //Milliseconds since the last reading, the largest value before the first one.
+    unsigned long age(uint8_t channel);
+    //There is a reading and it is younger than the channel's ttl.
+    bool fresh(uint8_t channel);
+
+    //Readings stored, all channels together, for tuning.
+    unsigned long readings();
+};
+
+#endif  /* SensorCache_H_ */
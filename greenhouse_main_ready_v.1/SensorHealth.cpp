@@ -0,0 +1,91 @@
+#include "SensorHealth.h"
+#include <string.h>
+
+SensorHealth::SensorHealth(const SensorLimits *limits, uint8_t count) {
+  this->limits = limits;
+  this->count = count < HEALTH_CHANNELS_MAX ? count : HEALTH_CHANNELS_MAX;
+  memset(channels, 0, sizeof(channels));
+  failureCount = 0;
+}
+
+bool SensorHealth::check(uint8_t channel, long value) {
+  if (channel >= count) {
+    return false;
+  }
+  Channel &c = channels[channel];
+  const SensorLimits &limit = limits[channel];
+  if (value < limit.minimum || value > limit.maximum) {
+    fail(channel);
+    return false;
+  }
+
+  //A step too large is a spike, unless the reading after it is at the same new level.
+  bool newLevel = false;
+  if (limit.maxStep > 0 && c.accepted == true && labs(value - c.last) > limit.maxStep) {
+    newLevel = c.spike == true && labs(value - c.pending) <= limit.maxStep;
+    if (newLevel == false) {
+      c.pending = value;
+      c.spike = true;
+      fail(channel);
+      return false;
+    }
+  }
+  accept(channel, value, newLevel);
+  return true;
+}
+
+//The step to a new level is not a change between readings, it is left out of the statistics.
+void SensorHealth::accept(uint8_t channel, long value, bool newLevel) {
+  Channel &c = channels[channel];
+  const SensorLimits &limit = limits[channel];
+
+  if (c.accepted == true && newLevel == false) {
+    //Welford's update with the count held at HEALTH_WINDOW, so older changes fade out.
+    float change = value - c.last;
+    c.count = c.count < HEALTH_WINDOW ? c.count + 1 : HEALTH_WINDOW;
+    float delta = change - c.mean;
+    c.mean += delta / c.count;
+    c.variance = (c.variance + delta * delta / c.count) * (c.count - 1) / c.count;
+  }
+  c.sameRun = c.accepted == true && value == c.last ? (c.sameRun < 255 ? c.sameRun + 1 : 255) : 0;
+  c.last = value;
+  c.accepted = true;
+  c.spike = false;
+  c.failRun = 0;
+
+  c.flags = 0;
+  if (limit.stuckReadings > 0 && c.sameRun + 1 >= limit.stuckReadings) {
+    c.flags |= SENSOR_STUCK;
+  }
+  if (limit.maxNoise > 0 && c.count >= HEALTH_MIN_READINGS && c.variance > (float)limit.maxNoise * limit.maxNoise) {
+    c.flags |= SENSOR_NOISY;
+  }
+}
+
+void SensorHealth::fail(uint8_t channel) {
+  if (channel >= count) {
+    return;
+  }
+  Channel &c = channels[channel];
+  c.failRun = c.failRun < 255 ? c.failRun + 1 : 255;
+  if (c.failRun >= limits[channel].deadFailures) {
+    c.flags |= SENSOR_DEAD;
+  }
+  failureCount++;
+}
+
+bool SensorHealth::healthy(uint8_t channel) {
+  return flags(channel) == 0;
+}
+
+uint8_t SensorHealth::flags(uint8_t channel) {
+  return channel < count ? channels[channel].flags : SENSOR_DEAD;
+}
+
+float SensorHealth::noise(uint8_t channel) {
+  return channel < count ? sqrt(channels[channel].variance) : 0;
+}
+
+unsigned long SensorHealth::failures() {
+  return failureCount;
+}
@@ -0,0 +1,89 @@
+#ifndef SensorHealth_H_
+#define SensorHealth_H_
+#include "Arduino.h"
+/*------------------------------------------------------//
+  Health of each sensor channel, checked on every reading.
+
+  check() is called with each new reading before it is used. It rejects
+  readings that cannot be right:
+  - outside the channel's range, e.g. 65535 from a sensor that does not
+    answer on I2C,
+  - more than maxStep away from the reading before. A single spike is
+    dropped, but the next reading is accepted if it confirms the new level.
+  A reading that could not be taken at all (NaN, timeout, checksum) is
+  reported with fail(). Rejected and failed readings are counted, and
+  'deadFailures' of them in a row mark the channel DEAD until a reading is
+  accepted again.
+
+  Accepted readings keep running statistics of the change from one reading
+  to the next: an exponentially weighted Welford mean and variance over
+  about HEALTH_WINDOW readings. The mean is the drift, the variance the
+  noise, so a slow change of the value itself does not count as noise. A
+  standard deviation above maxNoise marks the channel NOISY. The same
+  reading 'stuckReadings' times in a row marks it STUCK.
+
+  Memory per channel is fixed, nothing is kept of the readings themselves.
+  The channels are a table of SensorLimits set by the sketch, one per
+  channel, indexed like the SensorCache channels.
+*/
+
+#define HEALTH_CHANNELS_MAX 8
+#define HEALTH_WINDOW 32            //Readings the statistics are weighted over.
+#define HEALTH_MIN_READINGS 8       //Readings before noise is judged.
+
+//Flags, a channel without flags is healthy.
+#define SENSOR_STUCK 0x01
+#define SENSOR_NOISY 0x02
+#define SENSOR_DEAD 0x04
+
+struct SensorLimits {
+  long minimum;                     //Readings outside minimum - maximum are failures.
+  long maximum;
+  long maxStep;                     //Largest change from the reading before, 0 for no bound.
+  uint16_t maxNoise;                //Largest standard deviation of the change between readings, 0 for no check.
+  uint8_t stuckReadings;            //Same reading this many times in a row is stuck, 0 for no check.
+  uint8_t deadFailures;             //Failures in a row before the channel is dead.
+};
+
+class SensorHealth {
+
+  struct Channel {
+    float mean;                     //Of the change between readings.
+    float variance;
+    long last;                      //Last accepted reading.
+    long pending;                   //Reading rejected for its step, accepted if the next one is close to it.
+    uint8_t count;                  //Changes in the statistics, up to HEALTH_WINDOW.
+    uint8_t sameRun;                //Readings in a row equal to 'last'.
+    uint8_t failRun;                //Failures in a row.
+    uint8_t flags;
+    bool accepted;                  //'last' holds a reading.
+    bool spike;                     //'pending' holds a reading.
+  };
+
+  const SensorLimits *limits;
+  Channel channels[HEALTH_CHANNELS_MAX];
+  uint8_t count;
+  unsigned long failureCount;
+
+  void accept(uint8_t channel, long value, bool newLevel);
+
+  public:
+    SensorHealth(const SensorLimits *limits, uint8_t count);
+
+    //A new reading of the channel. Returns false if it is rejected and must not be used.
+    bool check(uint8_t channel, long value);
+    //The channel could not be read.
+    void fail(uint8_t channel);
+
+    //No flags set.
+    bool healthy(uint8_t channel);
+    //SENSOR_STUCK, SENSOR_NOISY and SENSOR_DEAD.
+    uint8_t flags(uint8_t channel);
+    //Standard deviation of the change between readings.
+    float noise(uint8_t channel);
+
+    //Readings failed or rejected, all channels together, for tuning.
+    unsigned long failures();
+};
+
+#endif  /* SensorHealth_H_ */
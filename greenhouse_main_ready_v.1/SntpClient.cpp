@@ -0,0 +1,157 @@
+#include "SntpClient.h"
+
+SntpClient::SntpClient(WiFiUDP &udp, IPAddress server, NtpClock clock, unsigned long pollInterval) : udp(udp), server(server) {
+  this->clock = clock;
+  this->pollInterval = pollInterval;
+  backoff = SNTP_MIN_BACKOFF;
+  waiting = false;
+  received = false;
+  everSynced = false;
+  exchanges = 0;
+  lastOffset = 0;
+  lastDelay = 0;
+  failed = 0;
+}
+
+/*
+  ===============
+  || Exchange. ||
+  =============== */
+static void putTimestamp(byte *field, uint64_t timestamp) {
+  for (uint8_t i = 0; i < 8; i++) {
+    field[i] = timestamp >> (56 - 8 * i);
+  }
+}
+
+static uint64_t getTimestamp(const byte *field) {
+  uint64_t timestamp = 0;
+  for (uint8_t i = 0; i < 8; i++) {
+    timestamp = timestamp << 8 | field[i];
+  }
+  return timestamp;
+}
+
+//Client request (mode 3). The transmit timestamp is T1, the server copies it into the originate timestamp of its reply.
+void SntpClient::sendRequest() {
+  byte packet[SNTP_PACKET_SIZE];
+  memset(packet, 0, SNTP_PACKET_SIZE);
+  packet[0] = 0b11100011;           //LI unsynchronized, version 4, mode 3 (client).
+  packet[2] = 6;                    //Polling interval.
+  packet[3] = 0xEC;                 //Peer clock precision.
+
+  udp.flush();                      //Drop anything left from an earlier request.
+  udp.beginPacket(server, SNTP_PORT);
+  sentAt = millis();
+  originate = clock();
+  putTimestamp(&packet[40], originate);
+  udp.write(packet, SNTP_PACKET_SIZE);
+  udp.endPacket();
+}
+
+//Accept only a server reply (mode 4) from a synchronized server that answers our last request.
+bool SntpClient::readReply() {
+  if (udp.parsePacket() < SNTP_PACKET_SIZE) {
+    return false;
+  }
+  uint64_t t4 = clock();
+  byte packet[SNTP_PACKET_SIZE];
+  udp.read(packet, SNTP_PACKET_SIZE);
+
+  uint64_t t1 = getTimestamp(&packet[24]);
+  uint64_t t2 = getTimestamp(&packet[32]);
+  uint64_t t3 = getTimestamp(&packet[40]);
+  if ((packet[0] & 0x07) != 4 || packet[1] == 0 || t1 != originate || t2 == 0 || t3 == 0) {
+    return false;
+  }
+
+  int64_t roundTrip = (int64_t)(t4 - t1) - (int64_t)(t3 - t2);
+  unsigned long delayMicros = roundTrip > 0 ? (roundTrip * 1000000) >> 32 : 0;
+  if (delayMicros > SNTP_MAX_DELAY) {
+    return false;
+  }
+
+  if (exchanges == 0 || delayMicros < bestDelay) {
+    bestOffset = (int64_t)(t2 - t1) / 2 + (int64_t)(t3 - t4) / 2;    //Halved first, the sum of two offsets of decades does not fit.
+    bestDelay = delayMicros;
+  }
+  exchanges++;
+  return true;
+}
+
+//Publish the best exchange of the burst.
+unsigned long SntpClient::finishBurst() {
+  lastOffset = bestOffset;
+  lastDelay = bestDelay;
+  syncedAt = millis();
+  everSynced = true;
+  received = true;
+  exchanges = 0;
+  failed = 0;
+  backoff = SNTP_MIN_BACKOFF;
+  return pollInterval;
+}
+
+/*
+  ====================
+  || Main loop API. ||
+  ==================== */
+unsigned long SntpClient::update() {
+  if (!waiting) {
+    sendRequest();
+    waiting = true;
+    return SNTP_REPLY_POLL;
+  }
+
+  if (readReply()) {
+    waiting = false;
+    if (exchanges < SNTP_BURST) {
+      return SNTP_REPLY_POLL;         //Next exchange of the burst.
+    }
+    return finishBurst();
+  }
+
+  if (millis() - sentAt < SNTP_TIMEOUT) {
+    return SNTP_REPLY_POLL;
+  }
+
+  //No usable reply. Use what the burst got so far, or try again later and wait longer each time.
+  waiting = false;
+  if (exchanges > 0) {
+    return finishBurst();
+  }
+  if (failed < 255) {
+    failed++;
+  }
+  unsigned long wait = backoff;
+  backoff = backoff < pollInterval / 2 ? backoff * 2 : pollInterval;
+  return wait;
+}
+
+void SntpClient::setPollInterval(unsigned long pollInterval) {
+  this->pollInterval = pollInterval;
+}
+
+bool SntpClient::newTime() {
+  bool fresh = received;
+  received = false;
+  return fresh;
+}
+
+int64_t SntpClient::offset() {
+  return lastOffset;
+}
+
+unsigned long SntpClient::delay() {
+  return lastDelay;
+}
+
+unsigned long SntpClient::age() {
+  if (!everSynced) {
+    return (unsigned long)-1;
+  }
+  return millis() - syncedAt;
+}
+
+uint8_t SntpClient::failures() {
+  return failed;
+}
@@ -0,0 +1,79 @@
+#ifndef SntpClient_H_
+#define SntpClient_H_
+#include "Arduino.h"
+#include <WiFiNINA.h>
+#include <WiFiUdp.h>
+/*------------------------------------------------------//
+  Non-blocking SNTP client.
+
+  update() is called from the main loop and never waits for the network: it
+  sends a request and returns, and picks up the reply on a later call. It
+  returns how many milliseconds may pass before it needs to be called again,
+  which is the poll interval after a good reply. A request that is not
+  answered within SNTP_TIMEOUT is retried after a back-off that starts at
+  SNTP_MIN_BACKOFF and doubles up to the poll interval.
+
+  All four timestamps of the exchange are used, as in NTP: the request leaves
+  at T1 and the reply arrives at T4 on the local clock, the server receives
+  at T2 and answers at T3 on its clock. Then
+    offset = ((T2 - T1) + (T3 - T4)) / 2    local clock error, server minus local
+    delay  = (T4 - T1) - (T3 - T2)          network round trip
+  Timestamps are NTP 32.32 fixed point, the local clock is a function that
+  returns one. T1 also identifies the reply, the server echoes it.
+
+  The reply is only seen when the main loop gets to it, and the wait counts
+  as delay and skews the offset by half of it. Each sync is therefore a burst
+  of SNTP_BURST exchanges and the one with the shortest delay is used.
+*/
+
+#define SNTP_PACKET_SIZE 48
+#define SNTP_PORT 123
+#define SNTP_TIMEOUT 2000           //ms to wait for a reply.
+#define SNTP_MAX_DELAY 500000UL     //us, replies that took longer are not precise enough and are dropped.
+#define SNTP_REPLY_POLL 10          //ms between checks for the reply, a late check adds to the delay.
+#define SNTP_MIN_BACKOFF 16000UL    //ms before the first retry after a timeout.
+#define SNTP_BURST 4                //Exchanges per sync.
+
+typedef uint64_t (*NtpClock)(void);
+
+class SntpClient {
+
+  WiFiUDP &udp;
+  IPAddress server;
+  NtpClock clock;
+  unsigned long pollInterval;
+  unsigned long backoff;
+  bool waiting;                     //Request sent, reply not yet received.
+  unsigned long sentAt;             //millis() when the request was sent.
+  uint64_t originate;               //T1, local clock when the request was sent.
+  uint8_t exchanges;                //Replies received in the current burst.
+  int64_t bestOffset;               //Offset of the reply with the shortest delay in the burst.
+  unsigned long bestDelay;
+  bool received;                    //Set by a good reply, cleared by newTime().
+  unsigned long syncedAt;           //millis() of the last good reply.
+  bool everSynced;
+  int64_t lastOffset;
+  unsigned long lastDelay;
+  uint8_t failed;
+
+  void sendRequest();
+  bool readReply();
+  unsigned long finishBurst();
+
+  public:
+    SntpClient(WiFiUDP &udp, IPAddress server, NtpClock clock, unsigned long pollInterval);
+
+    unsigned long update();
+    void setPollInterval(unsigned long pollInterval);
+    //True once after each good reply.
+    bool newTime();
+    //Offset (signed 32.32 seconds) and delay (us) measured by the last good reply.
+    int64_t offset();
+    unsigned long delay();
+    //Milliseconds since the last good reply, ULONG_MAX before the first one.
+    unsigned long age();
+    //Requests in a row that got no usable reply.
+    uint8_t failures();
+};
+
+#endif  /* SntpClient_H_ */
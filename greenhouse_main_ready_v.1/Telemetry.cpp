@@ -0,0 +1,54 @@
+#include "Telemetry.h"
+
+Telemetry::Telemetry(HardwareSerial &port, unsigned long keepalive, uint8_t deadband) : port(port) {
+  this->keepalive = keepalive;
+  this->deadband = deadband;
+  sentAt = 0;
+  sentAny = false;
+  sequence = 0;
+  deferred = 0;
+}
+
+static bool moved(long value, long sent, uint8_t deadband) {
+  long change = value > sent ? value - sent : sent - value;
+  return change * 100 > (sent < 0 ? -sent : sent) * deadband;
+}
+
+bool Telemetry::changed(const TelemetryRecord &record) {
+  for (uint8_t i = 0; i < 4; i++) {
+    if (moved(record.moisture[i], last.moisture[i], deadband) == true) {
+      return true;
+    }
+  }
+  return moved(record.temperature, last.temperature, deadband) || moved(record.humidity, last.humidity, deadband)
+         || moved(record.light, last.light, deadband) || moved(record.uv, last.uv, deadband)
+         || moved(record.waterFlow, last.waterFlow, deadband) || moved(record.fanSpeed, last.fanSpeed, deadband)
+         || record.waterToday != last.waterToday || record.tempThreshold != last.tempThreshold || record.outputs != last.outputs
+         || record.faults != last.faults || record.status != last.status || record.action != last.action;
+}
+
+bool Telemetry::update(TelemetryRecord &record) {
+  if (sentAny == true && changed(record) == false && millis() - sentAt < keepalive) {
+    return false;
+  }
+
+  record.version = TELEMETRY_VERSION;
+  record.sequence = sequence;
+  uint8_t frame[TELEMETRY_FRAME_MAX];
+  size_t length = telemetryEncode(record, frame);
+  if ((size_t)port.availableForWrite() < length) {
+    deferred++;
+    return false;
+  }
+  port.write(frame, length);
+
+  sequence++;
+  sentAt = millis();
+  sentAny = true;
+  last = record;
+  return true;
+}
+
+uint16_t Telemetry::deferrals() {
+  return deferred;
+}
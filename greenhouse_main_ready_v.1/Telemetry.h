@@ -0,0 +1,50 @@
+#ifndef Telemetry_H_
+#define Telemetry_H_
+#include "Arduino.h"
+#include "TelemetryFrame.h"
+/*------------------------------------------------------//
+  Binary telemetry on a serial port.
+
+  update() is given the current state every time it is called and sends it
+  as one frame (see TelemetryFrame.h) when it changed, or when 'keepalive' ms
+  passed since the last frame so that the receiver sees the link is up.
+  Sensor values count as changed when they moved more than 'deadband' percent
+  from the value last sent, so that sensor noise alone does not send frames.
+  Outputs, faults and status count on any change.
+
+  A frame is only written when it fits in the TX buffer, so sending never
+  waits for the port. A frame that does not fit is sent on a later call.
+*/
+
+class Telemetry {
+
+  HardwareSerial &port;
+  unsigned long keepalive;
+  uint8_t deadband;                 //Percent.
+  unsigned long sentAt;             //millis() when the last frame was sent.
+  bool sentAny;
+  uint8_t sequence;
+  TelemetryRecord last;             //Last record sent.
+  uint16_t deferred;
+
+  bool changed(const TelemetryRecord &record);
+
+  public:
+    Telemetry(HardwareSerial &port, unsigned long keepalive, uint8_t deadband);
+
+    //Version and sequence are filled in. Returns true if a frame was sent.
+    bool update(TelemetryRecord &record);
+    //Frames that had to wait because the TX buffer was full.
+    uint16_t deferrals();
+};
+
+//Print that drops everything. Stands in for Serial when the port carries binary telemetry.
+class NullPrint : public Print {
+  public:
+    size_t write(uint8_t c) {
+      return 1;
+    }
+    using Print::write;
+};
+
+#endif  /* Telemetry_H_ */
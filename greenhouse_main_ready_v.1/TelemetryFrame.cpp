@@ -0,0 +1,88 @@
+#include "TelemetryFrame.h"
+#include <string.h>
+
+//CRC-16/CCITT-FALSE: polynomial 0x1021, start 0xFFFF. Bit by bit, a table would cost 512 bytes of flash.
+uint16_t telemetryCrc(const uint8_t *data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+/*
+  ===============================================
+  || Consistent overhead byte stuffing (COBS). ||
+  =============================================== */
+//Every zero is replaced by the distance to the next one, stored in front of each run of non-zero bytes.
+size_t cobsEncode(const uint8_t *in, size_t length, uint8_t *out) {
+  size_t codeAt = 0;
+  size_t written = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < length; i++) {
+    if (in[i] != 0) {
+      out[written++] = in[i];
+      code++;
+    }
+    if (in[i] == 0 || code == 0xFF) {
+      out[codeAt] = code;
+      codeAt = written++;
+      code = 1;
+    }
+  }
+  out[codeAt] = code;
+  return written;
+}
+
+size_t cobsDecode(const uint8_t *in, size_t length, uint8_t *out) {
+  size_t written = 0;
+  size_t i = 0;
+  while (i < length) {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > length) {
+      return 0;
+    }
+    for (uint8_t k = 1; k < code; k++) {
+      if (in[i] == 0) {
+        return 0;
+      }
+      out[written++] = in[i++];
+    }
+    if (code != 0xFF && i < length) {
+      out[written++] = 0;
+    }
+  }
+  return written;
+}
+
+/*
+  =============
+  || Frames. ||
+  ============= */
+size_t telemetryEncode(const TelemetryRecord &record, uint8_t *frame) {
+  uint8_t payload[sizeof(TelemetryRecord) + 2];
+  memcpy(payload, &record, sizeof(TelemetryRecord));
+  uint16_t crc = telemetryCrc(payload, sizeof(TelemetryRecord));
+  payload[sizeof(TelemetryRecord)] = crc & 0xFF;
+  payload[sizeof(TelemetryRecord) + 1] = crc >> 8;
+
+  size_t length = cobsEncode(payload, sizeof(payload), frame);
+  frame[length++] = 0;
+  return length;
+}
+
+bool telemetryDecode(const uint8_t *frame, size_t length, TelemetryRecord &record) {
+  uint8_t payload[TELEMETRY_FRAME_MAX];
+  if (length > sizeof(payload) || cobsDecode(frame, length, payload) != sizeof(TelemetryRecord) + 2) {
+    return false;
+  }
+  uint16_t crc = payload[sizeof(TelemetryRecord)] | (uint16_t)payload[sizeof(TelemetryRecord) + 1] << 8;
+  if (crc != telemetryCrc(payload, sizeof(TelemetryRecord)) || payload[0] != TELEMETRY_VERSION) {
+    return false;
+  }
+  memcpy(&record, payload, sizeof(TelemetryRecord));
+  return true;
+}
@@ -0,0 +1,76 @@
+#ifndef TelemetryFrame_H_
+#define TelemetryFrame_H_
+#include <stdint.h>
+#include <stddef.h>
+/*------------------------------------------------------//
+  Binary telemetry record and its framing on the serial port.
+
+  A record is the whole sensor and actuator state in a fixed layout,
+  little-endian. On the wire it is followed by a CRC-16/CCITT-FALSE over the
+  record (low byte first), COBS-encoded so that the frame holds no zero
+  bytes, and ended by a single zero byte:
+    COBS(record, crc) 0x00
+  A receiver that starts in the middle of the stream or loses bytes finds
+  the next frame at the next zero, and the CRC drops the broken one.
+
+  No Arduino dependencies, the host decoder in telemetry/ builds this file
+  too. Change TELEMETRY_VERSION whenever the record layout changes.
+*/
+
+#define TELEMETRY_VERSION 2
+#define TELEMETRY_NO_VALUE -32768   //Temperature or humidity that could not be read.
+
+//Bits in TelemetryRecord::outputs.
+#define TELEMETRY_PUMP 0x01
+#define TELEMETRY_LED_LIGHTING 0x02
+#define TELEMETRY_FAN 0x04
+#define TELEMETRY_FAN_LOW_SPEED 0x08
+
+//Bits in TelemetryRecord::faults.
+#define TELEMETRY_MOISTURE_DRY 0x01
+#define TELEMETRY_MOISTURE_WET 0x02
+#define TELEMETRY_TEMPERATURE_HIGH 0x04
+#define TELEMETRY_WATER_FLOW 0x08
+#define TELEMETRY_WATER_LEVEL 0x10
+#define TELEMETRY_LED_LIGHTING_FAULT 0x20
+
+//Bits in TelemetryRecord::status.
+#define TELEMETRY_PROGRAM_STARTED 0x01
+#define TELEMETRY_WIFI_CONNECTED 0x02
+#define TELEMETRY_CLOCK_SYNCED 0x04
+
+struct TelemetryRecord {
+  uint8_t version;                  //TELEMETRY_VERSION.
+  uint8_t sequence;                 //Counts sent records, a gap shows lost frames.
+  uint32_t time;                    //Unix time (UTC) from the internal clock.
+  int16_t moisture[4];              //Capacitive moisture sensors 1-4.
+  int16_t temperature;              //Tenths of °C.
+  int16_t humidity;                 //Tenths of %.
+  uint16_t light;                   //Visible light.
+  uint16_t uv;                      //UV index * 100.
+  uint16_t waterFlow;               //ml/min.
+  uint16_t fanSpeed;                //rpm.
+  uint16_t waterToday;              //ml pumped since local midnight.
+  uint8_t tempThreshold;            //°C, set with the rotary encoder.
+  uint8_t outputs;                  //TELEMETRY_PUMP ...
+  uint8_t faults;                   //TELEMETRY_MOISTURE_DRY ...
+  uint8_t status;                   //TELEMETRY_PROGRAM_STARTED ...
+  uint8_t action;                   //What the program is doing, actionRegister in the sketch.
+} __attribute__((packed));
+
+//Record and CRC, one COBS code byte per 254 bytes and the closing zero.
+#define TELEMETRY_FRAME_MAX (sizeof(TelemetryRecord) + 2 + (sizeof(TelemetryRecord) + 2) / 254 + 2)
+
+uint16_t telemetryCrc(const uint8_t *data, size_t length);
+
+//COBS. encode() writes at most length + length / 254 + 1 bytes and no zero.
+//decode() returns the decoded length, 0 if the input is not valid COBS.
+size_t cobsEncode(const uint8_t *in, size_t length, uint8_t *out);
+size_t cobsDecode(const uint8_t *in, size_t length, uint8_t *out);
+
+//Whole frame including the closing zero into 'frame' (TELEMETRY_FRAME_MAX bytes). Returns its length.
+size_t telemetryEncode(const TelemetryRecord &record, uint8_t *frame);
+//One frame without its closing zero. False if it is broken or of another version.
+bool telemetryDecode(const uint8_t *frame, size_t length, TelemetryRecord &record);
+
+#endif  /* TelemetryFrame_H_ */
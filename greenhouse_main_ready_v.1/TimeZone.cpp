@@ -0,0 +1,77 @@
+#include "TimeZone.h"
+
+TimeZone::TimeZone(TimeChangeRule dstStart, TimeChangeRule stdStart) {
+  dst = dstStart;
+  std = stdStart;
+}
+
+/*
+  =======================
+  || Calendar helpers. ||
+  ======================= */
+//Days from 1970-01-01 to the given date, negative before it. Years are shifted to start in March so the leap day comes last.
+long daysFromCivil(int year, uint8_t month, uint8_t day) {
+  long y = year - (month <= 2 ? 1 : 0);
+  long era = (y >= 0 ? y : y - 399) / 400;
+  long yearOfEra = y - era * 400;                                                 //0-399
+  long dayOfYear = (153L * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;  //0-365
+  long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;  //0-146096
+  return era * 146097L + dayOfEra - 719468L;
+}
+
+void civilFromDays(long days, int &year, uint8_t &month, uint8_t &day) {
+  days += 719468L;
+  long era = (days >= 0 ? days : days - 146096L) / 146097L;
+  long dayOfEra = days - era * 146097L;
+  long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  long monthFromMarch = (5 * dayOfYear + 2) / 153;
+  day = dayOfYear - (153 * monthFromMarch + 2) / 5 + 1;
+  month = monthFromMarch < 10 ? monthFromMarch + 3 : monthFromMarch - 9;
+  year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+uint8_t dayOfWeek(long days) {
+  return (days % 7 + 7 + 4) % 7 + 1;                                              //1970-01-01 was a Thursday.
+}
+
+/*
+  ======================
+  || Daylight saving. ||
+  ====================== */
+//Unix time when 'rule' takes effect in 'year'. The rule hour is local time before the change, i.e. at 'offsetBefore' minutes from UTC.
+unsigned long TimeZone::changeTime(const TimeChangeRule &rule, int offsetBefore, int year) {
+  long first;
+  if (rule.week == 0) {
+    //Last week: step back one week from the first day of the next month.
+    if (rule.month == 12) {
+      first = daysFromCivil(year + 1, 1, 1) - 7;
+    }
+    else {
+      first = daysFromCivil(year, rule.month + 1, 1) - 7;
+    }
+  }
+  else {
+    first = daysFromCivil(year, rule.month, 1) + (rule.week - 1) * 7;
+  }
+  long day = first + (rule.dayOfWeek - dayOfWeek(first) + 7) % 7;
+  return day * 86400UL + rule.hour * 3600UL - (long)offsetBefore * 60;
+}
+
+bool TimeZone::isDST(unsigned long utc) {
+  int year;
+  uint8_t month, day;
+  civilFromDays(utc / 86400UL, year, month, day);
+
+  unsigned long dstStart = changeTime(dst, std.offset, year);
+  unsigned long stdStart = changeTime(std, dst.offset, year);
+  if (dstStart < stdStart) {
+    return utc >= dstStart && utc < stdStart;                                     //Northern hemisphere, summer inside the year.
+  }
+  return !(utc >= stdStart && utc < dstStart);                                    //Southern hemisphere, summer across new year.
+}
+
+unsigned long TimeZone::toLocal(unsigned long utc) {
+  int offset = isDST(utc) ? dst.offset : std.offset;
+  return utc + (long)offset * 60;
+}
@@ -0,0 +1,43 @@
+#ifndef TimeZone_H_
+#define TimeZone_H_
+#include "Arduino.h"
+/*------------------------------------------------------//
+  Time zone with daylight saving time.
+
+  A zone is described by two rules: when daylight saving time starts and when
+  standard time starts again, both given as "the n:th weekday of a month at a
+  local hour", e.g. last Sunday of March at 02:00. All times are Unix time
+  (seconds since 1970-01-01 UTC) so the rules work for any year.
+*/
+
+struct TimeChangeRule {
+  uint8_t week;                     //1-4 = first to fourth, 0 = last week of the month.
+  uint8_t dayOfWeek;                //1 = Sunday ... 7 = Saturday.
+  uint8_t month;                    //1 = January ... 12 = December.
+  uint8_t hour;                     //Local hour, in the time being left, when the change happens.
+  int offset;                       //Minutes ahead of UTC from the change on.
+};
+
+class TimeZone {
+
+  TimeChangeRule dst;
+  TimeChangeRule std;
+
+  unsigned long changeTime(const TimeChangeRule &rule, int offsetBefore, int year);
+
+  public:
+    TimeZone(TimeChangeRule dstStart, TimeChangeRule stdStart);
+
+    //True if daylight saving time is in effect at 'utc'.
+    bool isDST(unsigned long utc);
+    //Local time (seconds since 1970-01-01 local midnight) at 'utc'.
+    unsigned long toLocal(unsigned long utc);
+};
+
+//Calendar helpers, proleptic Gregorian calendar. Days are counted from 1970-01-01.
+long daysFromCivil(int year, uint8_t month, uint8_t day);
+void civilFromDays(long days, int &year, uint8_t &month, uint8_t &day);
+//1 = Sunday ... 7 = Saturday.
+uint8_t dayOfWeek(long days);
+
+#endif  /* TimeZone_H_ */
@@ -0,0 +1,150 @@
+#include "TrendChart.h"
+#include <string.h>
+
+TrendChart::TrendChart(SeeedGrayOLED &display, History &history, const TrendSeries *series, uint8_t count)
+  : display(display), history(history) {
+  this->series = series;
+  this->count = count < TREND_SERIES_MAX ? count : TREND_SERIES_MAX;
+  joined = false;
+  drawn = 0;
+  valid = false;
+  ranged = false;
+  redrawCount = 0;
+}
+
+bool TrendChart::draw() {
+  unsigned long samples = history.count();
+  if (valid == true && samples == drawn) {
+    return false;
+  }
+
+  //One new sample inside the ranges: two columns. Anything else: the whole chart.
+  if (valid == true && ranged == true && samples == drawn + 1) {
+    const int16_t *row = history.minuteTier.newest();
+    bool fits = true;
+    for (uint8_t i = 0; i < count; i++) {
+      int16_t value = series[i].value(row);
+      if (value < low[i] || value > high[i]) {
+        fits = false;
+      }
+    }
+    if (fits == true) {
+      drawColumn((samples - 1) % TREND_WIDTH, row);
+      drawn = samples;
+      return false;
+    }
+  }
+  redraw(samples);
+  return true;
+}
+
+void TrendChart::invalidate() {
+  valid = false;
+}
+
+bool TrendChart::range(uint8_t index, int16_t &bottom, int16_t &top) {
+  if (ranged == false || index >= count) {
+    return false;
+  }
+  bottom = low[index];
+  top = high[index];
+  return true;
+}
+
+uint16_t TrendChart::redraws() {
+  return redrawCount;
+}
+
+//Range around the samples: at least minSpan, then a quarter more at both ends so that small moves stay inside.
+void TrendChart::setRange(uint8_t index, long lowest, long highest) {
+  long span = highest - lowest;
+  if (span < series[index].minSpan) {
+    lowest -= (series[index].minSpan - span) / 2;
+    highest = lowest + series[index].minSpan;
+  }
+  long margin = (highest - lowest) / 4;
+  lowest -= margin;
+  highest += margin;
+  low[index] = lowest < -32768 ? -32768 : lowest;
+  high[index] = highest > 32767 ? 32767 : highest;
+}
+
+//Display RAM bytes of one strip column: bit y of 'pixels' is pixel row y from the top.
+void TrendChart::writeColumn(uint8_t page, uint8_t x, uint32_t pixels) {
+  for (uint8_t i = 0; i < TREND_PAGES; i++) {
+    display.setTextXY(page + i, x);
+    display.sendData(pixels >> (i * 8));
+  }
+}
+
+void TrendChart::drawColumn(uint8_t x, const int16_t *row) {
+  uint8_t gap = (x + 1) % TREND_WIDTH;
+  for (uint8_t i = 0; i < count; i++) {
+    long value = series[i].value(row);
+    long y = (high[i] - value) * (TREND_HEIGHT - 1) / (high[i] > low[i] ? high[i] - low[i] : 1);
+    y = y < 0 ? 0 : (y > TREND_HEIGHT - 1 ? TREND_HEIGHT - 1 : y);
+
+    //Join to the sample before with a vertical line, so steps stay visible.
+    uint8_t from = joined == true ? lastY[i] : y;
+    uint8_t top = from < y ? from : y;
+    uint8_t bottom = from < y ? y : from;
+    uint32_t pixels = ((2UL << bottom) - 1) & ~((1UL << top) - 1);
+    writeColumn(series[i].page, x, pixels);
+    writeColumn(series[i].page, gap, 0);
+    lastY[i] = y;
+  }
+  joined = true;
+}
+
+void TrendChart::redraw(unsigned long samples) {
+  redrawCount++;
+  HistoryTier &tier = history.minuteTier;
+  uint16_t rows = tier.rows();
+  uint16_t skip = rows > TREND_WIDTH - 1 ? rows - (TREND_WIDTH - 1) : 0;      //One column is left as the gap.
+  HistoryCursor cursor;
+
+  //Ranges from the samples that will be shown.
+  long lowest[TREND_SERIES_MAX];
+  long highest[TREND_SERIES_MAX];
+  for (uint8_t i = 0; i < count; i++) {
+    lowest[i] = 32767;
+    highest[i] = -32768;
+  }
+  tier.rewind(cursor);
+  for (uint16_t n = 0; tier.next(cursor) == true; n++) {
+    if (n < skip) {
+      continue;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+      int16_t value = series[i].value(cursor.values);
+      lowest[i] = value < lowest[i] ? value : lowest[i];
+      highest[i] = value > highest[i] ? value : highest[i];
+    }
+  }
+  ranged = rows > 0;
+  for (uint8_t i = 0; i < count && ranged == true; i++) {
+    setRange(i, lowest[i], highest[i]);
+  }
+
+  //Clear the strips, then draw the samples oldest first.
+  unsigned char blank[16];
+  memset(blank, 0, sizeof(blank));
+  for (uint8_t i = 0; i < count; i++) {
+    for (uint8_t page = 0; page < TREND_PAGES; page++) {
+      display.setTextXY(series[i].page + page, 0);
+      for (uint8_t x = 0; x < TREND_WIDTH; x += sizeof(blank)) {
+        display.sendDataBurst(blank, sizeof(blank));
+      }
+    }
+  }
+  joined = false;
+  tier.rewind(cursor);
+  for (uint16_t n = 0; tier.next(cursor) == true; n++) {
+    if (n >= skip) {
+      drawColumn((samples - rows + n) % TREND_WIDTH, cursor.values);
+    }
+  }
+
+  drawn = samples;
+  valid = true;
+}
@@ -0,0 +1,73 @@
+#ifndef TrendChart_H_
+#define TrendChart_H_
+#include "Arduino.h"
+#include "SeeedGrayOLED.h"
+#include "History.h"
+/*------------------------------------------------------//
+  Strip charts of sensor history on the OLED display.
+
+  Each series is a strip TREND_PAGES pages (8 pixel rows each) high and the
+  width of the display, one column per minute sample in the history. The
+  chart sweeps: sample n goes in column n % TREND_WIDTH and the column after
+  it is blanked, so the gap marks where the next sample comes. Each new
+  sample draws two columns. Nothing else is drawn again.
+
+  The SH1107G has no horizontal scroll (only the SSD1327 does), so the
+  chart does not move existing columns. A moving chart would rewrite every
+  column of every strip on every sample.
+
+  The range of each strip fits the samples shown, with a margin. A sample
+  outside the range redraws the whole chart from the minute tier of the
+  history with a new range, and so does invalidate(). The minute tier may
+  hold fewer samples than the chart is wide. After a redraw, columns older
+  than the tier stay empty until new samples fill them.
+*/
+
+#define TREND_WIDTH 128
+#define TREND_PAGES 3
+#define TREND_HEIGHT (TREND_PAGES * 8)
+#define TREND_SERIES_MAX 4
+
+typedef int16_t (*TrendValue)(const int16_t *row);
+
+struct TrendSeries {
+  uint8_t page;                     //Top page of the strip.
+  TrendValue value;                 //Value of the series in a history row.
+  int16_t minSpan;                  //Smallest range, so that noise does not fill the strip.
+};
+
+class TrendChart {
+
+  SeeedGrayOLED &display;
+  History &history;
+  const TrendSeries *series;
+  uint8_t count;
+  int16_t low[TREND_SERIES_MAX];    //Range of each strip, bottom and top row.
+  int16_t high[TREND_SERIES_MAX];
+  uint8_t lastY[TREND_SERIES_MAX];  //Row of the sample drawn last, the next one is joined to it.
+  bool joined;                      //lastY holds the column before.
+  unsigned long drawn;              //history.count() when the chart was last brought up to date.
+  bool valid;
+  bool ranged;                      //Ranges come from at least one sample.
+  uint16_t redrawCount;
+
+  void setRange(uint8_t index, long lowest, long highest);
+  void drawColumn(uint8_t x, const int16_t *row);
+  void writeColumn(uint8_t page, uint8_t x, uint32_t pixels);
+  void redraw(unsigned long samples);
+
+  public:
+    TrendChart(SeeedGrayOLED &display, History &history, const TrendSeries *series, uint8_t count);
+
+    //Draw what history has added since the last call. Returns true if the whole chart was drawn.
+    bool draw();
+    //The display was cleared: the next draw() draws the whole chart.
+    void invalidate();
+
+    //Range of strip 'index'. False while history is empty.
+    bool range(uint8_t index, int16_t &bottom, int16_t &top);
+    //Whole chart redraws, for tuning.
+    uint16_t redraws();
+};
+
+#endif  /* TrendChart_H_ */
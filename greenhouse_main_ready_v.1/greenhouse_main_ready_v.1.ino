@@ -8,11 +8,28 @@
 #include "DHT.h"
 #include "SI114X.h"
 #include "MoistureSensor.h"
+#include "Scheduler.h"
+#include "EventQueue.h"
+#include "PulseTimer.h"
+#include "RtcClock.h"
+#include "SntpClient.h"
+#include "TimeZone.h"
+#include "History.h"
+#include "Telemetry.h"
+#include "Screen.h"
+#include "TrendChart.h"
+#include "SensorCache.h"
+#include "SensorHealth.h"
+#include "SensorAggregate.h"
+#include "Irrigation.h"
+#include <limits.h>
 #include <SPI.h>
 #include <WiFiNINA.h>
 #include <WiFiUdp.h>
 #include "arduino_secrets.h"    //Fill in cridentials (password and username) for connecting to local wifi where greenhouse is placed.
 
+#define ARRAY_COUNT(table) (sizeof(table) / sizeof((table)[0]))   //Entries of a table.
+
 /*
 ****************************************************************
   Pin setup for hardware connected to Arduino UNO base shield.
@@ -31,6 +48,8 @@
 #define resetButton 7
 #define modeButton 2
 
+#define lightSensorInt 8
+
 //Arduino UNO base shield I/O layout.
 /*
   ################### ARDUINO UNO ############################
@@ -58,7 +77,7 @@
   A1:   'EMPTY'                         | 12:   10 kohm resistor parallell with signal wire1 to water tank level switch. Resistor is in series with GND (I/O)   |
   A0:   'EMPTY'                         | 11~:  Signal wire1 to temperature rotary encoder                                                                      |
   D4:   Humidity & Temperature Sensor   | 10~:  Signal wire2 to temperature rotary encoder                                                                      |
-  D8:   'EMPTY'                         |                                                                                                                       |
+  D8:   Sunlight Sensor INT             |                                                                                                                       |
   I2C:  4-Channel Relay                 | All other (unspecified) of its I/O:s are 'EMPTY'.                                                                     |
   D3:   Water Flow Sensor               |                                                                                                                       |
   D7:   SET-Button                      |                                                                                                                       |                                                                                                                      |
@@ -75,7 +94,6 @@
                                         | All I/O:s are 'EMPTY'.                                                                                                |
   ______________________________________|_______________________________________________________________________________________________________________________|
 
-  /*
 *********************
   Global variables.
 *********************/
@@ -89,6 +107,18 @@
 //SOIL MOISTURE.
 const unsigned short MOISTURE_THRESHOLD_LOW = 1000;                  //Set moisture interval values. When measured moisture value (how much water soil contains) is within this interval soil moisture is considered to be OK for plants.
 const unsigned short MOISTURE_THRESHOLD_HIGH = 1200;                 //Same as above but upper threshold for what is considered to be OK soil moisture.
+const unsigned short WATER_DOSE = 100;                                //Set how much water (in milliliters) water pump delivers each time it is activated. Water is measured by the flow sensor.
+const AggregateLimits MOISTURE_AGGREGATE = {1, 3, 10};                //Moisture mean of the probes: min and max dropped, probes more than 3 standard deviations from the median left out. Spread at least 10, about the noise of one probe.
+
+//Irrigation zones, watered one at a time by the water pump. Probes: bit n is moisture probe n (0x36 + n). Valve: relay channel of the zone's valve, 0 when the pump waters the zone without one.
+const IrrigationZone IRRIGATION_ZONES[] = {
+  {"BED", 0x0F, 0, MOISTURE_THRESHOLD_LOW, MOISTURE_THRESHOLD_HIGH, WATER_DOSE}      //All four pots, straight from the water pump.
+};
+//Two beds on an 8-channel relay board, valves on channels 5 and 6 (simulator: --valves).
+//const IrrigationZone IRRIGATION_ZONES[] = {
+//  {"BED1", 0x03, 5, MOISTURE_THRESHOLD_LOW, MOISTURE_THRESHOLD_HIGH, WATER_DOSE},
+//  {"BED2", 0x0C, 6, MOISTURE_THRESHOLD_LOW, MOISTURE_THRESHOLD_HIGH, WATER_DOSE}
+//};
 
 //FAN SPEED CONTROL.
 const unsigned short HUMIDITY_THRESHOLD_VALUE = 60;                 //Set air humidity threshold value (humidity in procentage, value < 100) for when fan should run at low speed. If measured air humidity is lower than specified value fan will run at low speed mode.
@@ -98,42 +128,64 @@ const unsigned short HUMIDITY_THRESHOLD_VALUE = 60;                 //Set air hu
 const unsigned short TEMP_THRESHOLD_VALUE = 28;                     //Set temperature threshold value (°C). If measured temperature is above this specified value a temperature alarm is activated. Value 30 means equal to 30°C.
 //Water flow.
 const unsigned short FLOW_THRESHOLD_VALUE = 250;                    //Variable value specifies the minimum water flow (Liter/hour) required to avoid activating water flow fault.
-const unsigned short CHECK_WATER_FLOW_PERIOD = 1500;                //Set for how long time (in milliseconds) after water pump has been activated (turned ON) before program checks the water flow. IMPORTANT: Value must be above 1000, since it takes 1 sec before water flow value is calculated.
+const unsigned short CHECK_WATER_FLOW_PERIOD = 400;                 //Set for how long time (in milliseconds) after water pump has been activated (turned ON) water flow may take to get above FLOW_THRESHOLD_VALUE. Water pump is stopped if it has not.
+const unsigned short SUPERVISE_WATER_FLOW_PERIOD = 50;              //Set how often (in milliseconds) water flow is checked after that while water pump runs. Water pump is stopped at the first check that finds water flow below FLOW_THRESHOLD_VALUE.
 //LED lighting.
 const unsigned short UV_THRESHOLD_VALUE = 4;                        //Set at which UV-value LED lighting alarm is activated. If UV-value is lower than specified value when LED lighting is ON, an alarm is activated.
 const unsigned short CHECK_LIGHT_FAULT_PERIOD = 3000;               //Set delay time (in milliseconds) after LED lighting has been turned ON, before checking if it works. Program checks if measured light value is above a certain level.
 
 //ALLOWED CLOCK TIME TO RUN.
-//Specify clock time when fan, LED lighting and water pump is allowd to run. Clock time converted to an intiger (700 = 07:00 and 2335 = 23:35).
-unsigned short LIGHT_FAN_START_TIME = 700;                          //Start clock time (after specified time) fan and LED lighting is allowed to be activated (ON).
-unsigned short LIGHT_FAN_STOP_TIME = 2300;                          //Stop clock time (after specified time) for when fan and LED lighting is NOT allowed to be activated and is turned OFF if is currently running.
-unsigned short PUMP_START_TIME = 900;                               //Start clock time (after specified time) water pump is allowed to be activated (ON).
-unsigned short pumpStopTime = 1600;                                 //Stop clock time (after specified time) water pump is NOT allowed to run and is turned OFF.
+//Specify clock time when fan, LED lighting and water pump is allowd to run. Clock time in minutes of the day (CLOCK_TIME(7, 0) = 07:00 and CLOCK_TIME(23, 35) = 23:35).
+//A stop time before the start time makes the window run over midnight, e.g. CLOCK_TIME(22, 0) to CLOCK_TIME(6, 0).
+#define CLOCK_TIME(hour, minute) ((hour) * 60 + (minute))
+unsigned short LIGHT_FAN_START_TIME = CLOCK_TIME(7, 0);             //Start clock time (after specified time) fan and LED lighting is allowed to be activated (ON).
+unsigned short LIGHT_FAN_STOP_TIME = CLOCK_TIME(23, 0);             //Stop clock time (after specified time) for when fan and LED lighting is NOT allowed to be activated and is turned OFF if is currently running.
+unsigned short PUMP_START_TIME = CLOCK_TIME(9, 0);                  //Start clock time (after specified time) water pump is allowed to be activated (ON).
+unsigned short pumpStopTime = CLOCK_TIME(16, 0);                    //Stop clock time (after specified time) water pump is NOT allowed to run and is turned OFF.
 
 //LOOP TIME.
 //Loop time for how often certain readouts and/or motors  be activated.
 const unsigned int CHECK_MOISTURE_PERIOD = 30000;                   //Loop time (in milliseconds) how often soil moisture is being checked and hence water pump is activated (only when soil is too dry).
-const unsigned short WATER_PUMP_TIME_PERIOD = 6000;                 //Set time (in milliseconds) how long water pump will run each time it is activated. Fan speed mode is also checked in same interval as water pump.
+const unsigned short WATER_PUMP_TIME_PERIOD = 12000;                //Set longest time (in milliseconds) water pump may run each time it is activated, even if WATER_DOSE has not been delivered. Twice the time the dose takes at normal water flow.
 const unsigned int CHECK_LIGHT_NEED_PERIOD = 5000;                  //Loop time (in milliseconds) how often ligtht and fan need is being checked. Light need is only checking if current time is in allowed interval meanwhile fan also checks if humidity level is too high.
+const unsigned int READ_SENSORS_PERIOD = 1000;                      //Loop time (in milliseconds) how often sensors are checked for a readout. Each sensor is read when its value is due (see sensorRates).
+const uint8_t LIGHT_ADC_GAIN = SI114X_ADC_GAIN_DIV1;                 //Light sensor ADC gain for visible and IR light. Each step doubles the integration time, for dim light.
+const uint8_t LIGHT_ADC_COUNTER = SI114X_ADC_COUNTER_511ADCCLK;      //Light sensor ADC recovery time, the one that goes with LIGHT_ADC_GAIN (see SI114X::SetALSADC()).
+const unsigned int LIGHT_SAMPLE_TIMEOUT = 100;                       //Time (in milliseconds) a forced light measurement may take before it counts as a missed reading.
+const unsigned int DISPLAY_REFRESH_PERIOD = 200;                    //Loop time (in milliseconds) how often the display is redrawn.
+const unsigned long RELAY_VERIFY_PERIOD = 60000;                    //Loop time (in milliseconds) how often the relay board is read back, and set again if it does not match (e.g. after a power glitch).
+const unsigned long HISTORY_PERIOD = 60000;                         //Loop time (in milliseconds) how often all sensor values are stored in history. History keeps every sample for about the last hour (768 B), and mean/min/max per hour further back.
+
+//CLOCK.
+//Internal clock runs on the RTC and is synced with an NTP-server over wifi now and then. RTC drift is learned from the syncs and corrected, so syncs get rarer as the clock keeps time. Time zone rules give local time, including summer time.
+const unsigned long NTP_SYNC_PERIOD_MIN = 64000;                    //Shortest time (in milliseconds) between clock syncs with NTP-server, used while RTC drift is being learned. A failed sync is retried after 16 s and then doubling up to the current sync period.
+const unsigned long NTP_SYNC_PERIOD_MAX = 14400000;                 //Longest time (in milliseconds, 4 hours) between clock syncs, reached once the clock stays within 20 ms between syncs.
+const unsigned long NTP_SYNC_STALE = 3 * NTP_SYNC_PERIOD_MAX;       //Clock is shown as not in sync when last successful sync is older than this (in milliseconds).
+const unsigned long WIFI_JOIN_TIMEOUT = 15000;                      //Time (in milliseconds) a wifi connection attempt may take before it counts as failed.
+const unsigned long WIFI_RETRY_MIN = 16000;                         //Time (in milliseconds) from a failed wifi connection attempt to the next, doubling after each failure up to WIFI_RETRY_MAX.
+const unsigned long WIFI_RETRY_MAX = 900000;
+TimeChangeRule SUMMER_TIME = {0, 1, 3, 2, 120};                     //Summer time (CEST, UTC+2) starts last (0) Sunday (1) of March (3) at 02:00. Offset to UTC in minutes.
+TimeChangeRule WINTER_TIME = {0, 1, 10, 3, 60};                     //Winter time (CET, UTC+1) starts last (0) Sunday (1) of October (10) at 03:00. Offset to UTC in minutes.
+
+//SERIAL OUTPUT.
+const bool BINARY_TELEMETRY = true;                                 //'true': serial port sends binary telemetry frames with all sensor values and outputs, decode them into CSV with telemetry2csv (folder telemetry/). 'false': readable text log for the Serial Monitor.
+const unsigned int TELEMETRY_PERIOD = 1000;                         //Loop time (in milliseconds) how often values are checked for changes. Changed values are sent right away.
+const unsigned long TELEMETRY_KEEPALIVE = 10000;                    //Time (in milliseconds) after which values are sent even if nothing changed.
+const unsigned short TELEMETRY_DEADBAND = 2;                        //How much (in percent) a sensor value must change to be sent right away. Smaller changes, e.g. sensor noise, are sent with the next frame.
 /*
   .................................................................///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   Oliver Staberg                                                   //
   ALTEN Sweden AB in cooperation with Västsvenska Handelskammaren  //
   Gothenburg, April 2019.                                          //
   ///////////////////////////////////////////////////////////////////
-  /*
 
-  /*
   \\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\
   OTHER GLOBAL VARIABLES BELOW, DO NOT TOUCH! \\
   //////////////////////////////////////////////
 */
 
 //Moisture sensors.
-MoistureSensor moistureSensor1;
-MoistureSensor moistureSensor2;
-MoistureSensor moistureSensor3;
-MoistureSensor moistureSensor4;
+MoistureSensorGroup moistureSensors;       //All moisture sensors, read at the same time.
 int moistureValue1;                       //Individual moisture sensor value for moisture sensor 1.
 int moistureValue2;                       //Individual moisture sensor value for moisture sensor 2.
 int moistureValue3;                       //Individual moisture sensor value for moisture sensor 3.
@@ -147,8 +199,8 @@ bool moistureWet = false;                 //Activates warning message on display
 //Temperature and humidity sensor.
 const uint8_t DHTTYPE = DHT11;            //DHT11 = Arduino UNO model is being used.
 DHT humiditySensor(DHTPIN, DHTTYPE);      //Create humidity sensor from DHT class.
-float tempValue;
-float humidityValue;                      //Air humidity value.
+float tempValue = NAN;                    //Last temperature value that passed the health checks.
+float humidityValue = NAN;                //Air humidity value, last one that passed the health checks.
 bool tempValueFault = false;              //Indicate if read out temperature is higher than temperature treshold that has been set by adjusting temperature rotary encoder. Variable is 'false' when read out temperature is below set temperature threshold.
 const unsigned short TEMP_VALUE_MIN = 12;                    //Temperature value can be set within the boundaries of 12 - 40°C. Temp value is doubled to reduce rotary knob sensitivity. Values are doubled to increase rotary encoder precision.
 const unsigned short TEMP_VALUE_MAX = 40;
@@ -165,7 +217,7 @@ unsigned short tempThresholdValue = TEMP_THRESHOLD_VALUE;              //Startin
 int aLastState;
 
 //Debouncing button press, MODE-button (triggers external interrupt when pressed).
-volatile unsigned long pressTimePrev;     //Variable to store previous millis() value.
+unsigned long pressTimePrev;              //Variable to store previous millis() value.
 unsigned short DEBOUNCE_TIME_INTERRUPT = 170;             //Delay time before interrupt function is started.
 
 //Debouncing button press, SET-button (normal push button).
@@ -176,15 +228,23 @@ SI114X lightSensor = SI114X();            //Light sensor object created.
 uint16_t lightValue;                      //Light readout, unit in lumens.
 uint16_t uvValue;                         //UV-light readout, UN-scale.
 //uint16_t irValue;                       //IR read out not in use.
+bool lightForced = false;                 //A measurement has been asked for and not been read yet.
+unsigned long lightForcedAt;              //millis() when it was asked for.
 
 //LED lighting.
 bool ledLightState = false;               //Indicate current status of LED lighting. Variable is 'true' when LED lighting is turned on.
 bool ledLightFault = false;               //Indicate if LED lighting is not turned on/not working when LED lighting has been turned on.
 
 //Water pump and flow sensor.
-volatile int flowSensorRotations;
+const unsigned short FLOW_PULSES_PER_LITER = 3467;  //Flow sensor pulses for every liter of water pumped.
+PulseTimer flowPulses;                    //Flow sensor pulses, counted from each water pump start.
+unsigned long waterPulsesToday = 0;       //Flow sensor pulses of the water pump runs since local midnight.
+unsigned long waterDay = 0;               //Day of the internal clock waterPulsesToday is counted for.
+unsigned short waterToday = 0;            //Water pumped since local midnight, milliliters.
+unsigned short waterYesterday = 0;        //Water pumped the day before, milliliters.
 unsigned short waterFlowValue = 0;
 bool waterPumpState = false;              //Indicate current status of water pump. Variable is 'true' when water pump is running.
+IrrigationScheduler irrigation(IRRIGATION_ZONES, ARRAY_COUNT(IRRIGATION_ZONES));   //Which zone is dry and which one the water pump waters.
 bool waterFlowFault = false;              //Indicate if water is being pumped when water pump is running. Variable is 'false' when water flow is above threshold value.
 //int FLOW_THRESHOLD_VALUE = 80;              //Variable value specifies the minimum water flow threshold required to avoid setting water flow fault.
 
@@ -192,8 +252,8 @@ bool waterFlowFault = false;              //Indicate if water is being pumped wh
 bool waterLevelFault = false;             //If variable is 'false' water level is OK. If 'true' tank water level is too low.
 
 //Internal clock to keep track of current time.
-int currentClockTime = 0;
-int hourPointer1 = 0;
+volatile unsigned long clockSeconds = 0;  //Local time in seconds, counted by the RTC interrupt. Time of day is clockSeconds % 86400, from NTP it is Unix time in the local time zone.
+int hourPointer1 = 0;                   //Clock pointers are digits of clockSeconds for the display, split by splitClockTime().
 int hourPointer2 = 0;
 int minutePointer1 = 0;                 //1-digit of minute pointer.
 int minutePointer2 = 0;                 //10-digit of minute pointer.
@@ -207,7 +267,6 @@ bool pushButton = false;
 
 bool clockStartMode = false;
 bool clockSetFinished = false;
-unsigned short divider10 = 0;
 unsigned short divider5 = 0;
 bool flashClockPointer = false;         //Variable to create lash clock pointer when in "set clock" mode.
 
@@ -222,10 +281,8 @@ bool setTimeDisplay = false;
 bool readoutValuesDisplay = false;
 bool serviceModeDisplay = false;
 bool flowFaultDisplay = false;
+bool trendChartDisplay = false;
 
-static bool toggle2 = false;
-unsigned short clockTime1 = 0;
-unsigned short clockTime2 = 0;
 /*
   ---------------------
   |Greenhouse program.|
@@ -237,20 +294,15 @@ unsigned short actionRegister;
 //Water pump.
 bool waterPumpEnabled = false;              //Enable/Disable water pump to be activated to pump water.
 //unsigned int CHECK_MOISTURE_PERIOD = 20000;        //Loop time, in milliseconds, for how often water pump is activated based upon measured soil moisture value.
-unsigned long checkMoistureStart = 0;
 //unsigned int CHECK_WATER_FLOW_PERIOD = 1500;
-unsigned long checkWaterFlowStart = 0;
 //unsigned int WATER_PUMP_TIME_PERIOD = 6000;  //Sets the time for how long water pump will run each time it is activated.
-unsigned long waterPumpTimeStart = 0;
 bool waterPumpTimeAllowed = false;          //Is set 'true' when current time is inside time interval where water pump is allowed to be turned ON.
 
 //LED lighting.
 bool ledLightEnabled = false;               //Enable/Disable start of LED lighting.
 //int UV_THRESHOLD_VALUE = 9;                   //UV threshold value for turning LED lighting on/off.
 //const unsigned int CHECK_LIGHT_NEED_PERIOD = 5000;   //Loop time for how often measured light value is checked. This enables/disables start of LED lighting.
-unsigned long checkLightNeedStart = 0;
 //unsigned int CHECK_LIGHT_FAULT_PERIOD = 3000;  //Delay time after LED lighting has been turned ON, before checking if it works.
-unsigned long checkLightFaultStart = 0;
 bool ledLightTimeAllowed = false;           //Is set 'true' when current time is inside time interval where LED lighting is allowed to be turned ON.
 
 //Fan.
@@ -260,25 +312,33 @@ bool fanState = false;
 bool lowFanSpeedEnabled = false;
 unsigned short fanSpeedValue = 0;               //Fan speed readout.
 bool fanTimeAllowed = false;                //Is set 'true' when current time is inside time interval where fan is allowed to be turned ON.
-bool checkFanSpeed = false;                 //Variable is set 'true' when one second has passed. This makes it possible to calculate fan rpm value.
-volatile int fanRotations = 0;
-unsigned long timeNow;
-unsigned long timePrev = 0;
-unsigned long timeDiff;
+PulseTimer fanPulses;                     //Fan speed sensor pulses, two per rotation.
 
 //Set time for when fan, LED lights and water pump is allowd to run.
-//unsigned short LIGHT_FAN_START_TIME = 700;   //Time set as an intiger (700 = 07:00 and 2335 = 23:35).
-//unsigned short LIGHT_FAN_STOP_TIME = 2300;
-//unsigned short PUMP_START_TIME = 800;
-//unsigned short pumpStopTime = 1500;
+//unsigned short LIGHT_FAN_START_TIME = CLOCK_TIME(7, 0);   //Time set in minutes of the day.
+//unsigned short LIGHT_FAN_STOP_TIME = CLOCK_TIME(23, 0);
+//unsigned short PUMP_START_TIME = CLOCK_TIME(8, 0);
+//unsigned short pumpStopTime = CLOCK_TIME(15, 0);
+
+//Task scheduler. Runs the periodic readouts, checks and display updates from loop() when they are due.
+Scheduler scheduler;
+
+//Events pushed by the interrupts and handled in loop(), so that the interrupts only take a few microseconds.
+enum {
+  EVENT_MODE_BUTTON,                      //MODE-button pressed.
+  EVENT_ROTARY_ENCODER,                   //Rotary encoder turned one step, value is +1 or -1.
+  EVENT_LIGHT_SAMPLE                      //Light sensor has a new measurement.
+};
+EventQueue events;
+const unsigned int PULSE_RATE_PERIOD = 250;     //Time (in milliseconds) between updates of fan speed and water flow from the time between sensor pulses.
 
 //Wifi variables to sync internal clock with NTP-server.
 int status = WL_IDLE_STATUS;
 static bool WiFiConnected = true;
-static bool timerInterruptHasSetup = false;
-static unsigned int counterRashid = 0;
-static unsigned int counterWifiDiscounected = 0;
 bool wifiClockCompleted = false;
+bool wifiJoining = false;                 //WiFi.begin() has been sent and the connection is not up yet.
+unsigned long wifiJoinAt;                 //millis() when it was sent.
+unsigned long wifiRetryWait = WIFI_RETRY_MIN;   //Time to the next attempt after a failed one.
 
 //Enter your sensitive data in the Secret tab/arduino_secrets.h.
 char ssid[] = SECRET_SSID;        // your network SSID (name)
@@ -289,149 +349,249 @@ unsigned int localPort = 2390;      // local port to listen for UDP packets
 
 IPAddress timeServer(194, 58, 203, 20); // gbg1.ntp.se NTP server
 
-const int NTP_PACKET_SIZE = 48; // NTP time stamp is in the first 48 bytes of the message
-
-byte packetBuffer[ NTP_PACKET_SIZE]; //buffer to hold incoming and outgoing packets
-
 // A UDP instance to let us send and receive packets over UDP
 WiFiUDP Udp;
 
+//Internal UTC clock, ticked by the RTC interrupt and corrected by NTP. Clock pointers show it in local time.
+RtcClock rtcClock;
+uint64_t rtcClockNow() {
+  return rtcClock.now();
+}
+const int64_t NTP_GOOD_OFFSET = (20LL << 32) / 1000;        //20 ms in NTP time (seconds * 2^32). Time between syncs is doubled while offsets stay below this and halved when they are 4 times larger.
+unsigned long ntpSyncPeriod = NTP_SYNC_PERIOD_MIN;
+unsigned long lastSyncTime;                                 //rtcClock Unix time at last sync.
+bool clockSynced = false;                                   //Set 'true' at the first sync, from then drift is estimated.
+
+SntpClient ntpClient(Udp, timeServer, rtcClockNow, NTP_SYNC_PERIOD_MIN);   //Asks NTP-server for the time without waiting for the answer.
+TimeZone localTimeZone(SUMMER_TIME, WINTER_TIME);         //Converts NTP time (UTC) to local time.
+
+//Serial output. Text log goes to 'console', which drops it when the port carries binary telemetry.
+Telemetry telemetry(Serial, TELEMETRY_KEEPALIVE, TELEMETRY_DEADBAND);
+NullPrint noConsole;
+Print &console = BINARY_TELEMETRY == true ? (Print &)noConsole : (Print &)Serial;
+
+//Screen modes are layout tables (see viewReadoutValues() and on), only fields that changed are redrawn.
+ScreenRenderer screen(SeeedGrayOled);
+
+//Sensor history, one sample of every channel per minute. Temperature and humidity are stored in tenths.
+enum HistoryChannel {
+  HISTORY_MOISTURE1,
+  HISTORY_MOISTURE2,
+  HISTORY_MOISTURE3,
+  HISTORY_MOISTURE4,
+  HISTORY_TEMPERATURE,
+  HISTORY_HUMIDITY,
+  HISTORY_LIGHT,
+  HISTORY_UV,
+  HISTORY_WATER_FLOW,
+  HISTORY_FAN_SPEED
+};
+History history;
+int16_t historySample[HISTORY_CHANNELS];                  //Last stored sample, kept for channels that have no valid readout.
+
+//Trend chart display mode: moisture, temperature and humidity from the minute history, one strip each.
+int16_t moistureTrend(const int16_t *row) {
+  return aggregate(row + HISTORY_MOISTURE1, 4, MOISTURE_AGGREGATE).mean;
+}
+
+int16_t temperatureTrend(const int16_t *row) {
+  return row[HISTORY_TEMPERATURE];
+}
+
+int16_t humidityTrend(const int16_t *row) {
+  return row[HISTORY_HUMIDITY];
+}
+
+const TrendSeries trendSeries[] = {
+  {2, moistureTrend, 40},                                 //Strip on pages 2-4, at least 40 units high.
+  {7, temperatureTrend, 20},                              //Tenths, at least 2 *C.
+  {12, humidityTrend, 50}                                 //Tenths, at least 5 %.
+};
+const int TREND_LABEL_DIVISOR[] = {1, 10, 10};            //Range labels in whole units.
+TrendChart trendChart(SeeedGrayOled, history, trendSeries, ARRAY_COUNT(trendSeries));
+int trendTop[ARRAY_COUNT(trendSeries)];                  //Range of each strip as printed next to it.
+int trendBottom[ARRAY_COUNT(trendSeries)];
+
+//Sensor readouts and how often each sensor is read. Sensors are read at the fastest rate while their value moves or is near a threshold, and less and less often while it is stable.
+enum SensorChannel {
+  SENSOR_MOISTURE1,
+  SENSOR_MOISTURE2,
+  SENSOR_MOISTURE3,
+  SENSOR_MOISTURE4,
+  SENSOR_TEMPERATURE,                                     //Tenths of a degree.
+  SENSOR_HUMIDITY,                                        //Tenths of a percent.
+  SENSOR_LIGHT,
+  SENSOR_UV
+};
+
+//Nearest threshold of any zone, a probe is not told apart by its zone here.
+long moistureDistance(long value) {
+  long nearest = LONG_MAX;
+  for (uint8_t i = 0; i < ARRAY_COUNT(IRRIGATION_ZONES); i++) {
+    long low = labs(value - IRRIGATION_ZONES[i].dryBelow);
+    long high = labs(value - IRRIGATION_ZONES[i].wetAbove);
+    nearest = low < nearest ? low : nearest;
+    nearest = high < nearest ? high : nearest;
+  }
+  return nearest;
+}
+
+long temperatureDistance(long value) {
+  long high = labs(value - tempThresholdValue * 10L);
+  long low = labs(value - TEMP_VALUE_MIN * 10L);
+  return low < high ? low : high;
+}
+
+long humidityDistance(long value) {
+  return labs(value - HUMIDITY_THRESHOLD_VALUE * 10L);
+}
+
+//The UV threshold only matters while LED lighting is on.
+long uvDistance(long value) {
+  return ledLightState == true ? labs(value - UV_THRESHOLD_VALUE) : LONG_MAX;
+}
+
+const SensorRate sensorRates[] = {
+  {5000, 60000, 120000, 10, 10, moistureDistance},        //Moisture sensors, noise is about 4.
+  {5000, 60000, 120000, 10, 10, moistureDistance},
+  {5000, 60000, 120000, 10, 10, moistureDistance},
+  {5000, 60000, 120000, 10, 10, moistureDistance},
+  {DHT_MIN_INTERVAL, 60000, 120000, 10, 5, temperatureDistance},       //The DHT-sensor is read at most every 2 seconds, DHT11 gives whole degrees.
+  {DHT_MIN_INTERVAL, 60000, 120000, 10, 20, humidityDistance},
+  {1000, 60000, 120000, 50, 0, 0},
+  {1000, 60000, 120000, 5, 3, uvDistance}
+};
+SensorCache sensors(sensorRates, ARRAY_COUNT(sensorRates));
+
+//Health checks of every reading, same channels. Readings outside the range or with too large a step are rejected before they are used, channels that are stuck, noisy or dead are left out of control decisions and shown as alarms.
+const SensorLimits sensorLimits[] = {
+  {200, 2000, 200, 25, 20, 3},                            //Moisture sensors, a sensor that does not answer reads 65535.
+  {200, 2000, 200, 25, 20, 3},
+  {200, 2000, 200, 25, 20, 3},
+  {200, 2000, 200, 25, 20, 3},
+  {-200, 600, 50, 30, 0, 3},                              //Temperature, tenths. DHT11 repeats whole degrees for long, so no stuck check.
+  {0, 1000, 200, 50, 0, 3},                               //Humidity, tenths.
+  {0, 65000, 0, 0, 0, 3},                                 //Light changes in steps when LED lighting switches and is steady at night.
+  {0, 1500, 0, 0, 0, 3}                                   //UV index * 100.
+};
+SensorHealth sensorHealth(sensorLimits, ARRAY_COUNT(sensorLimits));
+const char *const SENSOR_NAMES[] = {"M1", "M2", "M3", "M4", "TEMP", "HUM", "LIGHT", "UV"};    //Names in sensor alarms, at most 5 characters.
+
+//Store a reading that passes the health checks. Returns false if it was rejected.
+bool storeReading(uint8_t channel, long value) {
+  if (sensorHealth.check(channel, value) == false) {
+    sensors.missed(channel);                    //Try again soon, a bad sensor is not read at full speed.
+    return false;
+  }
+  sensors.store(channel, value);
+  return true;
+}
+
+//Channel could not be read at all.
+void failReading(uint8_t channel) {
+  sensorHealth.fail(channel);
+  sensors.missed(channel);
+}
+
+//Channel may be used for control decisions: healthy and recently read.
+bool sensorUsable(uint8_t channel) {
+  return sensorHealth.healthy(channel) == true && sensors.fresh(channel) == true;
+}
+
 /*
   ============================================================
   || Bitmap image to be printed on OLED display at startup. ||
   ============================================================ */
+//greenhouse.pbm, 128 x 128 pixels: 1381 bytes packed from 2048 (bitmap/pbm2rle).
 const unsigned char greenhouse[] PROGMEM = {
-  /*
-    //Startup image.
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x01, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0, 0x00, 0x00, 0x07, 0xC0,
-    0x00, 0x03, 0xE1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x10, 0x00, 0x00, 0x04, 0xA0,
-    0x00, 0x06, 0x21, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x10, 0x00, 0x00, 0x04, 0xA0,
-    0x00, 0x0C, 0x21, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x10, 0x40, 0x00, 0x03, 0x00,
-    0x00, 0x08, 0x21, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x01, 0xFC, 0x7C, 0x00, 0x04, 0x00,
-    0x00, 0x08, 0x21, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x07, 0x80,
-    0x00, 0x04, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xC0, 0xF0, 0x38, 0x00, 0x07, 0x80,
-    0x00, 0x06, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x21, 0x00, 0x44, 0x00, 0x00, 0x80,
-    0x00, 0x03, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x01, 0x00, 0x44, 0x00, 0x00, 0x80,
-    0x00, 0x00, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x38, 0x00, 0x07, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x07, 0x81, 0x00, 0x00, 0x00, 0x03, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1E, 0x00, 0x0A, 0x81, 0x00, 0x08, 0x00, 0x04, 0x80,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x81, 0x00, 0x54, 0x00, 0x04, 0x80,
-    0x00, 0x00, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x01, 0x01, 0xF0, 0x24, 0x00, 0x1F, 0x80,
-    0x00, 0x0C, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x80,
-    0x00, 0x0C, 0x31, 0x80, 0x00, 0x00, 0x00, 0x12, 0x00, 0x7F, 0x81, 0xF0, 0x3C, 0x00, 0x04, 0x00,
-    0x00, 0x0C, 0x61, 0x80, 0x00, 0x00, 0x00, 0x0C, 0x08, 0x00, 0x00, 0x10, 0x40, 0x00, 0x04, 0x00,
-    0x00, 0x0C, 0x61, 0x80, 0x00, 0x00, 0x00, 0x04, 0x0F, 0x07, 0x00, 0x10, 0x40, 0x00, 0x07, 0x80,
-    0x00, 0x07, 0xC1, 0x80, 0x00, 0x00, 0x00, 0x1A, 0x06, 0x08, 0x81, 0xE0, 0x7C, 0x00, 0x03, 0x00,
-    0x00, 0x03, 0x81, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x09, 0x08, 0x80, 0x00, 0x00, 0x00, 0x05, 0x80,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x08, 0x83, 0x00, 0x34, 0x00, 0x05, 0x80,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0E, 0x09, 0x0F, 0xE4, 0x80, 0x54, 0x00, 0x03, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x06, 0x00, 0x04, 0x80, 0x54, 0x00, 0x07, 0x80,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1E, 0x0A, 0x09, 0x07, 0xF0, 0x38, 0x00, 0x04, 0x00,
-    0x00, 0x0F, 0xFF, 0x8F, 0xF8, 0x00, 0x00, 0x00, 0x0D, 0x0A, 0x80, 0x00, 0x00, 0x00, 0x1F, 0x80,
-    0x00, 0x0F, 0xFF, 0x80, 0x30, 0x00, 0x00, 0x0A, 0x05, 0x04, 0x80, 0x00, 0x18, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x02, 0x00, 0xC0, 0x00, 0x00, 0x1A, 0x07, 0x00, 0x00, 0x01, 0x24, 0x00, 0x04, 0x80,
-    0x00, 0x00, 0x01, 0x03, 0x00, 0x00, 0x00, 0x1A, 0x08, 0x2F, 0x81, 0x00, 0xC4, 0x00, 0x0F, 0x00,
-    0x00, 0x00, 0x01, 0x86, 0x00, 0x00, 0x00, 0x0C, 0x08, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00,
-    0x00, 0x00, 0x01, 0x8F, 0xF8, 0x00, 0x00, 0x0C, 0x0F, 0x0E, 0x01, 0xF0, 0x00, 0x00, 0x04, 0x80,
-    0x00, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 0x4A, 0x00, 0x11, 0x00, 0x00, 0x00, 0x00, 0x04, 0x80,
-    0x00, 0x00, 0x03, 0x00, 0x08, 0x00, 0x00, 0x52, 0x05, 0x20, 0x80, 0xD0, 0x70, 0x00, 0x03, 0x00,
-    0x00, 0x0F, 0xFF, 0x08, 0x88, 0x00, 0x00, 0x22, 0x0D, 0x20, 0x81, 0x50, 0x0C, 0x00, 0x03, 0x80,
-    0x00, 0x0F, 0xFC, 0x08, 0x88, 0x00, 0x00, 0x00, 0x06, 0x20, 0x81, 0x50, 0x32, 0x00, 0x0A, 0x80,
-    0x00, 0x00, 0x00, 0x08, 0x88, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x80, 0xE0, 0x40, 0x00, 0x08, 0x80,
-    0x00, 0x00, 0x00, 0x0F, 0xF8, 0x00, 0x00, 0x12, 0x26, 0x00, 0x00, 0x00, 0x44, 0x00, 0x07, 0x00,
-    0x00, 0x01, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x3C, 0x29, 0x00, 0x01, 0x10, 0xFC, 0x00, 0x00, 0x00,
-    0x00, 0x1F, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x03, 0xF0, 0x40, 0x00, 0x00, 0x00,
-    0x00, 0x1F, 0xFE, 0x08, 0x00, 0x00, 0x00, 0x0E, 0x00, 0x0E, 0x01, 0x00, 0x00, 0x00, 0x00, 0xC0,
-    0x00, 0x1F, 0xFF, 0x08, 0x00, 0x00, 0x00, 0x10, 0x00, 0x11, 0x00, 0xF1, 0x7C, 0x00, 0x00, 0x00,
-    0x00, 0x0F, 0xFF, 0x0F, 0xF8, 0x00, 0x00, 0x7E, 0x00, 0x20, 0x81, 0x50, 0x00, 0x00, 0x0F, 0x00,
-    0x00, 0x0F, 0xDF, 0x88, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x20, 0x81, 0x51, 0xFC, 0x00, 0x09, 0x80,
-    0x00, 0x07, 0xEF, 0x88, 0x00, 0x00, 0x00, 0x1F, 0x04, 0x20, 0x80, 0x30, 0x44, 0x00, 0x0E, 0x80,
-    0x00, 0x07, 0xF7, 0x88, 0x08, 0x00, 0x00, 0x12, 0x8D, 0x3F, 0x80, 0x00, 0x44, 0x10, 0x00, 0x00,
-    0x00, 0x03, 0xFB, 0x80, 0x08, 0x00, 0x00, 0x12, 0x8D, 0x00, 0x07, 0x80, 0x38, 0x1E, 0x0F, 0x80,
-    0x00, 0x03, 0xFD, 0x80, 0x08, 0x00, 0x00, 0x0C, 0x06, 0x24, 0x80, 0x70, 0x00, 0x00, 0x08, 0x00,
-    0x00, 0x01, 0xFE, 0xC0, 0x08, 0x00, 0x00, 0x00, 0x08, 0x24, 0x80, 0xF1, 0x7C, 0x0C, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0x1F, 0xF8, 0x00, 0x00, 0x5E, 0x06, 0x24, 0x87, 0x00, 0x00, 0x12, 0x0F, 0x00,
-    0x00, 0x00, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x3F, 0x83, 0xC0, 0x3C, 0x12, 0x08, 0x80,
-    0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x02, 0x0C, 0x00, 0x00, 0x70, 0x40, 0x0C, 0x07, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x70, 0x00, 0x00, 0x02, 0x04, 0x00, 0x81, 0xE0, 0x40, 0x04, 0x00, 0x00,
-    0x00, 0x01, 0xFF, 0x83, 0xC0, 0x02, 0xC0, 0x7E, 0x0D, 0x00, 0x86, 0x00, 0x3C, 0x1A, 0x0E, 0x80,
-    0x00, 0x07, 0xFF, 0x8C, 0x40, 0x03, 0x40, 0x00, 0x0D, 0x00, 0x80, 0x00, 0x40, 0x0A, 0x09, 0x80,
-    0x00, 0x06, 0x00, 0x0E, 0x40, 0x01, 0x80, 0x00, 0x06, 0x3F, 0x80, 0x00, 0x40, 0x00, 0x08, 0x80,
-    0x00, 0x0C, 0x00, 0x01, 0xE0, 0x02, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x0E, 0x00, 0x00,
-    0x00, 0x0C, 0x00, 0x00, 0x38, 0x02, 0xC0, 0x00, 0x01, 0x1F, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
-    0x00, 0x0C, 0x00, 0x00, 0x00, 0x01, 0x80, 0x00, 0x01, 0x31, 0x01, 0x00, 0x7C, 0x1E, 0x1F, 0x80,
-    0x00, 0x04, 0x00, 0x00, 0x00, 0x02, 0x00, 0xF8, 0x3F, 0x20, 0x81, 0xF0, 0x04, 0x00, 0x00, 0x00,
-    0x00, 0x04, 0x00, 0x03, 0x00, 0x03, 0xC1, 0x04, 0x00, 0x20, 0x80, 0x00, 0x04, 0x0A, 0x0F, 0x80,
-    0x00, 0x03, 0x00, 0x00, 0xC0, 0x00, 0x02, 0x02, 0x00, 0x11, 0x00, 0xE0, 0x78, 0x1A, 0x04, 0x00,
-    0x01, 0xFF, 0xFF, 0x83, 0xA0, 0x03, 0xC2, 0x02, 0x08, 0x0E, 0x01, 0x10, 0x00, 0x1A, 0x07, 0x80,
-    0x01, 0xFF, 0xFF, 0x81, 0x80, 0x00, 0x42, 0x02, 0x0F, 0x00, 0x01, 0x11, 0xFC, 0x0C, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x02, 0x40, 0x03, 0xC1, 0x8C, 0x00, 0x00, 0x00, 0xE0, 0x20, 0x14, 0x07, 0x80,
-    0x00, 0x00, 0x00, 0x02, 0x40, 0x00, 0x00, 0x78, 0x05, 0x00, 0x00, 0x00, 0x20, 0x1A, 0x04, 0x80,
-    0x00, 0x00, 0x00, 0x0F, 0xC0, 0x02, 0x40, 0x00, 0x0D, 0x00, 0x01, 0x60, 0x20, 0x0A, 0x07, 0xE0,
-    0x00, 0x01, 0xFF, 0x80, 0x00, 0x07, 0x83, 0xFE, 0x06, 0x00, 0x01, 0x51, 0xFC, 0x00, 0x00, 0x00,
-    0x00, 0x07, 0xFF, 0x80, 0x00, 0x01, 0xC0, 0x0C, 0x00, 0x04, 0x00, 0x90, 0x00, 0x00, 0x01, 0x80,
-    0x00, 0x06, 0x00, 0x0F, 0xC0, 0x03, 0x40, 0x18, 0x09, 0x07, 0x80, 0x00, 0x00, 0x08, 0x0F, 0x00,
-    0x00, 0x0C, 0x00, 0x02, 0x40, 0x02, 0xC0, 0x60, 0x1E, 0x03, 0x00, 0xF0, 0x00, 0x1A, 0x0F, 0x00,
-    0x00, 0x0C, 0x00, 0x02, 0x40, 0x01, 0x80, 0xC0, 0x07, 0x04, 0x81, 0x00, 0x00, 0x1A, 0x01, 0x80,
-    0x00, 0x0C, 0x00, 0x01, 0xC0, 0x02, 0xC3, 0x80, 0x0D, 0x04, 0x81, 0x00, 0x00, 0x0C, 0x00, 0x00,
-    0x00, 0x04, 0x00, 0x01, 0x80, 0x02, 0xC3, 0xFE, 0x0D, 0x03, 0x01, 0xF0, 0x7E, 0x10, 0x00, 0x00,
-    0x00, 0x04, 0x00, 0x02, 0xC0, 0x01, 0x80, 0x00, 0x02, 0x01, 0x00, 0xC0, 0x45, 0x1E, 0x00, 0x00,
-    0x00, 0x03, 0x00, 0x02, 0xC0, 0x0A, 0x00, 0x00, 0x30, 0x04, 0x81, 0x50, 0x45, 0x00, 0x00, 0x00,
-    0x00, 0x0F, 0xFF, 0x81, 0x80, 0x07, 0xC3, 0xFC, 0x07, 0x06, 0x81, 0x50, 0x38, 0x1E, 0x00, 0x00,
-    0x00, 0x0F, 0xFF, 0x81, 0xC0, 0x00, 0x00, 0x06, 0x0E, 0x00, 0x00, 0x50, 0x00, 0x02, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x38, 0x03, 0x80, 0xE0, 0x3C, 0x02, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x07, 0x04, 0x00, 0x60, 0x40, 0x1C, 0x00, 0x00,
-    0x00, 0x00, 0xE0, 0x03, 0xC0, 0x00, 0x00, 0x04, 0x0E, 0x04, 0x04, 0x90, 0x40, 0x12, 0x00, 0x00,
-    0x00, 0x03, 0xE1, 0x03, 0xE0, 0x00, 0x03, 0xF8, 0x30, 0x07, 0x84, 0x90, 0x40, 0x3E, 0x00, 0x00,
-    0x00, 0x06, 0x21, 0x82, 0x50, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x10, 0x7C, 0x00, 0x00, 0x00,
-    0x00, 0x04, 0x21, 0x82, 0x50, 0x00, 0x00, 0x00, 0x00, 0x06, 0x80, 0x00, 0x00, 0x1E, 0x00, 0x00,
-    0x00, 0x0C, 0x21, 0x81, 0x80, 0x00, 0x00, 0x00, 0x00, 0x06, 0x80, 0x01, 0x7C, 0x1A, 0x00, 0x00,
-    0x00, 0x08, 0x21, 0x87, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0x00, 0x00, 0x16, 0x00, 0x00,
-    0x00, 0x0C, 0x21, 0x80, 0x00, 0x00, 0x00, 0x3C, 0x00, 0x03, 0x00, 0x60, 0x44, 0x00, 0x00, 0x00,
-    0x00, 0x04, 0x21, 0x02, 0xC0, 0x00, 0x00, 0x42, 0x0F, 0x12, 0x80, 0x70, 0xFC, 0x10, 0x00, 0x00,
-    0x00, 0x06, 0x27, 0x03, 0x40, 0x00, 0x00, 0x42, 0x10, 0x14, 0x81, 0xC0, 0x40, 0x1E, 0x00, 0x00,
-    0x00, 0x03, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x42, 0x10, 0x08, 0x80, 0x60, 0x00, 0x08, 0x00, 0x00,
-    0x00, 0x00, 0xF8, 0x03, 0xC0, 0x00, 0x00, 0x3C, 0x1F, 0x00, 0x00, 0x70, 0x3C, 0x1A, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x02, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x40, 0x1A, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x01, 0xC0, 0x00, 0x00, 0x00, 0x0F, 0x02, 0x00, 0xE0, 0x40, 0x0C, 0x00, 0x00,
-    0x00, 0x01, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x3E, 0x15, 0x06, 0x81, 0x13, 0xFC, 0x00, 0x00, 0x00,
-    0x00, 0x03, 0xE1, 0x0F, 0xC0, 0x00, 0x00, 0x40, 0x13, 0x06, 0x81, 0x10, 0x00, 0x0C, 0x00, 0x00,
-    0x00, 0x06, 0x21, 0x82, 0x40, 0x00, 0x00, 0x40, 0x00, 0x03, 0x01, 0x10, 0x7E, 0x12, 0x00, 0x00,
-    0x00, 0x0C, 0x21, 0x83, 0xC0, 0x00, 0x00, 0x20, 0x48, 0x04, 0x00, 0xE0, 0x45, 0x12, 0x00, 0x00,
-    0x00, 0x08, 0x21, 0x80, 0x00, 0x00, 0x00, 0x7E, 0x48, 0x07, 0x80, 0x00, 0x45, 0x1F, 0x80, 0x00,
-    0x00, 0x08, 0x21, 0x80, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x00, 0x07, 0xF0, 0x45, 0x0E, 0x00, 0x00,
-    0x00, 0x04, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x80, 0x00, 0x38, 0x10, 0x00, 0x00,
-    0x00, 0x06, 0x23, 0x00, 0x00, 0x00, 0x02, 0x7E, 0x00, 0x00, 0x84, 0x80, 0x00, 0x10, 0x00, 0x00,
-    0x00, 0x03, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x84, 0x81, 0x7C, 0x0E, 0x00, 0x00,
-    0x00, 0x00, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x7E, 0x10, 0x07, 0x07, 0xF0, 0x00, 0x10, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x1F, 0x04, 0x80, 0x00, 0x04, 0x1E, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x0F, 0x80, 0x00, 0x04, 0x00, 0x00, 0x00,
-    0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x5F, 0x00, 0x00, 0x00, 0x04, 0x0A, 0x00, 0x00,
-    0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x01, 0x01, 0x01, 0x01, 0xFC, 0x1A, 0x00, 0x00,
-    0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x06, 0x81, 0xF0, 0x00, 0x1A, 0x00, 0x00,
-    0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x02, 0x80, 0x00, 0x00, 0x4C, 0x00, 0x00,
-    0x00, 0x0F, 0xFF, 0x80, 0x00, 0x00, 0x03, 0xFE, 0x74, 0x00, 0x00, 0xD0, 0x00, 0x40, 0x00, 0x00,
-    0x00, 0x0F, 0xFF, 0x80, 0x00, 0x00, 0x00, 0x64, 0x0E, 0x17, 0x81, 0x50, 0x70, 0x7E, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x42, 0x01, 0x03, 0x01, 0x50, 0x88, 0x40, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x42, 0x00, 0x04, 0x80, 0xE1, 0x04, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3C, 0x00, 0x04, 0x81, 0x11, 0x04, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x03, 0xF1, 0x04, 0x00, 0x00, 0x00,
-    0x00, 0xC0, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x01, 0x01, 0xFC, 0x00, 0x00, 0x00,
-    0x00, 0xC0, 0xC1, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0xC0, 0xC1, 0x80, 0x00, 0x00, 0x00, 0x7E, 0x00, 0x1C, 0x00, 0xF1, 0x24, 0x00, 0x00, 0x00,
-    0x00, 0xC0, 0xC1, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0x51, 0x24, 0x00, 0x00, 0x00,
-    0x00, 0xC0, 0x81, 0x80, 0x00, 0x00, 0x00, 0x02, 0x00, 0x03, 0x01, 0x31, 0x24, 0x00, 0x00, 0x00,
-    0x00, 0xC0, 0x01, 0x80, 0x00, 0x00, 0x00, 0x1C, 0x00, 0x1C, 0x04, 0x01, 0xFC, 0x00, 0x00, 0x00,
-    0x00, 0xC0, 0x01, 0x80, 0x00, 0x00, 0x01, 0xF0, 0x00, 0x0F, 0x81, 0xC0, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x40, 0x01, 0x00, 0x00, 0x00, 0x03, 0x10, 0x00, 0x00, 0x00, 0x70, 0x04, 0x00, 0x00, 0x00,
-    0x00, 0x60, 0x03, 0x00, 0x00, 0x00, 0x01, 0xD0, 0x00, 0x00, 0x07, 0x80, 0x04, 0x00, 0x00, 0x00,
-    0x00, 0x30, 0x07, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x07, 0x80, 0x04, 0x00, 0x00, 0x00,
-    0x00, 0x1C, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x71, 0xFC, 0x00, 0x00, 0x00,
-    0x00, 0x0F, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xE0, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x03, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
-  */
+  128, 16,
+  0xC0, 0x00, 0x01, 0x80, 0x80, 0xC3, 0x00, 0x05, 0xC0, 0xF0, 0x38, 0x0C, 0x06, 0x02, 0xFA, 0x03,
+  0xFD, 0x00, 0x05, 0xF0, 0xF0, 0xC0, 0x60, 0x30, 0x30, 0xFE, 0x00, 0x08, 0xC0, 0x60, 0x20, 0x10,
+  0x10, 0x30, 0x60, 0xC0, 0x80, 0xFE, 0x00, 0x08, 0xC0, 0x60, 0x20, 0x30, 0x10, 0x30, 0x20, 0x60,
+  0xC0, 0xFE, 0x00, 0x04, 0xF0, 0xF0, 0xC0, 0x20, 0x20, 0xFE, 0x30, 0x02, 0x60, 0xE0, 0x80, 0xFE,
+  0x00, 0x04, 0xFF, 0xFF, 0xC0, 0x20, 0x20, 0xFE, 0x30, 0x02, 0x60, 0xE0, 0x80, 0xFD, 0x00, 0x06,
+  0x80, 0xC0, 0xC0, 0xE0, 0xE0, 0xF0, 0xF0, 0xFE, 0xF8, 0x04, 0x80, 0x00, 0x00, 0xF0, 0xF0, 0xFB,
+  0x00, 0x01, 0xF0, 0xF0, 0xFD, 0x00, 0x01, 0xC0, 0xE0, 0xFD, 0x30, 0xFC, 0x00, 0x0F, 0xC0, 0x60,
+  0x20, 0x10, 0x10, 0x30, 0x60, 0xC0, 0x80, 0x00, 0x00, 0x07, 0x3F, 0x78, 0xE0, 0xC0, 0xFE, 0x80,
+  0x00, 0x81, 0xFE, 0x83, 0x01, 0xFF, 0xFF, 0xFE, 0x00, 0x01, 0xFF, 0xFF, 0xFB, 0x00, 0x02, 0x1F,
+  0x7F, 0xC4, 0xFC, 0x84, 0x06, 0x87, 0x07, 0x00, 0x00, 0x1F, 0x7F, 0xE4, 0xFB, 0x84, 0x05, 0x87,
+  0x07, 0x00, 0x00, 0xFF, 0xFF, 0xFA, 0x00, 0x01, 0xFF, 0xFF, 0xFE, 0x00, 0x01, 0xFF, 0xFF, 0xFA,
+  0x00, 0x15, 0xFF, 0xFF, 0x00, 0x00, 0x7C, 0xFF, 0x7F, 0xBF, 0xDF, 0xEF, 0xF7, 0xFB, 0xFF, 0xFF,
+  0x7F, 0x1F, 0x03, 0x00, 0x00, 0x3F, 0xFF, 0xC0, 0xFD, 0x80, 0x02, 0x40, 0xFF, 0xFF, 0xFD, 0x00,
+  0x06, 0x81, 0x83, 0x86, 0x86, 0x8C, 0xFC, 0x78, 0xFE, 0x00, 0x02, 0x1F, 0x7F, 0xC4, 0xFC, 0x84,
+  0x01, 0x87, 0x07, 0xF9, 0x00, 0xFB, 0x01, 0xFC, 0x00, 0x01, 0x01, 0x01, 0xF7, 0x00, 0x26, 0x01,
+  0x01, 0xC1, 0x41, 0xF0, 0x00, 0x80, 0x40, 0xC0, 0x00, 0xC0, 0x40, 0x01, 0xE1, 0x81, 0x41, 0x41,
+  0xC0, 0xC0, 0x40, 0x40, 0x81, 0x81, 0x40, 0x40, 0x80, 0x80, 0x40, 0x40, 0xF0, 0x01, 0x01, 0xF0,
+  0x40, 0x40, 0x81, 0xC1, 0x00, 0xC0, 0xFE, 0x00, 0x03, 0x80, 0x70, 0x31, 0xC1, 0xFE, 0x00, 0x03,
+  0xF8, 0x03, 0x01, 0x01, 0xFE, 0x11, 0x05, 0xF0, 0x10, 0x10, 0x00, 0x00, 0xF0, 0xFE, 0x10, 0x07,
+  0x00, 0x01, 0xF1, 0x61, 0xC0, 0x00, 0x01, 0xF1, 0xFC, 0x00, 0xFD, 0x01, 0xF8, 0x00, 0xFD, 0x01,
+  0xDE, 0x00, 0x03, 0x03, 0x02, 0x03, 0x00, 0xFE, 0x03, 0x1C, 0x00, 0x02, 0x03, 0x00, 0x03, 0x01,
+  0x0A, 0x0A, 0x07, 0x03, 0x00, 0x00, 0x03, 0x01, 0x03, 0x03, 0x01, 0x03, 0x02, 0x02, 0x03, 0x00,
+  0x00, 0x03, 0x02, 0x02, 0x01, 0x05, 0x03, 0xFE, 0x00, 0x08, 0x1C, 0x07, 0x02, 0x02, 0x03, 0x0E,
+  0x10, 0x00, 0x1F, 0xFD, 0x10, 0x02, 0x00, 0x00, 0x1F, 0xFD, 0x00, 0x00, 0x1F, 0xFE, 0x11, 0x07,
+  0x10, 0x00, 0x1F, 0x00, 0x00, 0x03, 0x0C, 0x1F, 0xB4, 0x00, 0x17, 0xE0, 0x50, 0x80, 0x40, 0x40,
+  0x80, 0x40, 0xC0, 0x80, 0xE0, 0x40, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x40, 0x80, 0x40, 0x40,
+  0x80, 0xC0, 0x40, 0xC8, 0x00, 0x02, 0x80, 0xC0, 0x80, 0xF6, 0x00, 0x00, 0xC0, 0xF9, 0x00, 0x00,
+  0x40, 0xEF, 0x00, 0x00, 0xC0, 0xFD, 0x00, 0x17, 0xC3, 0x00, 0x01, 0xC3, 0xC3, 0x01, 0x03, 0x02,
+  0x03, 0xC1, 0x02, 0x00, 0x83, 0x42, 0x43, 0x40, 0x83, 0x00, 0x01, 0x03, 0x03, 0x01, 0x02, 0x03,
+  0xCA, 0x00, 0x23, 0x60, 0x1C, 0x0B, 0x08, 0x0F, 0x38, 0x40, 0x00, 0x7E, 0x00, 0x02, 0x00, 0x3C,
+  0x42, 0x42, 0x26, 0x7F, 0x00, 0x00, 0x3E, 0x40, 0x40, 0x20, 0x7E, 0x00, 0x7E, 0x00, 0x00, 0x7E,
+  0x04, 0x02, 0x02, 0x7C, 0x00, 0x00, 0x3C, 0xFE, 0x42, 0x00, 0x3C, 0xFD, 0x00, 0x11, 0x1F, 0x20,
+  0x40, 0x40, 0x60, 0x3F, 0x00, 0x00, 0x7F, 0x01, 0x03, 0x06, 0x18, 0x30, 0x7F, 0x00, 0x1E, 0x31,
+  0xFE, 0x40, 0x01, 0x20, 0x1F, 0xFC, 0x00, 0x29, 0x7E, 0x40, 0x40, 0x00, 0x7A, 0x00, 0x30, 0x48,
+  0x48, 0xF8, 0x00, 0x7E, 0x08, 0x70, 0x00, 0x3C, 0x48, 0x00, 0x00, 0x44, 0x4A, 0x52, 0x30, 0x30,
+  0x58, 0x58, 0x50, 0x00, 0x78, 0x08, 0x70, 0x00, 0x50, 0x58, 0x20, 0x30, 0x48, 0x48, 0x30, 0x00,
+  0x78, 0x08, 0xE5, 0x00, 0x09, 0x80, 0x70, 0x2E, 0x3E, 0xE0, 0x80, 0xFA, 0x00, 0xF8, 0x08, 0xFE,
+  0x00, 0x0B, 0xFE, 0x12, 0x12, 0x00, 0xC8, 0xA8, 0xF0, 0x00, 0xF8, 0x08, 0x08, 0xF0, 0xFC, 0x00,
+  0x26, 0x0C, 0x70, 0xE0, 0x1C, 0x70, 0xE0, 0x0C, 0x40, 0xB0, 0xB0, 0xE0, 0x78, 0x90, 0x00, 0x60,
+  0xB0, 0xA0, 0x00, 0xF0, 0x10, 0x00, 0x00, 0xFC, 0x80, 0x80, 0x00, 0x60, 0xB0, 0xB0, 0x20, 0x30,
+  0xC0, 0x60, 0x10, 0x60, 0xB1, 0xB1, 0x20, 0xFC, 0xFE, 0x00, 0x0F, 0x98, 0x94, 0x64, 0x00, 0x60,
+  0xB0, 0xA0, 0x00, 0xF0, 0x10, 0x10, 0xE0, 0xA0, 0xB0, 0x50, 0x60, 0xFE, 0x90, 0x02, 0x60, 0xF0,
+  0x10, 0xE9, 0x00, 0x35, 0xF0, 0x38, 0xC0, 0xC0, 0x38, 0xF8, 0x00, 0xC0, 0x20, 0x20, 0xC0, 0xE8,
+  0x00, 0x40, 0x60, 0x80, 0x00, 0xF0, 0x20, 0xE0, 0x00, 0x00, 0xE0, 0x00, 0xE0, 0x20, 0xC0, 0x60,
+  0x60, 0x40, 0x00, 0x00, 0x10, 0x28, 0x48, 0xC0, 0xC0, 0x60, 0x60, 0x40, 0xE0, 0x20, 0x20, 0xC0,
+  0x00, 0x60, 0x20, 0x80, 0xC0, 0x20, 0x20, 0xC0, 0xE0, 0x20, 0xFC, 0x00, 0x07, 0x70, 0x88, 0x04,
+  0x04, 0x8C, 0xF8, 0x00, 0xFC, 0xFD, 0x00, 0x00, 0xFC, 0xFE, 0x24, 0x01, 0x00, 0xFC, 0xFE, 0x04,
+  0x01, 0x88, 0x70, 0xFE, 0x00, 0x00, 0xFC, 0xFE, 0x04, 0x09, 0x88, 0x70, 0x00, 0xF4, 0x00, 0x20,
+  0x50, 0x90, 0x00, 0xF0, 0xFE, 0x10, 0x0D, 0xE0, 0x00, 0xFE, 0x00, 0x80, 0x50, 0x50, 0xE0, 0x00,
+  0x10, 0xE0, 0x80, 0xE0, 0x10, 0xFB, 0x00, 0x70, 0x60, 0x80, 0x00, 0xE0, 0xE0, 0x00, 0x81, 0x20,
+  0x80, 0x80, 0x00, 0x01, 0x80, 0xC0, 0x81, 0x01, 0x80, 0x81, 0x00, 0x01, 0x81, 0x80, 0x00, 0x01,
+  0x01, 0xE0, 0x21, 0x21, 0x01, 0xE0, 0x01, 0x00, 0x80, 0x81, 0x81, 0x00, 0x80, 0x00, 0x01, 0x81,
+  0x01, 0x00, 0x80, 0x01, 0x01, 0xC0, 0x21, 0x20, 0x00, 0x01, 0x00, 0x81, 0x81, 0x00, 0x80, 0x81,
+  0x81, 0x00, 0x01, 0x00, 0x80, 0x80, 0x00, 0x00, 0x80, 0x80, 0x00, 0x01, 0x81, 0x80, 0x00, 0x00,
+  0x01, 0x01, 0x61, 0x81, 0x00, 0xC1, 0xE1, 0x01, 0x01, 0xE0, 0x01, 0x01, 0x81, 0x81, 0x00, 0x80,
+  0xC0, 0x80, 0x00, 0x01, 0x81, 0x81, 0x01, 0x00, 0x80, 0x80, 0x81, 0x00, 0x01, 0x01, 0xE0, 0x20,
+  0x27, 0xC1, 0x01, 0x81, 0x00, 0x00, 0x81, 0x00, 0x80, 0xFE, 0x81, 0x04, 0x00, 0x80, 0x84, 0x03,
+  0x00, 0xFD, 0x80, 0xFD, 0x00, 0x14, 0x07, 0x8E, 0x01, 0x01, 0x0E, 0x03, 0x80, 0x8C, 0x8A, 0x8F,
+  0x00, 0x80, 0x8F, 0x88, 0x87, 0x0A, 0x0A, 0x0B, 0x00, 0x0F, 0x80, 0xFE, 0x00, 0x18, 0x0F, 0x81,
+  0x01, 0x00, 0x0F, 0x00, 0x07, 0x08, 0x08, 0xC8, 0x07, 0x00, 0x0E, 0x06, 0x03, 0x0E, 0x06, 0x00,
+  0x80, 0x00, 0x08, 0x09, 0x09, 0x06, 0x07, 0xFE, 0x0A, 0x0F, 0x03, 0x0F, 0x00, 0x00, 0x0F, 0x00,
+  0x09, 0x8A, 0x06, 0x00, 0x07, 0x88, 0x08, 0x07, 0x00, 0x0F, 0xFB, 0x00, 0x25, 0x07, 0x0E, 0x03,
+  0x00, 0x8F, 0x0E, 0x01, 0x00, 0x0C, 0x8A, 0x0A, 0x8F, 0x00, 0x0F, 0x08, 0x00, 0x07, 0x0A, 0x0A,
+  0x0B, 0x00, 0x0F, 0x00, 0x00, 0x80, 0x00, 0x00, 0x0F, 0x01, 0x01, 0x00, 0x00, 0x07, 0x08, 0x08,
+  0x0F, 0x00, 0x0F, 0xFE, 0x00, 0x05, 0x0F, 0x00, 0x00, 0x0F, 0x00, 0x3F, 0xFE, 0x08, 0x00, 0x07,
+  0xFD, 0x00, 0x00, 0x3F, 0xFE, 0x20, 0x01, 0x00, 0x3F, 0xFE, 0x24, 0x01, 0x00, 0x3F, 0xFE, 0x20,
+  0x01, 0x11, 0x0E, 0xFE, 0x00, 0x00, 0x3F, 0xFE, 0x20, 0x03, 0x00, 0x3E, 0x00, 0x1C, 0xFE, 0xA2,
+  0x0D, 0x7E, 0x00, 0x3F, 0x02, 0x02, 0x3C, 0x00, 0x02, 0x3F, 0x22, 0x00, 0x3E, 0x00, 0x3E, 0xFE,
+  0x02, 0x05, 0x3C, 0x00, 0x1C, 0xA2, 0xA2, 0x7E, 0xFC, 0x00, 0x00, 0x3F, 0xFE, 0x04, 0x1E, 0x3F,
+  0x00, 0x1E, 0x20, 0x20, 0x3E, 0x00, 0x3E, 0x02, 0x02, 0x3C, 0x02, 0x02, 0x3C, 0x00, 0x3E, 0x00,
+  0x1C, 0x22, 0x22, 0x3F, 0x00, 0x3E, 0x00, 0x02, 0x3F, 0x22, 0x02, 0x4C, 0x30, 0x0E, 0xFE, 0x00,
+  0x18, 0x23, 0x24, 0x18, 0x00, 0x1C, 0x2A, 0x2A, 0x2C, 0x00, 0x3E, 0x02, 0x02, 0x3C, 0x00, 0x24,
+  0x2A, 0x10, 0x00, 0x1C, 0x22, 0x22, 0x1C, 0x00, 0x3E, 0x02, 0xEC, 0x00, 0x42, 0x02, 0x7E, 0x02,
+  0x32, 0x58, 0x58, 0x50, 0x00, 0x78, 0x08, 0x70, 0x08, 0x08, 0x70, 0xF8, 0x48, 0x48, 0x30, 0x00,
+  0x30, 0x58, 0x58, 0x10, 0x78, 0x08, 0x00, 0x68, 0x58, 0x78, 0x00, 0x7C, 0x48, 0x38, 0x40, 0x40,
+  0x78, 0x00, 0x78, 0x08, 0x30, 0x58, 0x58, 0x10, 0x00, 0x00, 0x50, 0x58, 0x28, 0x30, 0x58, 0x58,
+  0x50, 0x00, 0x78, 0x08, 0x70, 0x00, 0x50, 0x58, 0x20, 0x30, 0x48, 0x48, 0x30, 0x00, 0x78, 0x08,
+  0xB6, 0x00, 0x00, 0x01, 0xE8, 0x00, 0x1D, 0x80, 0xF0, 0xF0, 0x80, 0x00, 0xE0, 0x20, 0xE0, 0x00,
+  0xE0, 0x20, 0xF0, 0x00, 0xF8, 0x00, 0x00, 0x10, 0x90, 0x70, 0x00, 0xE0, 0x10, 0xF0, 0x00, 0x10,
+  0xF0, 0x00, 0x70, 0x90, 0xF0, 0xFD, 0x00, 0x23, 0xE0, 0x10, 0x50, 0xC0, 0xC0, 0x20, 0x20, 0xC0,
+  0xF0, 0x20, 0x00, 0xF8, 0x20, 0xE0, 0xC0, 0xA0, 0xA0, 0xC0, 0xE0, 0x20, 0x20, 0xC0, 0xF8, 0x20,
+  0x20, 0xC0, 0xE0, 0x00, 0x00, 0xE0, 0xE0, 0x20, 0xC0, 0x20, 0x20, 0xE0, 0xC7, 0x00, 0x0F, 0x01,
+  0x00, 0x00, 0x01, 0x00, 0x07, 0x01, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0xFE,
+  0x01, 0x02, 0x00, 0x00, 0x01, 0xFE, 0x00, 0x06, 0x01, 0x00, 0x01, 0x01, 0x00, 0x00, 0x03, 0xFE,
+  0x00, 0xFE, 0x01, 0x10, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01,
+  0x01, 0x00, 0x01, 0x00, 0x00, 0xFD, 0x01, 0x01, 0x00, 0x00, 0xFD, 0x01, 0x05, 0x00, 0x00, 0x05,
+  0x05, 0x03, 0x00
 };
 
 /*
@@ -439,7 +599,7 @@ const unsigned char greenhouse[] PROGMEM = {
   || Initialize OLED display and show startup images. ||
   ====================================================== */
 void viewStartupImage() {
-  Serial.println("startupImageDisplay");
+  console.println("startupImageDisplay");
   SeeedGrayOled.clearDisplay();                         //Clear display.
 
   //Make everything is shut down.
@@ -447,12 +607,11 @@ void viewStartupImage() {
   ledLightStop();                                                 //Stop(OFF) LED lighting.
   fanStop();                                                      //Stop(OFF) fan.
 
-  /*
-      //Startup image.
-      SeeedGrayOled.drawBitmap(greenhouse, (128*128)/8);   //Show greenhouse logo. Second parameter in drawBitmap function specifies the size of the image in bytes. Fullscreen image = 128 * 64 pixels / 8.
-      delay(4000);                                    //Image shown for 4 seconds.
-      SeeedGrayOled.clearDisplay();                       //Clear the display.
-  */
+  //Startup image.
+  SeeedGrayOled.drawCompressedBitmap(greenhouse);       //Show greenhouse logo, fullscreen 128 * 128 pixels.
+  SeeedGrayOled.flush();
+  delay(4000);                                          //Image shown for 4 seconds.
+  SeeedGrayOled.clearDisplay();                         //Clear the display.
 
   startupImageDisplay = false;                            //Clear current screen display state.
   setTimeDisplay = true;                                  //Set next display mode to be printed to display.
@@ -487,18 +646,10 @@ void viewStartupImage() {
   stringToDisplay(11, 0, "booting up..");
   stringToDisplay(14, 0, "           Alten");
   stringToDisplay(15, 0, "     april, 2019");
+  SeeedGrayOled.flush();                                  //Send screen to display before waiting.
   delay(9000);
   SeeedGrayOled.clearDisplay();
-}
-
-/*
-  =======================================
-  || Print number variable to display. ||
-  ======================================= */
-void numberToDisplay(unsigned char x, unsigned char y, unsigned short variable) {
-  y *= 8;                                         //To align symbol with rest printed text. Each symbol requires 8px in width.
-  SeeedGrayOled.setTextXY(x, y);                  //Set cordinates to where text will be printed. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(variable);              //Print value to display.
+  screen.invalidate();                                    //Screens are drawn from a cleared display.
 }
 
 /*
@@ -511,152 +662,155 @@ void stringToDisplay(unsigned char x, unsigned char y, char* text) {
   SeeedGrayOled.putString(text);                  //Print text to display.
 }
 
-/*
-  ======================================================
-  || Clear any character/s (print blanks) at display. ||
-  ====================================================== */
-void blankToDisplay(unsigned char x, unsigned char y, int numOfBlanks) {
-  y *= 8;                                         //To align symbol with rest printed text. Each symbol requires 8px in width.
-  for (int i = 0; i < numOfBlanks; i++) {         //Print blank space to display. Each loop one blank space is printed.
-    SeeedGrayOled.setTextXY(x, y);                //Set cordinates to where text will be printed. X = row (0-7), Y = column (0-127).
-    SeeedGrayOled.putString(" ");                 //Blank symbol.
-    y += 8;                                       //Increase column cordinate to print next blank space in the same row.
-  }
-}
-
 /*
   ========================================================================
   || VALUE READOUT DISPLAY MODE. Print read out values to OLED display. ||
   ======================================================================== */
-void viewReadoutValues() {
-  //Clear symbols from previous display mode.
-  blankToDisplay(0, 0, 2);
-  blankToDisplay(2, 9, 7);
-  blankToDisplay(3, 5, 11);
-  blankToDisplay(4, 6, 8);
-  blankToDisplay(5, 9, 5);
-  blankToDisplay(6, 9, 4);
-  blankToDisplay(7, 5, 9);
-  blankToDisplay(8, 9, 5);
-  blankToDisplay(9, 5, 5);
-  blankToDisplay(10, 8, 5);
-  blankToDisplay(11, 0, 16);
-
-  blankToDisplay(13, 0, 16);
-
-  blankToDisplay(14, 7, 9);
-
-  stringToDisplay(0, 2, "READOUT VALUES");          //Print current display state to upper right corner of display.
-
-  //Printing read out values from the greenhouse to display.
-  /*************************************
-    |Moisture mean value and soil status.|
-  *************************************/
-  stringToDisplay(2, 0, "Moisture:");
-  numberToDisplay(2, 10, moistureMeanValue);    //Moisture mean value calculated from all four moisture sensor readouts.
-
-  stringToDisplay(3, 0, "Soil:");               //Prints "Dry", "OK" or "Wet" to display based on soil humidity.
+//Prints "Dry", "OK" or "Wet" to display based on soil humidity.
+const char *soilText() {
   if (moistureDry == true) {
-    stringToDisplay(3, 10, "Dry   ");
-  }
-  else if (moistureDry == false && moistureWet == false) {
-    stringToDisplay(3, 10, "OK    ");
+    return "Dry";
   }
   else if (moistureWet == true) {
-    stringToDisplay(3, 10, "Wet   ");
-  }
-
-  /***************************
-    |Light and UV-light values.|
-  ***************************/
-  SeeedGrayOled.setTextXY(4, 0);                //Set cordinates to where it will print text. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putString("Light:");            //Print string to display.
-  SeeedGrayOled.setTextXY(4, 10 * 8);
-  SeeedGrayOled.putNumber(lightValue);          //Print light value in the unit, lux, to display.
-  stringToDisplay(4, 14, "lm");
-
-  SeeedGrayOled.setTextXY(5, 0);                //Set cordinates to where it will print text. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putString("UV-light:");         //Print string to display.
-  SeeedGrayOled.setTextXY(5, 10 * 8);
-  SeeedGrayOled.putNumber(uvValue);             //Print light value in the unit, lux, to display.
-  stringToDisplay(5, 14, "UN");
-
-  /********************
-    |Air humidity value.|
-  ********************/
-  stringToDisplay(6, 0, "Humidity:");
-  numberToDisplay(6, 10, humidityValue);      //Air humidity value, unit in %.
-  stringToDisplay(6, 13, "pct");
-
-  /*************************************************************************
-    |Temperature value and temperature threshold value set by rotary encoder.|
-  *************************************************************************/
-  stringToDisplay(7, 0, "Temp:");
-  numberToDisplay(7, 10, tempValue);            //Temperature value.
-  stringToDisplay(7, 14, "*C");
-
-  stringToDisplay(8, 0, "Temp lim:");
-  SeeedGrayOled.setTextXY(8, 10 * 8);
-  SeeedGrayOled.putNumber(tempThresholdValue);  //Print temperature threshold value to display. Temp value is doubled to reduce rotary sensitivity and increase knob rotation precision. Value 24 corresponds to 12°C.
-  stringToDisplay(8, 14, "*C");
-
-  /*************************
-    |Water flow sensor value.|
-  *************************/
-  SeeedGrayOled.setTextXY(9, 0);                    //Set cordinates to where it will print text. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putString("Flow:");              //Print string to display.
-  SeeedGrayOled.setTextXY(9, 6 * 8);
-  SeeedGrayOled.putNumber(waterFlowValue);          //Print water flow value to display.
-  stringToDisplay(9, 10, "ml/min");
-
-  /*****************
-    |Fan speed value.|
-  *****************/
-  SeeedGrayOled.setTextXY(10, 0);                     //Set cordinates to where it will print text. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putString("Fan spd:");                //Print string to display.
-  SeeedGrayOled.setTextXY(10, 9 * 8);
-  SeeedGrayOled.putNumber(fanSpeedValue);                //Print water flow value to display.
-  stringToDisplay(10, 13, "rpm");
-
-
-  /****************
-    |Current action.|
-  ****************/
+    return "Wet";
+  }
+  return "OK";
+}
+
+//Current action.
+const char *actionText() {
   switch (actionRegister) {
     case 1:
-      stringToDisplay(12, 0, "Check light need");
-      break;
+      return "Check light need";
     case 2:
-      stringToDisplay(12, 0, "Check water need");
-      break;
+      return "Check water need";
     case 4:
-      stringToDisplay(12, 0, "Pumping water.. ");
-      break;
-    case 8:
-      blankToDisplay(12, 0, 16);
-      break;
+      return irrigation.size() > 1 ? wateringText() : "Pumping water..";
   }
+  return "";
+}
+
+//Zone being watered, e.g. "Watering BED1".
+const char *wateringText() {
+  static char text[SCREEN_COLUMNS + 1];
+  uint8_t zone = irrigation.active();
+  strcpy(text, "Watering ");
+  strncat(text, zone != IRRIGATION_IDLE ? irrigation.zone(zone).name : "", SCREEN_COLUMNS - strlen(text));
+  return text;
+}
+
+//Alarm message for any fault that is currently active. Warning messages use the same space of display, one alarm message after another, each shown for alarmTimePeriod.
+const char *alarmText() {
+  if (greenhouseProgramStart == false || alarmMessageEnabled == false) {   //Any alarm can only be printed to display if variable is set to 'true'.
+    return "";
+  }
+
+  unsigned long alarmTimeDiff = millis() - alarmTimePrev;                //Keeps track for how long time each warning message is shown on display.
+  if (alarmTimeDiff <= alarmTimePeriod) {
+    return waterFlowFault == true ? "NO WATER FLOW" : "";
+  }
+  else if (alarmTimeDiff <= alarmTimePeriod * 2) {
+    return waterLevelFault == true ? "LOW WATER LEVEL" : "";
+  }
+  else if (alarmTimeDiff <= alarmTimePeriod * 3) {
+    if (tempValueFault == true && tempValue > tempThresholdValue) {
+      return "HIGH TEMPERATURE";
+    }
+    else if (tempValueFault == true && tempValue < TEMP_VALUE_MIN) {
+      return "LOW TEMPERATURE";
+    }
+    return "";
+  }
+  else if (alarmTimeDiff <= alarmTimePeriod * 4) {
+    return ledLightFault == true ? "LED NOT WORKING" : "";     //If measured water flow is below a certain value without the water level sensor indicating the water tank is empty, there is a problem with the water tank hose.
+  }
+  else if (alarmTimeDiff <= alarmTimePeriod * 5) {
+    return sensorAlarmText();
+  }
+  alarmTimePrev = millis();                                              //Start over with the first alarm.
+  return "";
+}
+
+//First sensor that is not healthy, e.g. "SENS M2 STUCK". "SENS LIGHT NOISY" is as long as a row gets.
+const char *sensorAlarmText() {
+  static char text[SCREEN_COLUMNS + 1];
+  for (uint8_t i = 0; i < ARRAY_COUNT(SENSOR_NAMES); i++) {
+    uint8_t flags = sensorHealth.flags(i);
+    if (flags != 0) {
+      snprintf(text, sizeof(text), "SENS %s %s", SENSOR_NAMES[i],
+               (flags & SENSOR_DEAD) ? "DEAD" : (flags & SENSOR_NOISY) ? "NOISY" : "STUCK");
+      return text;
+    }
+  }
+  return "";
+}
 
-  /*****************************
-    |Space for any active alarms.|
-  *****************************/
-  stringToDisplay(14, 0, "Alarms:");
+const ScreenLabel readoutLabels[] = {
+  {0, 2, "READOUT VALUES"},                     //Current display state in upper right corner of display.
+  {2, 0, "Moisture:"},
+  {3, 0, "Soil:"},
+  {4, 0, "Light:"},
+  {4, 14, "lm"},
+  {5, 0, "UV-light:"},
+  {5, 14, "UN"},
+  {6, 0, "Humidity:"},
+  {6, 13, "pct"},
+  {7, 0, "Temp:"},
+  {7, 14, "*C"},
+  {8, 0, "Temp lim:"},
+  {8, 14, "*C"},
+  {9, 0, "Flow:"},
+  {9, 10, "ml/min"},
+  {10, 0, "Fan spd:"},
+  {10, 13, "rpm"},
+  {14, 0, "Alarms:"}
+};
+
+const ScreenField readoutFields[] = {
+  {2, 10, 6, SCREEN_INT, &moistureMeanValue, 0},          //Moisture mean value calculated from all four moisture sensor readouts.
+  {3, 10, 6, SCREEN_TEXT, 0, soilText},
+  {4, 10, 4, SCREEN_UNSIGNED, &lightValue, 0},            //Light value in lumens.
+  {5, 10, 4, SCREEN_UNSIGNED, &uvValue, 0},
+  {6, 10, 3, SCREEN_FLOAT, &humidityValue, 0},            //Air humidity value, unit in %.
+  {7, 10, 4, SCREEN_FLOAT, &tempValue, 0},
+  {8, 10, 4, SCREEN_UNSIGNED, &tempThresholdValue, 0},    //Temperature threshold set by rotary encoder.
+  {9, 6, 4, SCREEN_UNSIGNED, &waterFlowValue, 0},
+  {10, 9, 4, SCREEN_UNSIGNED, &fanSpeedValue, 0},
+  {12, 0, 16, SCREEN_TEXT, 0, actionText},
+  {15, 0, 16, SCREEN_TEXT, 0, alarmText}                  //Space for any active alarms.
+};
+
+const ScreenLayout readoutScreen = {readoutLabels, ARRAY_COUNT(readoutLabels), readoutFields, ARRAY_COUNT(readoutFields)};
+
+void viewReadoutValues() {
+  screen.draw(readoutScreen);
 }
 
 /*
   ==========================================
   || Read light values from light sensor. ||
   ========================================== */
+//All values come from the same measurement, read in one transaction when the sensor signals it on its INT pin. The measurement is asked for by readSensorsTask().
 void lightRead() {
-  unsigned short value = 0;
-  lightValue = lightSensor.ReadVisible();
-  value = lightSensor.ReadUV();
-
-  //Only update uvValue if not equal to zero to avoid an uvValue of zero because it is not updated as frequently as the other light sensor.
-  if (value != 0 && ledLightState == true) {
-    uvValue = value;
+  SI114XSample sample;
+  lightForced = false;
+  if (lightSensor.ReadSample(sample) == false) {               //Short read, the INT pin stays low and the sample is read again on the next pass.
+    failReading(SENSOR_LIGHT);
+    failReading(SENSOR_UV);
+    return;
   }
-  //irValue = lightSensor.ReadIR();
+  //irValue = sample.IR;
+  if (storeReading(SENSOR_LIGHT, sample.Visible) == true) {
+    lightValue = sample.Visible;
+  }
+  if (storeReading(SENSOR_UV, sample.UV) == true) {
+    uvValue = sample.UV;
+  }
+}
+
+void lightSensorInterrupt() {
+  events.push(EVENT_LIGHT_SAMPLE, 0);           //Light sensor is read in loop().
+  scheduler.wake();
 }
 
 /*
@@ -664,12 +818,14 @@ void lightRead() {
   || Check current clock time to enable/disable start of LED lighting, fan and water pump. ||
   =========================================================================================== */
 void checkTimePermission() {
+  unsigned short minuteOfDay = clockMinuteOfDay();
+
   //LED lighting and fan are allowed to run in this time window.
-  if (currentClockTime >= LIGHT_FAN_START_TIME && currentClockTime < LIGHT_FAN_STOP_TIME) {
+  if (timeWindowOpen(minuteOfDay, LIGHT_FAN_START_TIME, LIGHT_FAN_STOP_TIME) == true) {
     ledLightTimeAllowed = true;       //LED lighting is allowed to be turned on.
     fanTimeAllowed = true;            //Fan is allowed to run.
-    Serial.println("LED lighting allowed.");
-    Serial.println("Fan allowed.");
+    console.println("LED lighting allowed.");
+    console.println("Fan allowed.");
   }
   else {
     ledLightTimeAllowed = false;       //LED lighting is not allowed to be turned on.
@@ -677,7 +833,7 @@ void checkTimePermission() {
   }
 
   //Water pump allowed to run in below time window.
-  if (currentClockTime >= PUMP_START_TIME && currentClockTime < pumpStopTime) {
+  if (timeWindowOpen(minuteOfDay, PUMP_START_TIME, pumpStopTime) == true) {
     if (moistureDry == true) {
       waterPumpTimeAllowed = true;    //Water pump is allowed to run.
     }
@@ -692,9 +848,16 @@ void checkTimePermission() {
   || Turn ON LED lighting. ||
   =========================== */
 void ledLightStart() {
-  relay.turn_on_channel(LED_LIGHTING);                                 //Turn on LED lighting.
+  if (ledLightState == false) {
+    sensors.hurry(SENSOR_LIGHT);                                  //Light changes now, read it before ledLightCheck().
+    sensors.hurry(SENSOR_UV);
+  }
+  relay.stage(LED_LIGHTING, true);                                     //Turn on LED lighting.
   ledLightState = true;                                           //Update current LED lighting state, 'true' means lighting is on.
-  Serial.println("LED lighting ON");
+  if (!scheduler.scheduled(ledLightCheck)) {
+    scheduler.every(CHECK_LIGHT_FAULT_PERIOD, ledLightCheck);      //Check that LED lighting works a while after it was turned ON, and then regularly while it is ON.
+  }
+  console.println("LED lighting ON");
 }
 
 /*
@@ -703,13 +866,16 @@ void ledLightStart() {
   ======================================= */
 //Alarm if light read out value does not get above light threshold when LED lighting is turned on.
 void ledLightCheck() {
-  if (ledLightState == true && uvValue < UV_THRESHOLD_VALUE) {
+  if (sensorUsable(SENSOR_UV) == false) {
+    ledLightFault = false;                                      //No UV value to judge by, the sensor alarm is shown instead.
+  }
+  else if (ledLightState == true && uvValue < UV_THRESHOLD_VALUE) {
     ledLightFault = true;                                       //If read out light value does not get above light threshold (lower light limit), fault variable is set to 'true' to alert user.
   }
   else {
     ledLightFault = false;
   }
-  Serial.println("Check LED lighting fault");
+  console.println("Check LED lighting fault");
 }
 
 /*
@@ -717,9 +883,14 @@ void ledLightCheck() {
   || Turn OFF LED lighting. ||
   ============================ */
 void ledLightStop() {
-  relay.turn_off_channel(LED_LIGHTING);                                //Turn off LED lighting.
+  relay.stage(LED_LIGHTING, false);                                    //Turn off LED lighting.
+  if (ledLightState == true) {
+    sensors.hurry(SENSOR_LIGHT);
+    sensors.hurry(SENSOR_UV);
+  }
   ledLightState = false;                                        //Update current LED lighting state, 'false' means lighting is off.
-  Serial.println("LED lighting OFF");
+  scheduler.cancel(ledLightCheck);
+  console.println("LED lighting OFF");
 }
 
 
@@ -735,7 +906,7 @@ void checkLightNeed() {
     ledLightEnabled = true;         //Enable LED lighting to be turned on.
     fanEnabled = true;              //Enable fan to run.
   }
-  Serial.println("Check light need.");
+  console.println("Check light need.");
 }
 
 /*
@@ -751,8 +922,8 @@ void waterLevelRead() {
   || Count number of rotations flow sensor propeller does. Function runs every time interrupt pin is triggered. ||
   ================================================================================================================ */
 void waterFlowCount() {
-  //Interrupt function to count number of rotations that flow sensor makes when water is being pumped.
-  flowSensorRotations++;
+  //Interrupt function to time the rotations that flow sensor makes when water is being pumped.
+  flowPulses.edge();
 }
 
 /*
@@ -760,28 +931,31 @@ void waterFlowCount() {
   || Calculate water flow when water pump is running. ||
   ====================================================== */
 void waterFlow() {
-  waterFlowValue = (float(flowSensorRotations) * 60 * 1000) / 3467;   //(water flow value in ml/min) = ((total rotations during 1 sec * 60 sec) / (number of rotations it takes to pump 1 liter of water) * (1000 to convert value to milli liter).
-  flowSensorRotations = 0;
-
-  Serial.print("flowSensorRotations: ");
-  Serial.println(flowSensorRotations);
-
-  Serial.print("timer: ");
-  Serial.println(millis());
-
+  waterFlowValue = (flowPulses.perSecond() * 60 * 1000) / FLOW_PULSES_PER_LITER;   //(water flow value in ml/min) = ((rotations per second * 60 sec) / (number of rotations it takes to pump 1 liter of water) * (1000 to convert value to milli liter).
 
-  Serial.print("waterFlowValue: ");
-  Serial.println(waterFlowValue);
+  console.print("waterFlowValue: ");
+  console.println(waterFlowValue);
 }
 
 /*
   ===============================================
   || Start water pump, read water flow sensor. ||
   =============================================== */
-void waterPumpStart() {
-  relay.turn_on_channel(WATER_PUMP);          //Start water pump.
+//Water one zone. Its valve opens in the same relay write as the water pump starts.
+void waterPumpStart(uint8_t zone) {
+  if (irrigation.zone(zone).valve != 0) {
+    relay.stage(irrigation.zone(zone).valve, true);   //Open the zone's valve.
+  }
+  relay.stage(WATER_PUMP, true);              //Start water pump.
   waterPumpState = true;                  //Update current water pump state, 'true' means water pump is running.
-  Serial.println("Water pump ON");
+  irrigation.start(zone);                 //Water counted from here on is this zone's.
+
+  //Time flow sensor pulses from the moment the pump starts, so no pulse from the last run is part of the water flow value.
+  flowPulses.reset();
+  scheduler.after(WATER_PUMP_TIME_PERIOD, waterPumpFinished);  //Stop water pump after it has run for a certain amount of time, if the water dose was not delivered before that.
+  scheduler.after(CHECK_WATER_FLOW_PERIOD, waterFlowCheck);     //Check that water is being pumped once the pump has had time to start, and from then on while it runs.
+  console.print("Water pump ON, zone ");
+  console.println(irrigation.zone(zone).name);
 }
 
 /*
@@ -789,10 +963,31 @@ void waterPumpStart() {
   || Stop water pump. ||
   ====================== */
 void waterPumpStop() {
-  relay.turn_off_channel(WATER_PUMP);         //Stop water pump.
+  uint8_t zone = irrigation.active();
+  for (uint8_t i = 0; i < moistureSensors.size() && zone != IRRIGATION_IDLE; i++) {
+    if (irrigation.zone(zone).probes & (1 << i)) {
+      sensors.hurry(SENSOR_MOISTURE1 + i);    //Soil moisture of the zone changes now, read it before the next moistureTask().
+    }
+  }
+  relay.stage(WATER_PUMP, false);             //Stop water pump.
+  if (zone != IRRIGATION_IDLE && irrigation.zone(zone).valve != 0) {
+    relay.stage(irrigation.zone(zone).valve, false);  //Close the zone's valve, in the same relay write.
+  }
   waterPumpState = false;               //Update current water pump state, 'false' means water pump not running.
+  scheduler.cancel(waterPumpFinished);
+  scheduler.cancel(waterFlowCheck);
   waterFlowValue = 0;                   //Clear water flow value when pump is not running to prevent any old value from water flow sensor to be printed to display.
-  Serial.println("Water pump OFF");
+  unsigned long pulses = flowPulses.snapshot().count;
+  countWater(pulses);                   //Add the water of this run to the water pumped today.
+  irrigation.finish(pulses);            //And to the zone that was watered.
+  flowPulses.reset();                   //Counted, so that stopping the water pump again does not count it twice.
+  console.println("Water pump OFF");
+  if (zone != IRRIGATION_IDLE) {
+    console.print("Water pumped today (ml), zone ");
+    console.print(irrigation.zone(zone).name);
+    console.print(": ");
+    console.println(irrigation.pulses(zone) * 1000 / FLOW_PULSES_PER_LITER);
+  }
 }
 
 /*
@@ -800,17 +995,51 @@ void waterPumpStop() {
   || Check if water flow is above a certain amount when pump is running. ||
   ========================================================================= */
 void waterFlowCheck() {
-  Serial.println("Check water flow");
-  if (waterFlowValue < FLOW_THRESHOLD_VALUE) { //Check current water flow.
-    waterFlowFault = true;              //Set fault code.
-    Serial.println("Water flow Fault");
+  PulseSnapshot pulses = flowPulses.snapshot();
+  unsigned long dosePulses = (irrigation.zone(irrigation.active()).dose * (unsigned long)FLOW_PULSES_PER_LITER + 500) / 1000;
+  if (pulses.count >= dosePulses) {     //Water dose has been delivered.
+    waterPumpFinished();
+    return;
+  }
+
+  //Water flow now, from the time between the last flow sensor pulses. It drops below the threshold soon after the pulses stop.
+  float pulsesPerSecond = PulseTimer::perSecond(pulses, micros());
+  unsigned short waterFlowNow = (pulsesPerSecond * 60 * 1000) / FLOW_PULSES_PER_LITER;
+  if (waterFlowNow < FLOW_THRESHOLD_VALUE) {     //Check current water flow.
+    waterPumpStop();                    //Stop water pump at once, it must not run dry.
+    waterPumpEnabled = false;
+    actionRegister = 8;                 //Register to print what action that is currently performed in the greenhouse program.
+    waterFlowFault = true;              //Set fault code. It stays set until cleared in flow fault display mode, water pump is not started before that.
+    console.println("Water flow Fault, water pump stopped");
   }
   else {
-    waterFlowFault = false;             //Clear fault code.
-    Serial.println("Water flow OK");
+    //Check again when the rest of the water dose should have been delivered, if that is sooner.
+    unsigned long untilDose = (dosePulses - pulses.count) * 1000.0 / pulsesPerSecond;
+    if (untilDose < 1) {
+      untilDose = 1;                    //Not 0, that would run again in the same scheduler pass, millis() has not moved.
+    }
+    scheduler.after(untilDose < SUPERVISE_WATER_FLOW_PERIOD ? untilDose : SUPERVISE_WATER_FLOW_PERIOD, waterFlowCheck);
   }
 }
 
+/*
+  =======================================================
+  || Count water pumped today from flow sensor pulses. ||
+  ======================================================= */
+void countWater(unsigned long pulses) {
+  unsigned long day = clockTime() / 86400UL;
+  if (day != waterDay) {                //Local midnight has passed since water was last counted.
+    waterYesterday = waterToday;
+    waterDay = day;
+    waterPulsesToday = 0;
+    irrigation.newDay();
+    console.print("Water pumped yesterday (ml): ");
+    console.println(waterYesterday);
+  }
+  waterPulsesToday += pulses;
+  waterToday = waterPulsesToday * 1000 / FLOW_PULSES_PER_LITER;
+}
+
 /*
   ======================================
   || Enable/Disable water pump start. ||
@@ -819,14 +1048,14 @@ void checkWaterNeed() {
   checkTimePermission();              //Check if water pump is allowed to be running when needed (inside allowed time interval).
   if (waterPumpTimeAllowed == true) {
 
-    //Water pump is enabled if soil moisture is too dry or at the same time as no water related fault codes are set.
-    if (moistureDry == true && moistureWet == false) {
+    //Water pump is enabled if the soil of some zone is too dry and at the same time no water related fault codes are set.
+    if (irrigation.next() != IRRIGATION_IDLE) {
       if (waterLevelFault == false && waterFlowFault == false) {  //Make sure no water related fault codes are set.
         waterPumpEnabled = true;      //Enable water pump to run to pump water if needed.
       }
     }
   }
-  Serial.println("Check water need.");
+  console.println("Check water need.");
 }
 
 /*
@@ -834,8 +1063,8 @@ void checkWaterNeed() {
   || Count number of rotations fan blades does. Function runs every time interrupt pin is triggered. ||
   ===================================================================================================== */
 void fanRotationCount() {
-  //Interrupt function to count number of rotations that flow sensor makes when water is being pumped.
-  fanRotations++;
+  //Interrupt function to time the rotations that fan blades make.
+  fanPulses.edge();
 }
 
 /*
@@ -844,14 +1073,8 @@ void fanRotationCount() {
   ========================== */
 void fanRpm() {
   //Calculate fan rpm (rotations/minute) by counting number of rotations that fan blades make. Sensor is connected to interrupt pin.
-  //Function called once every second only when fan is running.
-  if (wifiClockCompleted == true) {
-    fanSpeedValue = fanRotations * 60 / 4;           //Calculate number of rotations fan blade have made during the time that passed since last measurement.
-  }
-  else {
-    fanSpeedValue = fanRotations * 60 / 2;           //Calculate number of rotations fan blade have made during the time that passed since last measurement.
-  }
-  fanRotations = 0;
+  //Function called every PULSE_RATE_PERIOD only when fan is running. Fan sensor gives two pulses per rotation.
+  fanSpeedValue = fanPulses.perSecond() * 60 / 2;  //Calculate fan speed from the time between the last pulses.
 }
 
 /*
@@ -859,6 +1082,9 @@ void fanRpm() {
   || Check and compare air-humidity to decide which speed to run fan at. ||
   ========================================================================= */
 void humiditySpeedControl() {
+  if (sensorUsable(SENSOR_HUMIDITY) == false) {
+    return;                                                     //Keep the fan speed mode as it is.
+  }
   if (humidityValue < HUMIDITY_THRESHOLD_VALUE) {
     lowFanSpeedEnabled = true;                                  //Activate low fan speed mode if air humidity is below humidity threshold value.
   }
@@ -875,17 +1101,17 @@ void humiditySpeedControl() {
   ================== */
 void fanStart() {
   if (lowFanSpeedEnabled == true) {
-    relay.turn_off_channel(FAN);                                //Make sure other fan mode is deactivated.
-    relay.turn_on_channel(FAN_LOW_SPEED);                       //Turn ON fan, low speed mode.
+    relay.stage(FAN, false);                                    //Make sure other fan mode is deactivated. Both channels switch in the same relay write.
+    relay.stage(FAN_LOW_SPEED, true);                           //Turn ON fan, low speed mode.
 
     fanState = true;                                            //Update current fan state, 'true' means lighting is on.
-    Serial.println("Fan (low speed) is ON");
+    console.println("Fan (low speed) is ON");
   }
   else if (lowFanSpeedEnabled == false) {
-    relay.turn_off_channel(FAN_LOW_SPEED);                      //Make sure other fan mode is deactivated.
-    relay.turn_on_channel(FAN);                                 //Turn ON fan, normal speed mode.
+    relay.stage(FAN_LOW_SPEED, false);                          //Make sure other fan mode is deactivated. Both channels switch in the same relay write.
+    relay.stage(FAN, true);                                     //Turn ON fan, normal speed mode.
     fanState = true;                                            //Update current fan state, 'true' means lighting is on.
-    Serial.println("Fan is ON");
+    console.println("Fan is ON");
   }
 }
 
@@ -894,79 +1120,23 @@ void fanStart() {
   || Turn OFF fan. ||
   =================== */
 void fanStop() {
-  relay.turn_off_channel(FAN);                                  //Turn OFF fan no matter what fan speed mode that is currently running.
-  relay.turn_off_channel(FAN_LOW_SPEED);
+  relay.stage(FAN, false);                                      //Turn OFF fan no matter what fan speed mode that is currently running.
+  relay.stage(FAN_LOW_SPEED, false);
   fanState = false;                                             //Update current fan state to indicate it is turned OFF.
-  Serial.println("Fan is OFF");
+  console.println("Fan is OFF");
 }
 
 /*
-  ===========================================================================================================================================================
-  || Timer interrupt triggered with frequency of 10 Hz used as second ticker for internal clock and to flash clock pointer values when in "set time" mode. ||
-  =========================================================================================================================================================== */
+  ==========================================================================================================================================================
+  || Timer interrupt triggered with frequency of 8 Hz used as second ticker for internal clock and to flash clock pointer values when in "set time" mode. ||
+  ========================================================================================================================================================== */
 ISR(RTC_CNT_vect) {
   RTC.INTFLAGS = 0x3;  //Clearing OVF and CMP interrupt flags.
 
   //if (greenhouseProgramStart == true) {
-  divider10++;
-
-  //Timer interrupt triggered with a frequency of 10 Hz.
-  if (divider10 >= 10) {                  //This part of the function will run once every second and therefore will provide a 1 Hz pulse to feed the second pointer.
-    divider10 = 0;                       //Clear divider variable.
-
-    //Internal clock.
-    secondPointer1++;                     //Increase second pointer every time this function runs.
-
-    //Second pointer.
-    if (secondPointer1 == 10) {           //If 1-digit second pointer reaches a value of 10 (elapsed time is 10 seconds).
-      secondPointer2++;                   //Increase 10-digit second pointer.
-      secondPointer1 = 0;                 //Clear 1-digit pointer.
-    }
-    if (secondPointer2 == 6) {            //If 10-digit pointer reaches a value of 6 (elapsed time is 60 seconds).
-      minutePointer1++;                   //Increase minute pointer.
-      secondPointer2 = 0;                 //Clear 10-digit second pointer.
-    }
-    //Minute pointer.
-    if (minutePointer1 == 10) {           //If 1-digit minute pointer reaches a value of 10 (elapsed time is 10 minutes).
-      minutePointer2++;                   //Increase 10-digit minute pointer.
-      minutePointer1 = 0;                 //Clear 1-digit minute pointer.
-    }
-    if (minutePointer2 == 6) {            //If 10-digit minute pointer reaches a value of 6 (elapsed time is 60 minutes).
-      hourPointer1++;                     //Increase 1-digit hour pointer.
-      minutePointer2 = 0;                 //Clear 10-digit minute pointer.
-    }
-    //Hour pointer.
-    if (hourPointer1 == 10) {             //If 1-digit hour pointer reaches a value of 10 (elapsed time is 10 hours).
-      hourPointer2++;                     //Increase 10-digit hour pointer.
-      hourPointer1 = 0;                   //Clear 1-digit hour pointer.
-    }
-    if (hourPointer2 == 2 && hourPointer1 == 4) { //If 1-digit and 10-digit hourPointer combined reaches 24 (elapsed time is 24 hours).
-      hourPointer1 = 0;                           //Clear both hour digits.
-      hourPointer2 = 0;
-    }
-
-    //Convert clock pointer into single int variable. Value of this variable represent clock time.
-    currentClockTime = 0;
-    currentClockTime += (hourPointer2 * 1000);
-    currentClockTime += (hourPointer1 * 100);
-    currentClockTime += (minutePointer2 * 10);
-    currentClockTime += minutePointer1;
-
-    if (currentClockTime < 60) {          //Prevent clock time from seeing 00:00 as less than 23:00.
-      currentClockTime += 2400;
-    }
-    wifiClockCompleted = false;
-
-    //Functions for calculation fan speed and water flow is triggered every second. The delay time of one second is used as time base for the calculation.
-    //Calculating fan speed on.
-    if (fanState == true) {
-      fanRpm();
-    }
-
-    //Time delay for calculating water flow.
-    if (waterPumpState == true) {
-      waterFlow();
-    }
+  //Timer interrupt triggered with a frequency of 8 Hz. The UTC clock also corrects the length of the next RTC period here.
+  if (rtcClock.tick() == true) {          //This part of the function will run once every second and therefore will provide a 1 Hz pulse to feed the internal clock.
+    clockSeconds++;                       //Internal clock. Hours, minutes and seconds are only split from it when shown.
   }
   //}
 }
@@ -990,46 +1160,48 @@ void setClockTime() {
 void resetClockTime() {
   //Stop clock and reset all clock pointers.
   clockStartMode = false;                       //Stop clock from ticking.
-  currentClockTime = 0;
-  hourPointer1 = 0;
-  hourPointer2 = 0;
-  minutePointer1 = 0;
-  minutePointer2 = 0;
-  secondPointer1 = 0;
-  secondPointer2 = 0;
+  noInterrupts();                               //Clock is also changed by the RTC interrupt.
+  clockSeconds = 0;
+  interrupts();
+  splitClockTime();
 }
 
 /*
-  ======================================================================================
+  =================================================================================
   || Toggle set modes and screen display modes when modeButton is being pressed. ||
-  ====================================================================================== */
+  ================================================================================= */
+void modeButtonInterrupt() {
+  events.push(EVENT_MODE_BUTTON, 0);            //Display modes are toggled in loop().
+  scheduler.wake();
+}
+
 void toggleDisplayMode() {
   //Debouncing button press to avoid multiple interrupts, display toggles.
   if ((millis() - pressTimePrev) >= DEBOUNCE_TIME_INTERRUPT) {
 
     //Toggle display modes every time MODE-button is pressed.
     if (setTimeDisplay == true) {
-      Serial.println("setTimeDisplay");
+      console.println("setTimeDisplay");
       if (hour2InputMode == true) {
         hour2InputMode = false;                 //Hour pointer2 has been set.
         hour1InputMode = true;                  //Continue by setting hour pointer1.
-        Serial.println("hour2InputMode");
+        console.println("hour2InputMode");
       }
       else if (hour1InputMode == true) {
         hour1InputMode = false;                 //Hour pointer1 has been set.
         minute2InputMode = true;                //Continue by setting minute pointer2.
-        Serial.println("hour1InputMode");
+        console.println("hour1InputMode");
       }
       else if (minute2InputMode == true) {
         minute2InputMode = false;               //Minute pointer2 has been set.
         minute1InputMode = true;                //Continue by setting minute pointer1.
-        Serial.println("minute2InputMode");
+        console.println("minute2InputMode");
       }
       else if (minute1InputMode == true) {
         minute1InputMode = false;               //Minute pointer1 has been set. Time set is done.
         clockStartMode = true;                  //Start clock. Clock starts ticking.
         clockSetFinished = true;
-        Serial.println("minute1InputMode");
+        console.println("minute1InputMode");
       }
       else if (clockSetFinished == true) {
         clockSetFinished = false;               //Clear current state in display mode.
@@ -1037,7 +1209,7 @@ void toggleDisplayMode() {
         readoutValuesDisplay = true;            //Set next display mode to be printed to display.
         alarmMessageEnabled = true;             //Enable any alarm message to be printed to display.
         greenhouseProgramStart = true;          //Start greenhouse program.
-        Serial.println("clockSetFinished");
+        console.println("clockSetFinished");
       }
     }
     else if (readoutValuesDisplay == true) {
@@ -1045,32 +1217,43 @@ void toggleDisplayMode() {
       alarmMessageEnabled = false;                //Disable any alarm message from being printed to display.
       //SeeedGrayOled.clearDisplay();                   //Clear display.
       serviceModeDisplay = true;                  //Set next display mode to be printed to display.
-      Serial.println("readoutValuesDisplay");
+      console.println("readoutValuesDisplay");
     }
     else if (serviceModeDisplay == true) {
       serviceModeDisplay = false;                 //Clear current screen display mode to enable next display mode to shown next time MODE-button is pressed.
       //SeeedGrayOled.clearDisplay();                   //Clear display.
+      trendChartDisplay = true;                   //Set next display mode to be printed to display.
+      console.println("serviceModeDisplay");
+    }
+    else if (trendChartDisplay == true) {
+      trendChartDisplay = false;                  //Clear current screen display mode to enable next display mode to shown next time MODE-button is pressed.
       readoutValuesDisplay = true;                //Set next display mode to be printed to display.
       alarmMessageEnabled = true;                 //Enable any alarm message from being printed to display.
-      Serial.println("serviceModeDisplay");
+      console.println("trendChartDisplay");
     }
     else if (flowFaultDisplay == true) {
       //flowFaultDisplay = false;                   //Clear current screen display mode to enable next display mode to shown next time MODE-button is pressed.
       //SeeedGrayOled.clearDisplay();                   //Clear display.
-      Serial.println("flowFaultDisplay");
+      console.println("flowFaultDisplay");
       if (allowRestart == true) {
         flowFaultDisplay = false;                   //Clear current screen display mode to enable next display mode to shown next time MODE-button is pressed.
         waterFlowFault = false;                   //Clear water flow fault code.
         allowRestart = false;
-        Serial.println("Go to setTimeDisplay");
+        console.println("Go to setTimeDisplay");
       }
     }
 
     //Check if water flow fault code is active. If active enter flow fault display to handle fault code.
 
     if (waterFlowFault == true) {
+      if (flowFaultDisplay == false) {              //Everything is stopped once, on the way into flow fault display. It stays stopped until the fault code is cleared.
+        waterPumpStop();                            //Stop(OFF) water pump.
+        ledLightStop();                             //Stop(OFF) LED lighting.
+        fanStop();                                  //Stop(OFF) fan.
+      }
       readoutValuesDisplay = false;               //Clear any of current screen display modes to enable next display mode to shown next time MODE-button is pressed.
       serviceModeDisplay = false;
+      trendChartDisplay = false;
       alarmMessageEnabled = false;
       flowFaultDisplay = true;                    //Set next display mode to be printed to display.
       greenhouseProgramStart = false;             //Stop greenhouse program.
@@ -1083,131 +1266,71 @@ void toggleDisplayMode() {
   ===================================================================================================
   || SET CLOCK TIME DISPLAY MODE. Print clock values to OLED display to let user set current time. ||
   =================================================================================================== */
-void setClockDisplay() {
-  blankToDisplay(0, 0, 7);
-  stringToDisplay(0, 7, "SET CLOCK");     //Print current display state to upper right corner of display.
-
-  if (clockStartMode == false) {
-    stringToDisplay(2, 0, "Use controls to ");
-    stringToDisplay(3, 0, "set curr. time: ");
-    blankToDisplay(4, 0, 16);
-    stringToDisplay(5, 0, "ENCODER = +/-   ");
-    blankToDisplay(6, 0, 16);
-    stringToDisplay(7, 0, "MODE = confirm  ");
-    blankToDisplay(8, 0, 16);
-    stringToDisplay(9, 0, "RESET = clear   ");
-    blankToDisplay(10, 0, 16);
-
-
-    //Pointer separator character.
-    stringToDisplay(11, 22, ":");
-    stringToDisplay(11, 25, ":");
-    blankToDisplay(12, 0, 16);
-    blankToDisplay(13, 0, 16);
-    blankToDisplay(14, 0, 16);
-    blankToDisplay(15, 0, 16);
-  }
-  else if (clockStartMode == true) {
-    //Print further instructions when clock start has been activated.
-    stringToDisplay(2, 0, "Clock is ticking");
-    blankToDisplay(3, 0, 16);
-    stringToDisplay(4, 0, "Auto watering,  ");
-    stringToDisplay(5, 0, "lighting & hum- ");
-    stringToDisplay(6, 0, "idity control   ");
-    stringToDisplay(7, 0, "is ready to run ");
-    blankToDisplay(8, 0, 16);
-    stringToDisplay(9, 0, "Time is:        ");
-    blankToDisplay(10, 0, 16);
-    blankToDisplay(12, 0, 16);
-    stringToDisplay(13, 0, "Press MODE to  ");
-    stringToDisplay(14, 0, "continue.      ");
-    blankToDisplay(15, 0, 16);
-
-    //Pointer separater character flash.
-    if (flashClockPointer == true) {
-      SeeedGrayOled.setTextXY(11, 22 * 8);
-      SeeedGrayOled.putString(" ");
-
-      SeeedGrayOled.setTextXY(11, 25 * 8);
-      SeeedGrayOled.putString(" ");
-    }
-    else {
-      SeeedGrayOled.setTextXY(11, 22 * 8);
-      SeeedGrayOled.putString(":");
+//Pointer separator character, flashes when the clock is ticking.
+const char *clockSeparatorText() {
+  return clockStartMode == true && flashClockPointer == true ? " " : ":";
+}
 
-      SeeedGrayOled.setTextXY(11, 25 * 8);
-      SeeedGrayOled.putString(":");
-    }
+//Flashing mark under the clock time pointer that is currently set.
+const char *clockPointerText() {
+  if (flashClockPointer == true) {
+    return "";
   }
-
-  blankToDisplay(11, 0, 4);
-  blankToDisplay(11, 12, 4);
-  numberToDisplay(11, 20, hourPointer2);
-  numberToDisplay(11, 21, hourPointer1);
-  numberToDisplay(11, 23, minutePointer2);
-  numberToDisplay(11, 24, minutePointer1);
-  numberToDisplay(11, 26, secondPointer2);
-  numberToDisplay(11, 27, secondPointer1);
-
-  //Second pointers.
-  /*SeeedGrayOled.setTextXY(11, 26 * 8);
-    SeeedGrayOled.putNumber(secondPointer2);                   //Print second digit of second pointer value to display.
-    SeeedGrayOled.setTextXY(11, 27 * 8);
-    SeeedGrayOled.putNumber(secondPointer1);                   //Print first digit of second pointer value to display.
-  */
-  //Print and flash individual clock time pointers to display which clock parameter that is currently set.
-  //Hour pointer2.
-  if (hour2InputMode == true) {
-    if (flashClockPointer == true) {
-      SeeedGrayOled.setTextXY(12, 20 * 8);
-      SeeedGrayOled.putString(" ");                             //Clear display where 10-digit hour pointer value is located.
-    }
-    else {
-      SeeedGrayOled.setTextXY(12, 20 * 8);                         //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-      SeeedGrayOled.putString("_");                             //Clear display where 10-digit hour pointer value   }
-    }
+  else if (hour2InputMode == true) {
+    return "    _";
+  }
+  else if (hour1InputMode == true) {
+    return "     _";
+  }
+  else if (minute2InputMode == true) {
+    return "       _";
   }
+  else if (minute1InputMode == true) {
+    return "        _";
+  }
+  return "";
+}
 
-  //pushButton = digitalRead(resetButton);                        //Check if SET-button is being pressed.
+const ScreenLabel setClockLabels[] = {
+  {0, 7, "SET CLOCK"},                          //Current display state in upper right corner of display.
+  {2, 0, "Use controls to"},
+  {3, 0, "set curr. time:"},
+  {5, 0, "ENCODER = +/-"},
+  {7, 0, "MODE = confirm"},
+  {9, 0, "RESET = clear"}
+};
 
-  //Hour pointer1.
-  if (hour1InputMode == true) {
-    if (flashClockPointer == true) {
-      blankToDisplay(12, 0, 16);
-      //SeeedGrayOled.setTextXY(12, 21 * 8);
-      //SeeedGrayOled.putString(" ");                             //Clear display where 1-digit hour pointer value is located.
-    }
-    else {
-      SeeedGrayOled.setTextXY(12, 21 * 8);                         //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-      SeeedGrayOled.putString("_");                   //Print 1-digit hour pointer value to display.
-    }
-  }
+//Further instructions when clock start has been activated.
+const ScreenLabel clockStartLabels[] = {
+  {0, 7, "SET CLOCK"},
+  {2, 0, "Clock is ticking"},
+  {4, 0, "Auto watering,"},
+  {5, 0, "lighting & hum-"},
+  {6, 0, "idity control"},
+  {7, 0, "is ready to run"},
+  {9, 0, "Time is:"},
+  {13, 0, "Press MODE to"},
+  {14, 0, "continue."}
+};
 
-  //Minute pointer2.
-  if (minute2InputMode == true) {
-    if (flashClockPointer == true) {
-      blankToDisplay(12, 0, 16);
-      //SeeedGrayOled.setTextXY(12, 23 * 8);
-      //SeeedGrayOled.putString(" ");
-    }
-    else {
-      SeeedGrayOled.setTextXY(12, 23 * 8);
-      SeeedGrayOled.putString("_");
-    }
-  }
+const ScreenField clockFields[] = {
+  {11, 4, 1, SCREEN_INT, &hourPointer2, 0},
+  {11, 5, 1, SCREEN_INT, &hourPointer1, 0},
+  {11, 6, 1, SCREEN_TEXT, 0, clockSeparatorText},
+  {11, 7, 1, SCREEN_INT, &minutePointer2, 0},
+  {11, 8, 1, SCREEN_INT, &minutePointer1, 0},
+  {11, 9, 1, SCREEN_TEXT, 0, clockSeparatorText},
+  {11, 10, 1, SCREEN_INT, &secondPointer2, 0},
+  {11, 11, 1, SCREEN_INT, &secondPointer1, 0},
+  {12, 0, 16, SCREEN_TEXT, 0, clockPointerText}
+};
 
-  //Minute pointer1.
-  if (minute1InputMode == true) {
-    if (flashClockPointer == true) {
-      blankToDisplay(12, 0, 16);
-      //SeeedGrayOled.setTextXY(12, 24 * 8);
-      //SeeedGrayOled.putString(" ");
-    }
-    else {
-      SeeedGrayOled.setTextXY(12, 24 * 8);
-      SeeedGrayOled.putString("_");
-    }
-  }
+const ScreenLayout setClockScreen = {setClockLabels, ARRAY_COUNT(setClockLabels), clockFields, ARRAY_COUNT(clockFields)};
+const ScreenLayout clockStartScreen = {clockStartLabels, ARRAY_COUNT(clockStartLabels), clockFields, ARRAY_COUNT(clockFields)};
+
+void setClockDisplay() {
+  splitClockTime();
+  screen.draw(clockStartMode == true ? clockStartScreen : setClockScreen);
 }
 
 /*
@@ -1215,7 +1338,10 @@ void setClockDisplay() {
   || Compare read out temperature with temperature threshold that has been set by adjusting rotary encoder. ||
   ============================================================================================================ */
 void tempThresholdCompare() {
-  if (tempValue > tempThresholdValue || tempValue < TEMP_VALUE_MIN) {                             //Compare read out temperature value with temperature threshold value set by rotary encoder.
+  if (sensorUsable(SENSOR_TEMPERATURE) == false) {
+    tempValueFault = false;                                        //No temperature alarm on a value that cannot be trusted, the sensor alarm is shown instead.
+  }
+  else if (tempValue > tempThresholdValue || tempValue < TEMP_VALUE_MIN) {                             //Compare read out temperature value with temperature threshold value set by rotary encoder.
     tempValueFault = true;                                         //If measured temperature is higher than temperature threshold that has been set, variable is set to 'true' to alert user.
   }
   else {
@@ -1227,178 +1353,73 @@ void tempThresholdCompare() {
   ========================================================================================================
   || Read temperature threshold set by rotary encoder respectively increas/decrease clock cursor value. ||
   ======================================================================================================== */
-void rotaryEncoderRead() {
+void rotaryEncoderInterrupt() {
   static unsigned long lastInterruptTime = 0;
   unsigned long interruptTime = millis();
-  volatile int virtualPosition = 0;
 
   // If interrupts come faster than 5ms, assume it's a bounce and ignore
   if (interruptTime - lastInterruptTime > 5) {
-    if (digitalRead(rotaryEncoderOutpB) == LOW)
-    {
-      virtualPosition-- ; // Could be -5 or -10
-    }
-    else {
-      virtualPosition++ ; // Could be +5 or +10
-    }
-
-    //Adjust cursor value when in set clock time display mode.
-    if (setTimeDisplay == true) {
-      if (hour2InputMode == true) {
-        hourPointer2 += virtualPosition;                            //Increase/Decrease cursor value whenever rotary encoder knob is turned.
-        if (hourPointer2 == 3) {                                    //If 10-digit hour pointer reaches 3, clear digit.
-          hourPointer2 = 0;
-        }
-        else if (hourPointer2 < 0) {                                //No negative cursor value allowed.
-          hourPointer2 = 0;
-        }
-      }
-      else if (hour1InputMode == true) {
-        hourPointer1 += virtualPosition;                            //Increase/Decrease cursor value whenever rotary encoder knob is turned.
-
-        if (hourPointer2 == 2) {                                    //If hour pointer2 is equal to 2, hour pointer 1 is only allowed to reach a maximum value of 4.
-          if (hourPointer1 == 5) {
-            hourPointer1 = 0;
-          }
-        }
-
-        if (hourPointer1 == 10 || hourPointer1 < 0) {               //If 1-digit hour pointer reaches 10 or is less than zero, clear digit.
-          hourPointer1 = 0;
-        }
-      }
-      else if (minute2InputMode == true) {
-        minutePointer2 += virtualPosition;                          //Increase/Decrease cursor value whenever rotary encoder knob is turned.
-        if (minutePointer2 == 6 || minutePointer2 < 0) {            //If 10-digit minute pointer reaches 6 or is less than zero, clear 10-digit minute pointer.
-          minutePointer2 = 0;
-        }
-      }
-      else if (minute1InputMode == true) {
-        minutePointer1 += virtualPosition;                          //Increase/Decrease cursor value whenever rotary encoder knob is turned.
-        if (minutePointer1 == 10 || minutePointer1 < 0) {           //If 10-digit minute pointer reaches a value of 10, clear 1-digit minute pointer.
-          minutePointer1 = 0;
-        }
-      }
-
-      //Replace clock time represenation. When current clock time is 24 hours is replaced with 00.
-      if (clockStartMode == true) {
-        if (hourPointer2 == 2 && hourPointer1 == 4) {               //If 10-digit hour pointer reaches a value of 2 and 1-digit hour pointer reaches a value of 4 (elapsed time is 24 hours).
-          hourPointer2 = 0;                                         //Clear both hour pointer values.
-          hourPointer1 = 0;
-        }
-      }
-    }
-
-    //Adjust temperature threshold when in readout display mode.
-    else if (readoutValuesDisplay == true) {
-      tempThresholdValue += virtualPosition;
-
-      if (tempThresholdValue >= TEMP_VALUE_MAX) {
-        tempThresholdValue = TEMP_VALUE_MAX;
-      }
-      else if (tempThresholdValue <= TEMP_VALUE_MIN) {
-        tempThresholdValue = TEMP_VALUE_MIN;
-      }
-    }
+    events.push(EVENT_ROTARY_ENCODER, digitalRead(rotaryEncoderOutpB) == LOW ? -1 : 1);   //Direction of the step, the step itself is handled in loop().
+    scheduler.wake();
 
     // Keep track of when we were here last (no more than every 5ms)
     lastInterruptTime = interruptTime;
   }
 }
 
-/*
-  ============================================================================================================
-  || ALARM MESSAGE TO DISPLAY. Print alarm message to OLED display for any fault that is currently active . ||
-  ============================================================================================================ */
-void alarmMessageDisplay() {
-  unsigned long alarmTimeNow;
-  unsigned long alarmTimeDiff;                            //Calculate time difference from when the warning message function was started. Keeps track for how long time each warning message is shown on display.
-
-  //Print multiple warning messages to display, using the same space of display. One alarm message after another.
-  alarmTimeNow = millis();                                //Read millis() value to get the time stamp when first alarm message was printed to display.
-  alarmTimeDiff = alarmTimeNow - alarmTimePrev;
-  //Serial.print("alarmTimeDiff: ");
-  //Serial.println(alarmTimeDiff);
-
-  if (alarmMessageEnabled == true) {                      //Any alarm can only be printed to display if variable is set to 'true'.
-    /******************
-      |Water flow fault.|
-    ******************/
-    if (alarmTimeDiff <= alarmTimePeriod) {
-      SeeedGrayOled.setTextXY(15, 0);                          //Set cordinates to which row that will be cleared.
-      SeeedGrayOled.putString("                ");            //Clear row to enable other warnings to be printed to display.
-      if (waterFlowFault == true) {                       //If fault variable is set to 'true', fault message is printed to display.
-        SeeedGrayOled.setTextXY(15, 0);
-        SeeedGrayOled.putString("NO WATER FLOW");             //Print fault message to display.
+void rotaryEncoderRead(int virtualPosition) {
+  //Adjust cursor value when in set clock time display mode.
+  if (setTimeDisplay == true) {
+    splitClockTime();                                             //Pointers of the current time, the clock kept ticking since they were shown.
+    if (hour2InputMode == true) {
+      hourPointer2 += virtualPosition;                            //Increase/Decrease cursor value whenever rotary encoder knob is turned.
+      if (hourPointer2 == 3) {                                    //If 10-digit hour pointer reaches 3, clear digit.
+        hourPointer2 = 0;
       }
-
-      else {  //If this alarm not active, clear the warning message row.
-        SeeedGrayOled.setTextXY(15, 0);                        //Set cordinates to the warning message will be printed.
-        SeeedGrayOled.putString("                ");          //Clear row to enable other warnings to be printed to display.
+      else if (hourPointer2 < 0) {                                //No negative cursor value allowed.
+        hourPointer2 = 0;
       }
     }
+    else if (hour1InputMode == true) {
+      hourPointer1 += virtualPosition;                            //Increase/Decrease cursor value whenever rotary encoder knob is turned.
 
-    /**********************
-      |Low water tank level.|
-    **********************/
-    if (alarmTimePeriod < alarmTimeDiff && alarmTimeDiff <= alarmTimePeriod * 2) {
-      if (waterLevelFault == true) {                        //If fault variable is set to 'true', fault message is printed to display.
-        SeeedGrayOled.setTextXY(15, 0);                          //Set cordinates to which row that will be cleared.
-        SeeedGrayOled.putString("                ");            //Clear row to enable other warnings to be printed to display.
-        SeeedGrayOled.setTextXY(15, 0);
-        SeeedGrayOled.putString("LOW WATER LEVEL");             //Print fault message to display.
-      }
-      else {  //If this alarm not active, clear the warning message row.
-        SeeedGrayOled.setTextXY(15, 0);                          //Set cordinates to the warning message will be printed.
-        SeeedGrayOled.putString("                ");            //Clear row to enable other warnings to be printed to display.
-      }
-    }
-
-    /*******************
-      |Temperature fault.|
-    *******************/
-    if (alarmTimePeriod * 2 < alarmTimeDiff && alarmTimeDiff <= alarmTimePeriod * 3) {
-      if (tempValueFault == true) {                         //If fault variable is set to 'true', fault message is printed to display.
-        Serial.println("ALARMA!!");
-        if (tempValue > tempThresholdValue) {
-          SeeedGrayOled.setTextXY(15, 0);                          //Set cordinates to which row that will be cleared.
-          SeeedGrayOled.putString("                ");            //Clear row to enable other warnings to be printed to display.
-          SeeedGrayOled.setTextXY(15, 0);
-          SeeedGrayOled.putString("HIGH TEMPERATURE");            //Print fault message to display.
-        }
-        else if (tempValue < TEMP_VALUE_MIN) {
-          SeeedGrayOled.setTextXY(15, 0);                          //Set cordinates to the warning message will be printed.
-          SeeedGrayOled.putString("                ");            //Clear row to enable other warnings to be printed to display.
-          SeeedGrayOled.setTextXY(15, 0);
-          SeeedGrayOled.putString("LOW TEMPERATURE");            //Print fault message to display.
+      if (hourPointer2 == 2) {                                    //If hour pointer2 is equal to 2, hour pointer 1 is only allowed to reach a maximum value of 3.
+        if (hourPointer1 == 4) {
+          hourPointer1 = 0;
         }
       }
-      else {  //If this alarm not active, clear the warning message row.
-        SeeedGrayOled.setTextXY(15, 0);                          //Set cordinates to the warning message will be printed.
-        SeeedGrayOled.putString("                ");            //Clear row to enable other warnings to be printed to display.
+
+      if (hourPointer1 == 10 || hourPointer1 < 0) {               //If 1-digit hour pointer reaches 10 or is less than zero, clear digit.
+        hourPointer1 = 0;
       }
     }
-
-    /********************
-      |LED lighting fault.|
-    ********************/
-    if (alarmTimePeriod * 3 < alarmTimeDiff && alarmTimeDiff <= alarmTimePeriod * 4) {
-      if (ledLightFault == true) {                          //If fault variable is set to 'true', fault message is printed to display.
-        SeeedGrayOled.setTextXY(15, 0);                          //Set cordinates to which row that will be cleared.
-        SeeedGrayOled.putString("                ");            //Clear row to enable other warnings to be printed to display.
-        SeeedGrayOled.setTextXY(15, 0);
-        SeeedGrayOled.putString("LED NOT WORKING");             //If measured water flow is below a certain value without the water level sensor indicating the water tank is empty, there is a problem with the water tank hose. "Check water hose!" is printed to display.
+    else if (minute2InputMode == true) {
+      minutePointer2 += virtualPosition;                          //Increase/Decrease cursor value whenever rotary encoder knob is turned.
+      if (minutePointer2 == 6 || minutePointer2 < 0) {            //If 10-digit minute pointer reaches 6 or is less than zero, clear 10-digit minute pointer.
+        minutePointer2 = 0;
       }
-      else {  //If this alarm not active, clear the warning message row.
-        SeeedGrayOled.setTextXY(15, 0);                          //Set cordinates to the warning message will be printed.
-        SeeedGrayOled.putString("                ");            //Clear row to enable other warnings to be printed to display.
+    }
+    else if (minute1InputMode == true) {
+      minutePointer1 += virtualPosition;                          //Increase/Decrease cursor value whenever rotary encoder knob is turned.
+      if (minutePointer1 == 10 || minutePointer1 < 0) {           //If 10-digit minute pointer reaches a value of 10, clear 1-digit minute pointer.
+        minutePointer1 = 0;
       }
     }
 
-    if (alarmTimeDiff > alarmTimePeriod * 4) {
-      SeeedGrayOled.setTextXY(15, 0);                          //Set cordinates to the warning message will be printed.
-      SeeedGrayOled.putString("                ");            //Clear row to enable other warnings to be printed to display.
-      alarmTimePrev = millis();                           //Read millis() value to reset time delay calculation.
+    joinClockTime();                                              //Set the clock to the pointers.
+  }
+
+  //Adjust temperature threshold when in readout display mode.
+  else if (readoutValuesDisplay == true) {
+    tempThresholdValue += virtualPosition;
+
+    if (tempThresholdValue >= TEMP_VALUE_MAX) {
+      tempThresholdValue = TEMP_VALUE_MAX;
+    }
+    else if (tempThresholdValue <= TEMP_VALUE_MIN) {
+      tempThresholdValue = TEMP_VALUE_MIN;
     }
+    sensors.hurry(SENSOR_TEMPERATURE);                            //Threshold moved, temperature may be near it.
   }
 }
 
@@ -1406,129 +1427,100 @@ void alarmMessageDisplay() {
   ===========================================================================
   || SERVICE MODE DISPLAY MODE. Print service mode screen to OLED display. ||
   =========================================================================== */
-void viewServiceMode() {
-  //Clear symbols from previous display mode.
-  blankToDisplay(0, 0, 4);
-
-  blankToDisplay(2, 6, 2);
-  blankToDisplay(3, 0, 16);
-  blankToDisplay(4, 9, 7);
-  blankToDisplay(5, 3, 3);
-  blankToDisplay(5, 8, 1);
-  blankToDisplay(5, 12, 3);
-  blankToDisplay(6, 3, 3);
-  blankToDisplay(6, 8, 1);
-  blankToDisplay(6, 12, 3);
-
-  blankToDisplay(7, 0, 16);
-  blankToDisplay(8, 12, 4);
-  blankToDisplay(9, 10, 6);
-
-  blankToDisplay(10, 9, 7);
-  blankToDisplay(11, 10, 6);
-  blankToDisplay(12, 11, 5);
-
-  blankToDisplay(13, 0, 16);
-
-  stringToDisplay(0, 4, "SERVICE MODE");  //Print current display state to upper right corner of display.
-
-  if (wifiClockCompleted == false) {
-    blankToDisplay(15, 0, 16);
-  }
-
-  //Display clock.
-  stringToDisplay(2, 0, "Clock:");
-
-  //Hour pointerS.
-  SeeedGrayOled.setTextXY(2, 8 * 8);                         //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(hourPointer2);                    //Print 10-digit hour pointer value to display.
-  SeeedGrayOled.setTextXY(2, 9 * 8);                         //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(hourPointer1);                    //Print 1-digit hour pointer value to display.
-
-  stringToDisplay(2, 10, ":");
-
-  //Minute pointers.
-  SeeedGrayOled.setTextXY(2, 11 * 8);                         //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(minutePointer2);                  //Print 10-digit hour pointer value to display.
-  SeeedGrayOled.setTextXY(2, 12 * 8);                         //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(minutePointer1);                  //Print 1-digit hour pointer value to display.
-
-  stringToDisplay(2, 13, ":");
-
-  //Second pointers.
-  SeeedGrayOled.setTextXY(2, 14 * 8);
-  SeeedGrayOled.putNumber(secondPointer2);                  //Print second digit of second pointer value to display.
-  SeeedGrayOled.setTextXY(2, 15 * 8);
-  SeeedGrayOled.putNumber(secondPointer1);                  //Print first digit of second pointer value to display.
-
-
-  //Display moisture sensor values.
-  SeeedGrayOled.setTextXY(4, 0);                            //Set cordinates to where it will print text. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putString("Moisture:");                     //Print text to display.
-
-  SeeedGrayOled.setTextXY(5, 0);
-  SeeedGrayOled.putString("S1[");                           //Print text to display.
-  SeeedGrayOled.setTextXY(5, 3 * 8);                         //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(moistureValue1);                  //Print moisture sensor1 value.
-  SeeedGrayOled.setTextXY(5, 6 * 8);
-  SeeedGrayOled.putString("],");
-
-  SeeedGrayOled.setTextXY(5, 9 * 8);
-  SeeedGrayOled.putString("S2[");                           //Print text to display.
-  SeeedGrayOled.setTextXY(5, 12 * 8);                         //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(moistureValue2);                  //Print moisture sensor1 value.
-  SeeedGrayOled.setTextXY(5, 15 * 8);
-  SeeedGrayOled.putString("]");
-
-  SeeedGrayOled.setTextXY(6, 0);
-  SeeedGrayOled.putString("S3[");                           //Print text to display.
-  SeeedGrayOled.setTextXY(6, 3 * 8);                         //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(moistureValue3);                  //Print moisture sensor1 value.
-  SeeedGrayOled.setTextXY(6, 6 * 8);
-  SeeedGrayOled.putString("],");
-
-  SeeedGrayOled.setTextXY(6, 9 * 8);
-  SeeedGrayOled.putString("S4[");                           //Print text to display.
-  SeeedGrayOled.setTextXY(6, 12 * 8);                         //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(moistureValue4);                  //Print moisture sensor1 value.
-  SeeedGrayOled.setTextXY(6, 15 * 8);
-  SeeedGrayOled.putString("]");
-
-  //Fault code status.
-  stringToDisplay(8, 0, "Fault codes:");
-  SeeedGrayOled.setTextXY(9, 0);
-  SeeedGrayOled.putString("tempValue:");                    //Print text to display.
-  SeeedGrayOled.setTextXY(9, 12 * 8);                       //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(tempValueFault);                  //Print tempValueFault status.
+const char *wifiText() {
+  return wifiClockCompleted == true ? "Yes" : "NO";
+}
+
+const char *clockSyncText() {
+  return wifiClockCompleted == true ? "*Clock in sync" : "*No clock sync!";
+}
 
-  SeeedGrayOled.setTextXY(10, 0);
-  SeeedGrayOled.putString("ledLight:");                     //Print text to display.
-  SeeedGrayOled.setTextXY(10, 12 * 8);                      //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(ledLightFault);                   //Print ledLightFault status.
+const ScreenLabel serviceLabels[] = {
+  {0, 4, "SERVICE MODE"},                       //Current display state in upper right corner of display.
+  {2, 0, "Clock:"},
+  {2, 10, ":"},
+  {2, 13, ":"},
+  {4, 0, "Moisture:"},
+  {5, 0, "S1["},
+  {5, 7, "]"},
+  {5, 8, "S2["},
+  {5, 15, "]"},
+  {6, 0, "S3["},
+  {6, 7, "]"},
+  {6, 8, "S4["},
+  {6, 15, "]"},
+  {8, 0, "Fault codes:"},
+  {9, 0, "tempValue:"},
+  {10, 0, "ledLight:"},
+  {11, 0, "waterFlow:"},
+  {12, 0, "waterLevel:"},
+  {13, 0, "Watered ml:"},
+  {14, 0, "Wifi conn.:"}
+};
 
-  SeeedGrayOled.setTextXY(11, 0);
-  SeeedGrayOled.putString("waterFlow:");                    //Print text to display.
-  SeeedGrayOled.setTextXY(11, 12 * 8);                      //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(waterFlowFault);                  //Print waterFlowFault status.
+const ScreenField serviceFields[] = {
+  {2, 8, 1, SCREEN_INT, &hourPointer2, 0},
+  {2, 9, 1, SCREEN_INT, &hourPointer1, 0},
+  {2, 11, 1, SCREEN_INT, &minutePointer2, 0},
+  {2, 12, 1, SCREEN_INT, &minutePointer1, 0},
+  {2, 14, 1, SCREEN_INT, &secondPointer2, 0},
+  {2, 15, 1, SCREEN_INT, &secondPointer1, 0},
+  {5, 3, 4, SCREEN_INT, &moistureValue1, 0},
+  {5, 11, 4, SCREEN_INT, &moistureValue2, 0},
+  {6, 3, 4, SCREEN_INT, &moistureValue3, 0},
+  {6, 11, 4, SCREEN_INT, &moistureValue4, 0},
+  {9, 12, 1, SCREEN_BOOL, &tempValueFault, 0},
+  {10, 12, 1, SCREEN_BOOL, &ledLightFault, 0},
+  {11, 12, 1, SCREEN_BOOL, &waterFlowFault, 0},
+  {12, 12, 1, SCREEN_BOOL, &waterLevelFault, 0},
+  {13, 11, 5, SCREEN_UNSIGNED, &waterToday, 0},
+  {14, 12, 3, SCREEN_TEXT, 0, wifiText},
+  {15, 0, 16, SCREEN_TEXT, 0, clockSyncText}
+};
+
+const ScreenLayout serviceScreen = {serviceLabels, ARRAY_COUNT(serviceLabels), serviceFields, ARRAY_COUNT(serviceFields)};
+
+void viewServiceMode() {
+  splitClockTime();
+  screen.draw(serviceScreen);
+}
+
+/*
+  ===================================================================================
+  || TREND CHART DISPLAY MODE. Print moisture, temperature and humidity over time. ||
+  =================================================================================== */
+const ScreenLabel trendLabels[] = {
+  {0, 5, "TRENDS"},                             //Current display state in upper right corner of display.
+  {1, 0, "Moisture"},
+  {6, 0, "Temp *C"},
+  {11, 0, "Humidity pct"}
+};
 
-  SeeedGrayOled.setTextXY(12, 0);
-  SeeedGrayOled.putString("waterLevel:");                   //Print text to display.
-  SeeedGrayOled.setTextXY(12, 12 * 8);                      //Set cordinates to where any text print will be printed to display. X = row (0-7), Y = column (0-127).
-  SeeedGrayOled.putNumber(waterLevelFault);                 //Print waterLevelFault status.
+//Top of each strip next to its name, bottom on the row below the strip.
+const ScreenField trendFields[] = {
+  {1, 13, 3, SCREEN_INT, &trendTop[0], 0},
+  {5, 13, 3, SCREEN_INT, &trendBottom[0], 0},
+  {6, 13, 3, SCREEN_INT, &trendTop[1], 0},
+  {10, 13, 3, SCREEN_INT, &trendBottom[1], 0},
+  {11, 13, 3, SCREEN_INT, &trendTop[2], 0},
+  {15, 13, 3, SCREEN_INT, &trendBottom[2], 0}
+};
 
-  SeeedGrayOled.setTextXY(14, 0);
-  SeeedGrayOled.putString("Wifi conn.: ");
+const ScreenLayout trendScreen = {trendLabels, ARRAY_COUNT(trendLabels), trendFields, ARRAY_COUNT(trendFields)};
 
-  SeeedGrayOled.setTextXY(14, 12 * 8);
-  if (wifiClockCompleted == true) {
-    SeeedGrayOled.putString("Yes");
-    SeeedGrayOled.setTextXY(15, 0);
-    SeeedGrayOled.putString("*Clock in sync ");
+void viewTrendChart() {
+  if (screen.draw(trendScreen) == true) {       //Display was cleared for this screen, the chart is drawn again from history.
+    trendChart.invalidate();
   }
-  else {
-    SeeedGrayOled.putString("NO ");
-    SeeedGrayOled.setTextXY(15, 0);
-    SeeedGrayOled.putString("*No clock sync!");
+  if (trendChart.draw() == true) {              //Ranges may have changed, update the range labels.
+    for (uint8_t i = 0; i < ARRAY_COUNT(trendSeries); i++) {
+      int16_t bottom = 0;
+      int16_t top = 0;
+      trendChart.range(i, bottom, top);
+      trendBottom[i] = bottom / TREND_LABEL_DIVISOR[i];
+      trendTop[i] = top / TREND_LABEL_DIVISOR[i];
+    }
+    screen.draw(trendScreen);
   }
 }
 
@@ -1536,51 +1528,31 @@ void viewServiceMode() {
   ==========================================================================================
   || Calculate moisture mean value from moisture measurements and evaluate soil humidity. ||
   ========================================================================================== */
-int calculateMoistureMean(int moistureValue1, int moistureValue2, int moistureValue3, int moistureValue4) {
-  int moistureValues[4] = {moistureValue1, moistureValue2, moistureValue3, moistureValue4};
-  int moistureMax = 0;                                      //Variable used to store a moisture value when comparing it to other moisture sensor values and finally store the highest moisture value.
-  int moistureMin = moistureValues[0];                      //First value in array of values used as reference value. Variable used to store a moisture value when comparing it to other moisture sensor values and finally store the lowest moisture value.
-  int maxIndex;                                             //Index in array for max moisture value.
-  int minIndex;                                             //Index in array for min moisture value.
-  int moistureSum = 0;
-  int moistureMean;                                         //Stores the moisture mean value before returned to main program.
-
-  //Since 4 different moisture sensors are used to measure soil moisture in the four different post and specific watering for each individual pots is not possible. The watering action is only based upon a mean value of the moisture readouts. Min and max value are sorted out and not used in case any sensor is not working correctly.
-  for (int i = 0; i < sizeof(moistureValues) / sizeof(int); i++) { //Looping through all measured moisture values to find the highest and lowest moisture values.
-    if (moistureValues[i] > moistureMax) {                  //Identify the highest measured moisture value.
-      moistureMax = moistureValues[i];
-      maxIndex = i;                                         //Identify which moisture sensor that has the max value to be able to delete it from mean moisture value calculation.
-    }
-
-    if (moistureValues[i] <= moistureMin) {                 //Identify the lowest measured moisture value.
-      moistureMin = moistureValues[i];
-      minIndex = i;                                         //Identify which moisture sensor that has the min value to be able to delete it from mean moisture value calculation.
+//Moisture of each zone from its probes that can be used, and the mean of all of them for the display. A zone is neither dry nor wet when none of its probes can be used.
+void updateMoistureMean() {
+  int16_t values[4];
+  uint8_t usable = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    if (sensorUsable(SENSOR_MOISTURE1 + i) == true) {
+      values[usable++] = sensors.value(SENSOR_MOISTURE1 + i);
     }
   }
-
-  //Remove maximum and minimum moisture values from moisture array.
-  moistureValues[minIndex] = 0;
-  moistureValues[maxIndex] = 0;
-
-  for (int i = 0; i < sizeof(moistureValues) / sizeof(int); i++) {
-    moistureSum += moistureValues[i];                       //Sum the remaining moisture sensor values.
+  AggregateResult moisture = aggregate(values, usable, MOISTURE_AGGREGATE);
+  if (moisture.count > 0) {
+    moistureMeanValue = moisture.mean;
   }
-  moistureMean = moistureSum / 2;                           //Calculate mean moisture value with max and min values excluded.
 
-  //Evaluate soil humidity based on moisture mean value.
-  if (moistureMean <= MOISTURE_THRESHOLD_LOW) {               //Soil humidity is too low.
-    moistureDry = true;                                     //Variables used by checkWaterNeed-function to determine if water pump should be enabled.
-    moistureWet = false;
-  }
-  else if (moistureMean > MOISTURE_THRESHOLD_LOW && moistureMean <= MOISTURE_THRESHOLD_HIGH) { //Soil humidity is good.
-    moistureWet = false;                                    //Variables used by checkWaterNeed-function to determine if water pump should be enabled.
-    moistureDry = false;
-  }
-  else if (moistureMean > MOISTURE_THRESHOLD_HIGH) {          //Soil humidity is to high.
-    moistureWet = true;                                     //Variables used by checkWaterNeed-function to determine if water pump should be enabled.
-    moistureDry = false;
+  for (uint8_t zone = 0; zone < irrigation.size(); zone++) {
+    usable = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+      if ((irrigation.zone(zone).probes & (1 << i)) && sensorUsable(SENSOR_MOISTURE1 + i) == true) {
+        values[usable++] = sensors.value(SENSOR_MOISTURE1 + i);
+      }
+    }
+    irrigation.evaluate(zone, aggregate(values, usable, MOISTURE_AGGREGATE));
   }
-  return moistureMean;
+  moistureDry = irrigation.anyDry();                        //Variables used by the display and alarms, the water pump goes by each zone.
+  moistureWet = irrigation.anyWet();
 }
 
 /*
@@ -1619,6 +1591,7 @@ void resetStartupVariables() {
     readoutValuesDisplay = false;
     serviceModeDisplay = false;
     flowFaultDisplay = false;
+    trendChartDisplay = false;
 
     waterPumpEnabled = false;
     ledLightEnabled = false;
@@ -1648,6 +1621,7 @@ void resetStartupVariables() {
     readoutValuesDisplay = false;
     serviceModeDisplay = false;
     flowFaultDisplay = false;
+    trendChartDisplay = false;
 
     waterPumpEnabled = false;
     ledLightEnabled = false;
@@ -1661,96 +1635,80 @@ void resetStartupVariables() {
   =========================================================================
   || FLOW FAULT DISPLAY MODE. Print service mode screen to OLED display. ||
   ========================================================================= */
-void resolveFlowFault() {
-  //Clear symbols from previous display mode.
-  blankToDisplay(0, 0, 2);
-  blankToDisplay(1, 0, 16);
-  blankToDisplay(2, 13, 3);
-  blankToDisplay(3, 0, 16);
-
-  blankToDisplay(5, 15, 1);
-
-  blankToDisplay(7, 14, 2);
-  blankToDisplay(8, 0, 16);
-  blankToDisplay(9, 5, 11);
-  blankToDisplay(10, 0, 16);
-
-  blankToDisplay(12, 15, 1);
-  blankToDisplay(13, 11, 5);
-  blankToDisplay(14, 0, 16);
-  blankToDisplay(15, 12, 4);
-
-
-  stringToDisplay(0, 2, "RSLV FLOWFAULT");          //Print current display state to upper right corner of display.
-
-  stringToDisplay(2, 0, "Chk hardware!");
-
-  stringToDisplay(4, 0, "* Water in hose?");
-  stringToDisplay(5, 0, "* Hose tangled?");
-  stringToDisplay(6, 0, "* Vacum in tank?");
-  stringToDisplay(7, 0, "* Any leakage?");
+const char *restartText() {
+  return pushButton == true ? "YES" : "NO";
+}
 
-  stringToDisplay(9, 0, "DONE?");
+const ScreenLabel flowFaultLabels[] = {
+  {0, 2, "RSLV FLOWFAULT"},                     //Current display state in upper right corner of display.
+  {2, 0, "Chk hardware!"},
+  {4, 0, "* Water in hose?"},
+  {5, 0, "* Hose tangled?"},
+  {6, 0, "* Vacum in tank?"},
+  {7, 0, "* Any leakage?"},
+  {9, 0, "DONE?"},
+  {11, 0, "Press SET-button"},
+  {12, 0, "keep it pressed"},
+  {13, 0, "to restart."},
+  {15, 0, "Restart:"}
+};
 
-  stringToDisplay(11, 0, "Press SET-button");
-  stringToDisplay(12, 0, "keep it pressed");
-  stringToDisplay(13, 0, "to restart.");
+const ScreenField flowFaultFields[] = {
+  {15, 9, 3, SCREEN_TEXT, 0, restartText}
+};
 
-  stringToDisplay(15, 0, "Restart: ");
+const ScreenLayout flowFaultScreen = {flowFaultLabels, ARRAY_COUNT(flowFaultLabels), flowFaultFields, ARRAY_COUNT(flowFaultFields)};
 
+void resolveFlowFault() {
   actionRegister = 8;     //Clear action register printed to display.
 
-  static bool toggle1 = false;
+  screen.draw(flowFaultScreen);
   if (pushButton == true) {
     allowRestart = true;
-    stringToDisplay(15, 9, "YES");
+    SeeedGrayOled.flush();                                //Send screen to display before waiting.
     delay(4000);
     resetStartupVariables();
   }
-  else {
-    stringToDisplay(15, 9, "NO ");
-  }
 }
 
-
 /*
   ================================================================
   || WiFi functions for posting readout values to server below. ||
   ================================================================ */
 void printWifiStatus() {
   // print the SSID of the network you're attached to:
-  Serial.print("SSID: ");
-  Serial.println(WiFi.SSID());
+  console.print("SSID: ");
+  console.println(WiFi.SSID());
 
   // print your board's IP address:
   IPAddress ip = WiFi.localIP();
-  Serial.print("IP Address: ");
-  Serial.println(ip);
+  console.print("IP Address: ");
+  console.println(ip);
 
   // print the received signal strength:
   long rssi = WiFi.RSSI();
-  Serial.print("signal strength (RSSI):");
-  Serial.print(rssi);
-  Serial.println(" dBm");
+  console.print("signal strength (RSSI):");
+  console.print(rssi);
+  console.println(" dBm");
 }
 
 bool connectWiFi() {
   bool cnt = false;
   // check for the WiFi module:
   if (WiFi.status() == WL_NO_MODULE) {
-    Serial.println("Communication with WiFi module failed!");
+    console.println("Communication with WiFi module failed!");
     // don't continue
     while (true);
   }
 
   String fv = WiFi.firmwareVersion();
   if (fv < "1.0.0") {
-    Serial.println("Please upgrade the firmware");
+    console.println("Please upgrade the firmware");
   }
   unsigned int tryConnectingCounter = 0;
   while ((tryConnectingCounter++ < 6) && (status != WL_CONNECTED)) {
-    Serial.print("Attempting to connect to SSID: ");
-    Serial.println(ssid);
+    console.print("Attempting to connect to SSID: ");
+    console.println(ssid);
     // Connect to WPA/WPA2 network. Change this line if using open or WEP network:
     status = WiFi.begin(ssid, pass);
 
@@ -1758,14 +1716,14 @@ bool connectWiFi() {
     delay(1000);
   }
 
-  Serial.println("Connected to wifi");
+  console.println("Connected to wifi");
   printWifiStatus();
 
-  Serial.println("\nStarting connection to server...");
+  console.println("\nStarting connection to server...");
   if (1 == Udp.begin(localPort))cnt = true;
   //delay(10000);
-  Serial.print(cnt);
-  Serial.println(" connectionStatus");
+  console.print(cnt);
+  console.println(" connectionStatus");
   return cnt;
 }
 
@@ -1778,173 +1736,434 @@ void setupTimerInterrupt() {
 
   while (RTC.STATUS != 0) {
     //Wait until the CTRLABUSY bit in register is cleared before writing to CTRLA register.
-    Serial.println("waiting for 1");
+    console.println("waiting for 1");
   }
   RTC.CLKSEL = 0x00;        //32.768 kHz signal from OSCULP32K selected.
-  RTC.PERL = 0x0A;                         //Lower part of 16,384 value in PER-register (PERL) to be used as overflow value to reset the RTC counter.
-  RTC.PERH = 0x10;                         //Upper part of 16,384 value in PER-register (PERH) to be used as overflow value to reset the RTC counter.
+  RTC.PERL = 0xFF;                         //Lower part of 4095 value in PER-register (PERL). Counter overflows every 4096 ticks = 125 ms, 8 times per second.
+  RTC.PERH = 0x0F;                         //Upper part of 4095 value in PER-register (PERH) to be used as overflow value to reset the RTC counter.
   RTC.INTCTRL = (RTC.INTCTRL & 0b11111100) | 0b01;      //Enable interrupt-on-counter overflow by setting OVF-bit in INCTRL register.
   while (RTC.STATUS != 0) {
     //Wait until the CTRLABUSY bit in register is cleared before writing to CTRLA register.
-    Serial.println("waiting for 2");
+    console.println("waiting for 2");
   }
   RTC.CTRLA = 0x05;           //PRESCALER set to 1024 (0b0) Not using prescaler, CORREN enabled (0b100),  RTCEN bit set to 1 (0b1).
 
   while (RTC.STATUS != 0) {
     //Wait until the CTRLABUSY bit in register is cleared before writing to CTRLA register.
-    Serial.println("waiting for 3");
+    console.println("waiting for 3");
   }
-  Serial.println("RTC config complete");
+  rtcClock.begin();                                             //Internal UTC clock starts counting with the RTC.
+  console.println("RTC config complete");
 
   sei();                                                        //Allow external interrupt again.
 }
 
-void getTimeOverNetwork() {
-  sendNTPpacket(timeServer); // send an NTP packet to a time server
-  // wait to see if a reply is available
-  delay(500);
-  if (Udp.parsePacket()) {
-    Serial.println("packet received");
-    // We've received a packet, read the data from it
-    Udp.read(packetBuffer, NTP_PACKET_SIZE); // read the packet into the buffer
-
-    //the timestamp starts at byte 40 of the received packet and is four bytes,
-    // or two words, long. First, esxtract the two words:
-
-    unsigned long highWord = word(packetBuffer[40], packetBuffer[41]);
-    unsigned long lowWord = word(packetBuffer[42], packetBuffer[43]);
-    // combine the four bytes (two words) into a long integer
-    // this is NTP time (seconds since Jan 1 1900):
-    unsigned long secsSince1900 = highWord << 16 | lowWord;
-    Serial.print("Seconds since Jan 1 1900 = ");
-    Serial.println(secsSince1900);
-
-    // now convert NTP time into everyday time:
-    Serial.print("Unix time = ");
-    // Unix time starts on Jan 1 1970. In seconds, that's 2208988800:
-    const unsigned long seventyYears = 2208988800UL;
-    // subtract seventy years:
-    unsigned long epoch = secsSince1900 - seventyYears;
-    // print Unix time:
-    Serial.println(epoch);
-
-    unsigned int currentTime;
-    unsigned short currentHour;
-    unsigned short currentMinute;
-    unsigned short currentSecond;
-
-    currentHour = (epoch % 86400) / 3600 + 2;     //Added two hours to compensate for summer time.
-    currentMinute = (epoch % 3600) / 60;
-    currentSecond = epoch % 60;
-
-    //Determine if hour value currently has two digits and specify it.
-    if ((currentHour / 10) >= 1) {
-      hourPointer2 = currentHour / 10;
-
-      //Determine lower hour digit when current hour value consists of two digits.
-      hourPointer1 = currentHour - hourPointer2 * 10;
+//Read the internal clock. The RTC interrupt may change it in the middle of reading its four bytes, read until two reads agree.
+unsigned long clockTime() {
+  unsigned long seconds;
+  do {
+    seconds = clockSeconds;
+  } while (seconds != clockSeconds);
+  return seconds;
+}
+
+//Clock time in minutes of the day, 0 at midnight. Compare with CLOCK_TIME().
+unsigned short clockMinuteOfDay() {
+  return (clockTime() % 86400UL) / 60;
+}
+
+//True from 'start' up to 'stop', minutes of the day. A window that stops before it starts is open over midnight.
+bool timeWindowOpen(unsigned short minuteOfDay, unsigned short start, unsigned short stop) {
+  if (start <= stop) {
+    return minuteOfDay >= start && minuteOfDay < stop;
+  }
+  return minuteOfDay >= start || minuteOfDay < stop;
+}
+
+//Split the internal clock into clock pointers, for the display and the set clock mode.
+void splitClockTime() {
+  unsigned long secondOfDay = clockTime() % 86400UL;
+  unsigned short currentHour = secondOfDay / 3600;
+  unsigned short currentMinute = (secondOfDay % 3600) / 60;
+  unsigned short currentSecond = secondOfDay % 60;
+  hourPointer2 = currentHour / 10;
+  hourPointer1 = currentHour % 10;
+  minutePointer2 = currentMinute / 10;
+  minutePointer1 = currentMinute % 10;
+  secondPointer2 = currentSecond / 10;
+  secondPointer1 = currentSecond % 10;
+}
+
+//Set hours and minutes of the internal clock to the clock pointers, keeping the day and the seconds.
+void joinClockTime() {
+  unsigned short currentHour = hourPointer2 * 10 + hourPointer1;
+  if (currentHour > 23) {                 //Hour pointer1 was above 3 when hour pointer2 was set to 2.
+    currentHour = 23;
+  }
+  noInterrupts();                         //Clock is also changed by the RTC interrupt.
+  unsigned long day = clockSeconds - clockSeconds % 86400UL;
+  clockSeconds = day + currentHour * 3600UL + (minutePointer2 * 10 + minutePointer1) * 60UL + clockSeconds % 60;
+  interrupts();
+}
+
+//Set the internal clock to local time of the UTC clock. Runs after each NTP sync and every minute, to follow summer/winter time changes.
+void syncClockTime() {
+  unsigned long utc = rtcClock.unixTime();
+  long zoneOffset = localTimeZone.toLocal(utc) - utc;
+
+  noInterrupts();                       //Clock is also changed by the RTC interrupt, read the time again with it held off.
+  clockSeconds = rtcClock.unixTime() + zoneOffset;
+  interrupts();
+}
+
+/*
+  =================================================================
+  || Scheduled tasks. Run from loop() by the scheduler when due. ||
+  ================================================================= */
+//Print current clock time.
+void clockPrintTask() {
+  splitClockTime();
+  console.print(hourPointer2);
+  console.print(hourPointer1);
+  console.print(": ");
+  console.print(minutePointer2);
+  console.print(minutePointer1);
+  console.print(": ");
+  console.print(secondPointer2);
+  console.println(secondPointer1);
+  console.print("wifi: ");
+  console.println(WiFi.SSID());    //FIXA SÅ ATT WIFI-NAMNET STÅR HÄR!!
+}
+
+//Different functions to run depending of which display mode that is currently active.
+void displayTask() {
+  if (startupImageDisplay == true) {
+    viewStartupImage();                                             //Initialize the OLED Display and show startup images.
+  }
+  else if (setTimeDisplay == true) {                                //Display time set screen only if current time has not been set.
+    setClockTime();
+    setClockDisplay();
+  }
+  else if (readoutValuesDisplay == true) {                          //Only display read out values after current time on internal clock, has been set.
+    viewReadoutValues();                                            //Print read out values from the greenhouse to display.
+  }
+  else if (serviceModeDisplay == true) {
+    viewServiceMode();                                              //Service mode screen is printed to display.
+  }
+  else if (trendChartDisplay == true) {
+    viewTrendChart();                                               //Trend chart of moisture, temperature and humidity.
+  }
+  else if (flowFaultDisplay == true) {
+    resolveFlowFault();                                             //Water flow fault display mode is printed to display. It contains fault code instruction and possibility to reset fault code. Outputs were stopped on the way in.
+  }
+
+  SeeedGrayOled.flush();                                            //Send everything drawn to the display, only tiles that changed.
+}
+
+//Step the DHT-sensor read cycle. The sensor tells when it needs attention next, a new frame is decoded in the background. A new frame is only asked for when temperature or humidity is due.
+void humiditySensorTask() {
+  bool receiving = humiditySensor.busy();
+  if (receiving == false) {
+    unsigned long temperatureWait = sensors.untilDue(SENSOR_TEMPERATURE);
+    unsigned long humidityWait = sensors.untilDue(SENSOR_HUMIDITY);
+    unsigned long wait = temperatureWait < humidityWait ? temperatureWait : humidityWait;
+    if (wait > 0) {
+      scheduler.after(wait, humiditySensorTask);
+      return;
+    }
+  }
+
+  unsigned long wait = humiditySensor.update();
+  if (receiving == true && humiditySensor.busy() == false) {         //Frame done. A failed or rejected one is not stored, the channels stay due and are asked for again.
+    float temperature = humiditySensor.readTemperature(false);
+    float humidity = humiditySensor.readHumidity();
+    if (humiditySensor.status() != DHT_OK || isnan(temperature) == true || isnan(humidity) == true) {   //Timeout or checksum error, the values are from the frame before.
+      failReading(SENSOR_TEMPERATURE);
+      failReading(SENSOR_HUMIDITY);
     }
     else {
-      hourPointer2 = 0;
-      hourPointer1 = currentHour;
+      if (storeReading(SENSOR_TEMPERATURE, lround(temperature * 10)) == true) {
+        tempValue = temperature;
+      }
+      if (storeReading(SENSOR_HUMIDITY, lround(humidity * 10)) == true) {
+        humidityValue = humidity;
+      }
     }
+  }
+  scheduler.after(wait, humiditySensorTask);
+}
 
-    //Determine if minute value currently has two digits and specify it.
-    if ((currentMinute / 10) >= 1) {
-      minutePointer2 = currentMinute / 10;
-
-      //Determine lower minute digit when current minute value consists of two digits.
-      minutePointer1 = currentMinute - minutePointer2 * 10;
+//One step of bringing wifi back, without waiting for it: WiFi.begin() is sent on one run and WiFi.status() looked at on the runs after. Returns the time (in milliseconds) until the next step.
+unsigned long wifiReconnectStep() {
+  uint8_t wifiStatus = WiFi.status();
+  if (wifiStatus == WL_CONNECTED) {
+    if (WiFiConnected == false) {
+      console.println("Connected to wifi");
+      Udp.begin(localPort);
     }
-    else {
-      minutePointer2 = 0;
-      minutePointer1 = currentMinute;
+    WiFiConnected = true;
+    wifiJoining = false;
+    wifiRetryWait = WIFI_RETRY_MIN;
+    return 0;
+  }
+  WiFiConnected = false;
+  if (wifiStatus == WL_NO_MODULE) {
+    return WIFI_RETRY_MAX;                                          //Nothing to connect with, look again now and then.
+  }
+  if (wifiJoining == true && wifiStatus != WL_CONNECT_FAILED && millis() - wifiJoinAt < WIFI_JOIN_TIMEOUT) {
+    return 1000;
+  }
+  if (wifiJoining == true) {
+    console.println("Wifi connection failed");
+    WiFi.end();
+    wifiJoining = false;
+    unsigned long wait = wifiRetryWait;
+    wifiRetryWait = wifiRetryWait * 2 < WIFI_RETRY_MAX ? wifiRetryWait * 2 : WIFI_RETRY_MAX;
+    return wait;
+  }
+  console.print("Attempting to connect to SSID: ");
+  console.println(ssid);
+  WiFi.end();
+  WiFi.setTimeout(0);                                               //begin() returns at once, the connection comes up in the background.
+  WiFi.begin(ssid, pass);
+  wifiJoining = true;
+  wifiJoinAt = millis();
+  return 1000;
+}
+
+//Sync internal clock with NTP-server. The client sends a request and collects the answer on a later run, it tells when it needs to run next.
+void ntpTask() {
+  //Wifi never came up or is lost: the clock keeps running on the RTC while wifi is brought back, then syncs.
+  if (WiFiConnected == false || (ntpClient.failures() > 0 && WiFi.status() != WL_CONNECTED)) {
+    unsigned long retry = wifiReconnectStep();
+    if (WiFiConnected == false) {
+      wifiClockCompleted = ntpClient.age() < NTP_SYNC_STALE;
+      scheduler.after(retry, ntpTask);
+      return;
     }
+  }
 
-    //Determine if second value currently has two digits and specify it.
-    if (currentSecond / 10 >= 1) {
-      secondPointer2 = currentSecond / 10;
+  unsigned long wait = ntpClient.update();
 
-      //Determine lower second digit when current second value consists of two digits.
-      secondPointer1 = currentSecond - secondPointer2 * 10;
+  if (ntpClient.newTime() == true) {
+    int64_t offset = ntpClient.offset();
+    unsigned long interval = clockSynced == true ? rtcClock.unixTime() - lastSyncTime : 0;
+    if (rtcClock.discipline(offset, interval) == true) {             //Far off, e.g. first sync: jump to NTP time. Smaller offsets are slewed away. Drift is learned from how much the clock was off since last sync.
+      ntpSyncPeriod = NTP_SYNC_PERIOD_MIN;
+      console.println("Clock set from NTP");
     }
     else {
-      secondPointer2 = 0;
-      secondPointer1 = currentSecond;
+      //Sync less often while the clock keeps time, more often when it does not.
+      if (offset < NTP_GOOD_OFFSET && offset > -NTP_GOOD_OFFSET && ntpSyncPeriod < NTP_SYNC_PERIOD_MAX) {
+        ntpSyncPeriod = ntpSyncPeriod * 2 < NTP_SYNC_PERIOD_MAX ? ntpSyncPeriod * 2 : NTP_SYNC_PERIOD_MAX;
+      }
+      else if ((offset > 4 * NTP_GOOD_OFFSET || offset < -4 * NTP_GOOD_OFFSET) && ntpSyncPeriod > NTP_SYNC_PERIOD_MIN) {
+        ntpSyncPeriod = ntpSyncPeriod / 2 > NTP_SYNC_PERIOD_MIN ? ntpSyncPeriod / 2 : NTP_SYNC_PERIOD_MIN;
+      }
+      console.print("NTP offset (ms): "); console.println((long)(offset * 1000 >> 32));
     }
+    console.print("NTP delay (ms): "); console.println(ntpClient.delay() / 1000);
+    console.print("RTC drift (ppm): "); console.println(rtcClock.drift());
 
+    if (clockSynced == false) {
+      scheduler.every(60000, syncClockTime);
+    }
+    clockSynced = true;
+    lastSyncTime = rtcClock.unixTime();
+    syncClockTime();
+    ntpClient.setPollInterval(ntpSyncPeriod);
+    wait = ntpSyncPeriod;
+  }
+  wifiClockCompleted = ntpClient.age() < NTP_SYNC_STALE;
+  scheduler.after(wait, ntpTask);
+}
 
-    if (fanState == true) {
-      fanRpm();
+//Read out sensor values, calculate values and check fault codes. Only run when greenhouse program has started, greenhouseProgramStart set 'true'.
+void readSensorsTask() {
+  if (greenhouseProgramStart == false) {
+    return;
+  }
+  uint8_t moistureDue = 0;                                                           //Moisture sensors to read, one bit each.
+  for (uint8_t i = 0; i < moistureSensors.size(); i++) {
+    if (sensors.due(SENSOR_MOISTURE1 + i) == true) {
+      moistureDue |= 1 << i;
     }
+  }
+  moistureSensors.startRead(moistureDue);                                            //Moisture sensors convert while the other sensors are read.
 
-    //Time delay for calculating water flow.
-    if (waterPumpState == true) {
-      waterFlow();
+  tempThresholdCompare();                                                                              //Temperature and humidity are read by humiditySensorTask().
+
+  //Light sensor measures when asked to, and is read when it signals the measurement. The INT pin stays low until it is read, so a measurement whose interrupt was missed (e.g. before the interrupt was attached) is read here.
+  if (digitalRead(lightSensorInt) == LOW) {
+    lightRead();
+  }
+  else if (lightForced == true && millis() - lightForcedAt >= LIGHT_SAMPLE_TIMEOUT) {
+    lightForced = false;                                                             //No measurement came: the sensor did not get the command or is gone.
+    failReading(SENSOR_LIGHT);
+    failReading(SENSOR_UV);
+  }
+  if (lightForced == false && (sensors.due(SENSOR_LIGHT) == true || sensors.due(SENSOR_UV) == true)) {
+    lightSensor.ForceALS();
+    lightForced = true;
+    lightForcedAt = millis();
+  }
+
+  waterLevelRead();                                                                                     //Check water level in water tank.
+
+  moistureSensors.finishRead();                                                      //Collect moisture values to check soil humidity.
+  for (uint8_t i = 0; i < moistureSensors.size(); i++) {
+    if (moistureDue & (1 << i)) {
+      storeReading(SENSOR_MOISTURE1 + i, moistureSensors.value(i));
     }
+  }
+  moistureValue1 = sensors.value(SENSOR_MOISTURE1);                                  //Last readings that passed the health checks.
+  moistureValue2 = sensors.value(SENSOR_MOISTURE2);
+  moistureValue3 = sensors.value(SENSOR_MOISTURE3);
+  moistureValue4 = sensors.value(SENSOR_MOISTURE4);
+  updateMoistureMean();
+
+  console.print("Capacitive1: "); console.println(moistureValue1);
+  console.print("Capacitive2: "); console.println(moistureValue2);
+  console.print("Capacitive3: "); console.println(moistureValue3);
+  console.print("Capacitive4: "); console.println(moistureValue4);
+}
+
+//Check current time and light need, turn LED lighting and fan ON/OFF.
+void lightNeedTask() {
+  if (greenhouseProgramStart == false) {
+    return;
+  }
+  if (actionRegister != 4) {                  //If water pump is not running set follwing value to register.
+    actionRegister = 1;                         //Register to print what action that is currently performed in the greenhouse program.
+  }
+  checkLightNeed();                               //Enable/Disable start of LED lighting.
+  if (ledLightEnabled == true) {
+    ledLightStart();                              //Start(ON) LED lighting.
+  }
+  else if (ledLightEnabled == false) {
+    ledLightStop();                               //Stop(OFF) LED lighting.
+  }
+  if (fanEnabled == true) {
+    fanStart();                                   //Start(ON) fan.
+  }
+  else {
+    fanStop();                                    //Stop(OFF) LED lighting.
+  }
+}
 
-    //Convert clock pointer into single int variable. Value of this variable represent clock time.
-    currentClockTime = 0;
-    currentClockTime += (hourPointer2 * 1000);
-    currentClockTime += (hourPointer1 * 100);
-    currentClockTime += (minutePointer2 * 10);
-    currentClockTime += minutePointer1;
+//Check soil moisture and start water pump when soil is too dry. Water pump is stopped and water flow checked by follow-up tasks scheduled in waterPumpStart().
+void moistureTask() {
+  if (greenhouseProgramStart == false) {
+    return;
+  }
+  if (actionRegister != 4) {                  //If water pump is not running set follwing value to register.
+    actionRegister = 2;                         //Register to print what action that is currently performed in the greenhouse program.
+  }
+  checkWaterNeed();                               //Enable/Disable start of water pump.
+  humiditySpeedControl();                         //Check air humidity to activate any of the two fan speed modes.
+  //Start water pump for the next dry zone, one zone at a time. Not for a zone without a moisture value to go by, e.g. when all its sensors are dead.
+  uint8_t zone = irrigation.next();
+  if (waterPumpEnabled == true && waterPumpState == false && zone != IRRIGATION_IDLE) {
+    actionRegister = 4;                         //Register to print what action that is currently performed in the greenhouse program.
+    waterPumpStart(zone);                           //Start water pump (ON).
+  }
+}
 
-    if (currentClockTime < 60) {          //Prevent clock time from seeing 00:00 as less than 23:00.
-      currentClockTime += 2400;
+//Stop water pump when the water dose has been delivered, or after it has run for WATER_PUMP_TIME_PERIOD.
+void waterPumpFinished() {
+  actionRegister = 8;                           //Register to print what action that is currently performed in the greenhouse program.
+  waterPumpStop();                              //Stop water pump (OFF).
+  waterPumpEnabled = false;                     //Disable water pump from running until next time moisture value readout.
+}
+
+//Store one sample of all sensor values in history. Print last hour of air humidity once per hour.
+void historyTask() {
+  if (greenhouseProgramStart == false) {
+    return;
+  }
+  countWater(0);                                  //Start counting a new day at local midnight, also when no water is pumped.
+  historySample[HISTORY_MOISTURE1] = moistureValue1;
+  historySample[HISTORY_MOISTURE2] = moistureValue2;
+  historySample[HISTORY_MOISTURE3] = moistureValue3;
+  historySample[HISTORY_MOISTURE4] = moistureValue4;
+  if (isnan(tempValue) == false) {                                  //DHT-sensor gives NaN when it could not be read, then last value is kept.
+    historySample[HISTORY_TEMPERATURE] = tempValue * 10;
+  }
+  if (isnan(humidityValue) == false) {
+    historySample[HISTORY_HUMIDITY] = humidityValue * 10;
+  }
+  historySample[HISTORY_LIGHT] = lightValue < 32767 ? lightValue : 32767;
+  historySample[HISTORY_UV] = uvValue;
+  historySample[HISTORY_WATER_FLOW] = waterFlowValue;
+  historySample[HISTORY_FAN_SPEED] = fanSpeedValue;
+  history.add(historySample);
+
+  HistorySummary humidity;
+  if (history.count() % 60 == 0 && history.summary(HISTORY_HUMIDITY, 60, humidity) == true) {
+    console.print("Humidity last hour (mean/min/max %): ");
+    console.print(humidity.mean / 10.0); console.print(" / ");
+    console.print(humidity.min / 10.0); console.print(" / ");
+    console.println(humidity.max / 10.0);
+  }
+}
+
+//Send all sensor values, outputs and fault codes as a binary telemetry frame when any of them changed.
+void telemetryTask() {
+  TelemetryRecord record;
+  record.time = rtcClock.unixTime();
+  record.moisture[0] = moistureValue1;
+  record.moisture[1] = moistureValue2;
+  record.moisture[2] = moistureValue3;
+  record.moisture[3] = moistureValue4;
+  record.temperature = isnan(tempValue) == false ? (int16_t)(tempValue * 10) : TELEMETRY_NO_VALUE;
+  record.humidity = isnan(humidityValue) == false ? (int16_t)(humidityValue * 10) : TELEMETRY_NO_VALUE;
+  record.light = lightValue;
+  record.uv = uvValue;
+  record.waterFlow = waterFlowValue;
+  record.fanSpeed = fanSpeedValue;
+  record.waterToday = waterToday;
+  record.tempThreshold = tempThresholdValue;
+  record.outputs = (waterPumpState == true ? TELEMETRY_PUMP : 0)
+                   | (ledLightState == true ? TELEMETRY_LED_LIGHTING : 0)
+                   | (fanState == true ? TELEMETRY_FAN : 0)
+                   | (fanState == true && lowFanSpeedEnabled == true ? TELEMETRY_FAN_LOW_SPEED : 0);
+  record.faults = (moistureDry == true ? TELEMETRY_MOISTURE_DRY : 0)
+                  | (moistureWet == true ? TELEMETRY_MOISTURE_WET : 0)
+                  | (tempValueFault == true ? TELEMETRY_TEMPERATURE_HIGH : 0)
+                  | (waterFlowFault == true ? TELEMETRY_WATER_FLOW : 0)
+                  | (waterLevelFault == true ? TELEMETRY_WATER_LEVEL : 0)
+                  | (ledLightFault == true ? TELEMETRY_LED_LIGHTING_FAULT : 0);
+  record.status = (greenhouseProgramStart == true ? TELEMETRY_PROGRAM_STARTED : 0)
+                  | (WiFi.status() == WL_CONNECTED ? TELEMETRY_WIFI_CONNECTED : 0)
+                  | (wifiClockCompleted == true ? TELEMETRY_CLOCK_SYNCED : 0);
+  record.action = actionRegister;
+  telemetry.update(record);
+}
+
+//Handle the events pushed by the interrupts since the last pass.
+void handleEvents() {
+  Event event;
+  while (events.pop(event) == true) {
+    if (event.type == EVENT_MODE_BUTTON) {
+      toggleDisplayMode();
     }
-    wifiClockCompleted = true;
-  }
-}
-
-void setTime() {
-  if (WiFiConnected) {
-    //check status
-    getTimeOverNetwork();
-    if (WiFi.status() != WL_CONNECTED)
-    {
-      WiFi.end();
-      status = WL_IDLE_STATUS;
-      connectWiFi();
-      if (WiFi.status() != WL_CONNECTED) {
-        Serial.println("Wifi connection failed");
-        WiFi.end();
-        setupTimerInterrupt();
-        WiFiConnected = false;
-        timerInterruptHasSetup = true;
-      }
+    else if (event.type == EVENT_ROTARY_ENCODER) {
+      rotaryEncoderRead(event.value);
+    }
+    else if (event.type == EVENT_LIGHT_SAMPLE) {
+      lightRead();
     }
   }
 }
 
-// send an NTP request to the time server at the given address
-unsigned long sendNTPpacket(IPAddress & address) {
-  //Serial.println("1");
-  // set all bytes in the buffer to 0
-  memset(packetBuffer, 0, NTP_PACKET_SIZE);
-  // Initialize values needed to form NTP request
-  // (see URL above for details on the packets)
-  //Serial.println("2");
-  packetBuffer[0] = 0b11100011;   // LI, Version, Mode
-  packetBuffer[1] = 0;     // Stratum, or type of clock
-  packetBuffer[2] = 6;     // Polling Interval
-  packetBuffer[3] = 0xEC;  // Peer Clock Precision
-  // 8 bytes of zero for Root Delay & Root Dispersion
-  packetBuffer[12]  = 49;
-  packetBuffer[13]  = 0x4E;
-  packetBuffer[14]  = 49;
-  packetBuffer[15]  = 52;
-
-  //Serial.println("3");
-
-  // all NTP fields have been given values, now
-  // you can send a packet requesting a timestamp:
-  Udp.beginPacket(address, 123); //NTP requests are to port 123
-  //Serial.println("4");
-  Udp.write(packetBuffer, NTP_PACKET_SIZE);
-  //Serial.println("5");
-  Udp.endPacket();
-  //Serial.println("6");
+//Fan speed and water flow are calculated from the time between the last sensor pulses.
+void pulseCountTask() {
+  if (fanState == true) {
+    fanRpm();
+  }
+  if (waterPumpState == true) {
+    waterFlow();
+  }
 }
 
 /*
@@ -1955,10 +2174,10 @@ void setup() {
   // put your setup code here, to run once:
   Serial.begin(9600);
 
-  moistureSensor1.start(0x36);
-  moistureSensor2.start(0x37);
-  moistureSensor3.start(0x38);
-  moistureSensor4.start(0x39);
+  moistureSensors.add(0x36);
+  moistureSensors.add(0x37);
+  moistureSensors.add(0x38);
+  moistureSensors.add(0x39);
 
   //OLED display setup.
   Wire.begin();
@@ -1966,6 +2185,7 @@ void setup() {
   SeeedGrayOled.clearDisplay();                         //Clear display.
   SeeedGrayOled.setVerticalMode();
   SeeedGrayOled.setNormalDisplay();                     //Set display to normal mode (non-inverse mode).
+  SeeedGrayOled.beginFramebuffer();                     //Draw into RAM, only changed tiles are sent to the display by flush().
   SeeedGrayOled.setTextXY(0, 0);                        //Set cordinates where to print text to display.
   SeeedGrayOled.putString("GREENHOUSE v.1");
   SeeedGrayOled.setTextXY(2, 0);                        //Set cordinates where to print text to display.
@@ -1982,16 +2202,16 @@ void setup() {
   SeeedGrayOled.putString("file: arduino_-");
   SeeedGrayOled.setTextXY(15, 0);
   SeeedGrayOled.putString("secrets.h");
+  SeeedGrayOled.flush();                                //Send screen to display before waiting.
   delay(1000);
   //Wifi setup.
   connectWiFi();
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("Wifi connection failed");
+    console.println("Wifi connection failed");
     WiFi.end();
-    setupTimerInterrupt();
     WiFiConnected = false;
-    timerInterruptHasSetup = true;
   }
+  setupTimerInterrupt();                            //Internal clock always runs on the RTC, NTP only corrects it.
 
   pinMode(waterFlowSensor, INPUT);
   pinMode(fanSpeedSensor, INPUT);
@@ -2004,24 +2224,45 @@ void setup() {
 
   pinMode(resetButton, INPUT);
   pinMode(modeButton, INPUT);
+  pinMode(lightSensorInt, INPUT_PULLUP);       //INT output of the light sensor is open drain, low while a measurement waits to be read.
 
   //Interupt pins.
   attachInterrupt(13, fanRotationCount, RISING);  //Initialize interrupt to water flow sensor to calculate water flow pumped by water pump.
-  attachInterrupt(11, rotaryEncoderRead, LOW); //Initialize interrupt to toggle set modes when in clock set mode or toggling screen display mode when greenhouse program is running. Interrupt is triggered by modeButton being pressed.
+  attachInterrupt(11, rotaryEncoderInterrupt, LOW); //Initialize interrupt to toggle set modes when in clock set mode or toggling screen display mode when greenhouse program is running. Interrupt is triggered by modeButton being pressed.
   attachInterrupt(3, waterFlowCount, RISING);  //Initialize interrupt to enable calculation of fan speed when it is running.
-  attachInterrupt(2, toggleDisplayMode, RISING); //Initialize interrupt to toggle set modes when in clock set mode or toggling screen display mode when greenhouse program is running. Interrupt is triggered by modeButton being pressed.
+  attachInterrupt(2, modeButtonInterrupt, RISING); //Initialize interrupt to toggle set modes when in clock set mode or toggling screen display mode when greenhouse program is running. Interrupt is triggered by modeButton being pressed.
+  attachInterrupt(lightSensorInt, lightSensorInterrupt, FALLING); //Initialize interrupt to read the light sensor when it has a new measurement.
 
   humiditySensor.begin();                           //Initializing humidity sensor.
 
   lightSensor.Begin();                              //Initializing light sensor.
 
   relay.begin(0x11);
+  relay.setVerifyInterval(RELAY_VERIFY_PERIOD);
 
   while (!lightSensor.Begin()) {
-    Serial.println("lightSensor is not ready!");
+    console.println("lightSensor is not ready!");
     delay(1000);
   }
-  Serial.println("lightsensor is ready!");
+  lightSensor.SetALSADC(LIGHT_ADC_GAIN, LIGHT_ADC_COUNTER);
+  lightSensor.SetMeasRate(0);                       //No measurements of its own, readSensorsTask() asks for them.
+  console.println("lightsensor is ready!");
+
+  //Periodic work run from loop().
+  scheduler.every(DISPLAY_REFRESH_PERIOD, displayTask);
+  scheduler.every(READ_SENSORS_PERIOD, readSensorsTask);
+  scheduler.every(CHECK_LIGHT_NEED_PERIOD, lightNeedTask);
+  scheduler.every(CHECK_MOISTURE_PERIOD, moistureTask);
+  scheduler.every(PULSE_RATE_PERIOD, pulseCountTask);
+  scheduler.every(HISTORY_PERIOD, historyTask);
+  if (BINARY_TELEMETRY == true) {
+    scheduler.every(TELEMETRY_PERIOD, telemetryTask);
+  }
+  else {
+    scheduler.every(1000, clockPrintTask);
+  }
+  scheduler.after(0, humiditySensorTask);
+  scheduler.after(0, ntpTask);                      //Also without wifi at boot, it keeps trying to connect.
 }
 
 /*
@@ -2034,145 +2275,9 @@ void loop() {
   //Set current time and toggle between different screen display modes.
   pushButton = digitalRead(resetButton);                        //Check if RESET-button is being pressed.
 
-  //Syncronize clock time with NTP-server or initiate and run using internal timer in case wifi is not available.
-  setTime();
-
-  //Print current clock time.
-  Serial.print(hourPointer2);
-  Serial.print(hourPointer1);
-  Serial.print(": ");
-  Serial.print(minutePointer2);
-  Serial.print(minutePointer1);
-  Serial.print(": ");
-  Serial.print(secondPointer2);
-  Serial.println(secondPointer1);
-  Serial.print("wifi: ");
-  Serial.println(WiFi.SSID());    //FIXA SÅ ATT WIFI-NAMNET STÅR HÄR!!
-
-  //Different functions to run depending of which display mode that is currently active.
-  if (startupImageDisplay == true) {
-    viewStartupImage();                                             //Initialize the OLED Display and show startup images.
-  }
-  else if (setTimeDisplay == true) {                                //Display time set screen only if current time has not been set.
-    setClockTime();
-    setClockDisplay();
-  }
-  else if (readoutValuesDisplay == true) {                          //Only display read out values after current time on internal clock, has been set.
-    viewReadoutValues();                                            //Print read out values from the greenhouse to display.
-  }
-  else if (serviceModeDisplay == true) {
-    viewServiceMode();                                              //Service mode screen is printed to display.
-  }
-  else if (flowFaultDisplay == true) {
-    resolveFlowFault();                                             //Water flow fault display mode is printed to display. It contains fault code instruction and possibility to reset fault code.
-
-    waterPumpStop();                                                //Stop(OFF) water pump.
-    ledLightStop();                                                 //Stop(OFF) LED lighting.
-    fanStop();                                                      //Stop(OFF) fan.
-  }
-
-  //Greenhouse program start. When set to 'true' sensor readouts are enabled and automatic water and lighting control of greenhouse is turned ON.
-  if (greenhouseProgramStart == true) {
-    //Continuesly read out sensor values, calculate values and alert user if any fault code is set. This part of program is only run when greenhouse program has started, greenhouseProgramStart set 'true'.
-    moistureValue1 = moistureSensor1.moistureRead();                                   //Read moistureSensor1 value to check soil humidity.
-    moistureValue2 = moistureSensor2.moistureRead();                                   //Read moistureSensor2 value to check soil humidity.
-    moistureValue3 = moistureSensor3.moistureRead();                                   //Read moistureSensor3 value to check soil humidity.
-    moistureValue4 = moistureSensor4.moistureRead();                                   //Read moistureSensor4 value to check soil humidity.
-    moistureMeanValue = calculateMoistureMean(moistureValue1, moistureValue2, moistureValue3, moistureValue4);    //Mean value from all sensor readouts.
-
-    Serial.print("Capacitive1: "); Serial.println(moistureValue1);
-    Serial.print("Capacitive2: "); Serial.println(moistureValue2);
-    Serial.print("Capacitive3: "); Serial.println(moistureValue3);
-    Serial.print("Capacitive4: "); Serial.println(moistureValue4);
-
-    tempValue = humiditySensor.readTemperature(false);                                                    //Read temperature value from DHT-sensor. "false" gives the value in °C.
-
-    humidityValue = humiditySensor.readHumidity();                                                           //Read humidity value from DHT-sensor.
-    tempThresholdCompare();
-
-    //Read light sensor with a less frequency than the rest of the value readouts.
-    unsigned long readLightCurrent;
-
-    lightRead();                                                                                          //Read light sensor, light and UV value.
-
-    waterLevelRead();                                                                                     //Check water level in water tank.
-
-    alarmMessageDisplay();                                                                                //Print alarm messages to display for any faults that is currently active. Warning messages on display will alert user to take action to solve a certain fault.
-
-    //Check readout light value according to a time cycle and turn led lighting ON/OFF based on the readout.
-    unsigned long checkLightNeedCurrent;
-
-    checkLightNeedCurrent = millis();                 //Get current time stamp from millis().
-    if (checkLightNeedCurrent - checkLightNeedStart >= CHECK_LIGHT_NEED_PERIOD) { //Check if time period has elapsed.
-      if (actionRegister != 4) {                  //If water pump is not running set follwing value to register.
-        actionRegister = 1;                         //Register to print what action that is currently performed in the greenhouse program.
-      }
-      checkLightNeed();                               //Time period has elapsed. Enable/Disable start of LED lighting.
-      if (ledLightEnabled == true) {
-        ledLightStart();                              //Start(ON) LED lighting.
-      }
-      else if (ledLightEnabled == false) {
-        ledLightStop();                               //Stop(OFF) LED lighting.
-      }
-      if (fanEnabled == true) {
-        fanStart();                                   //Start(ON) fan.
-      }
-      else {
-        fanStop();                                    //Stop(OFF) LED lighting.
-      }
-      checkLightNeedStart = millis();                 //Get current time stamp from millis() to make it loop.
-    }
-
-    //Check readout light value after led lighting has been turned on. This will check if led lighting is working. If not it will set an alarm.
-    unsigned long checkLightFaultCurrent;
-
-    if (ledLightState == true) {
-      checkLightFaultCurrent = millis();              //Get current time stamp from millis().
-      if (checkLightFaultCurrent - checkLightFaultStart >= CHECK_LIGHT_FAULT_PERIOD) { //Check if time period has elapsed.
-        ledLightCheck();                              //Time period has elapsed. Check if LED lighting is working.
-        checkLightFaultStart = millis();              //Get current time stamp from millis() to make it loop.
-      }
-    }
-
-    //Check readout moisture value according to a time cycle and enable water pump to start.
-    unsigned long checkMoistureCurrent;
-
-    checkMoistureCurrent = millis();                  //Get current time stamp from millis().
-    if (checkMoistureCurrent - checkMoistureStart >= CHECK_MOISTURE_PERIOD) {   //Check if time period has elapsed.
-      if (actionRegister != 4) {                  //If water pump is not running set follwing value to register.
-        actionRegister = 2;                         //Register to print what action that is currently performed in the greenhouse program.
-      }
-      checkWaterNeed();                               //Time period has elapsed. Enable/Disable start of water pump.
-      humiditySpeedControl();                         //Check air humidity to activate any of the two fan speed modes.
-      //Start water pump.
-      if (waterPumpEnabled == true) {
-        actionRegister = 4;                         //Register to print what action that is currently performed in the greenhouse program.
-        waterPumpStart();                               //Start water pump (ON).
-        waterPumpTimeStart = millis();                //Get current time stamp from millis() to make it loop.
-        checkWaterFlowStart = millis();               //Get current time stamp from millis() to make it loop.
-      }
-      checkMoistureStart = millis();                  //Get current time stamp from millis() to make it loop.
-    }
-
-    //Stop water pump after it has run for a certain amount of time.
-    unsigned long waterPumpTimeCurrent;
-
-    if (waterPumpState == true) {
-      waterPumpTimeCurrent = millis();                  //Get current time stamp from millis().
-      if (waterPumpTimeCurrent - waterPumpTimeStart >= WATER_PUMP_TIME_PERIOD) { //Check if time period has elapsed.
-        actionRegister = 8;                           //Register to print what action that is currently performed in the greenhouse program.
-        waterPumpStop();                              //Time period has elapsed. Stop water pump (OFF).
-        waterPumpEnabled = false;                     //Disable water pump from running until next time moisture value readout.
-      }
-    }
-
-    //Check if water is being pumped when water pump is running by checking the water flow sensor. If not it will set an alarm.
-    unsigned long checkWaterFlowCurrent;
-
-    if (waterPumpState == true) {
-      //checkWaterFlowCurrent = millis();                 //Get current time stamp of millis().
-      //if (checkWaterFlowCurrent - checkWaterFlowStart >= CHECK_WATER_FLOW_PERIOD) {    //Check if time period has elapsed.
-      //waterFlowCheck();                             //Time period has elapsed. Check water flow.
-    }
-  }
+  //Handle button presses and encoder steps, run readouts, checks and display updates that are due, then sleep until the next one is or an interrupt has pushed an event. Interrupts keep running while asleep.
+  handleEvents();
+  scheduler.run();
+  relay.commit();                                               //Relay changes made by the tasks are sent together, in one write and only if something changed.
+  scheduler.sleep();
 }
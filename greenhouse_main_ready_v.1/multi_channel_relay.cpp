@@ -33,6 +33,11 @@ void Multi_Channel_Relay::begin(int address)
 {
   Wire.begin();  
   channel_state = 0;
+  staged_state = 0;
+  verify_interval = 0;
+  verified_at = millis();
+  verify_failures = 0;
+  read_failures = 0;
 	_i2cAddr = address;
   
 }
@@ -58,14 +63,23 @@ void Multi_Channel_Relay::changeI2CAddress(uint8_t old_addr, uint8_t new_addr)
   _i2cAddr = new_addr;
 }
 
-uint8_t Multi_Channel_Relay::getChannelState(void)
+bool Multi_Channel_Relay::getChannelState(uint8_t &state)
 {
-	return channel_state;
+  Wire.beginTransmission(_i2cAddr);
+  Wire.write(CMD_CHANNEL_CTRL);
+  Wire.endTransmission();
+
+  if (Wire.requestFrom(_i2cAddr, 1) != 1) {
+    return false;  // Wire.read() would give -1, every channel on
+  }
+  state = Wire.read();
+  return true;
 }
 
 void Multi_Channel_Relay::channelCtrl(uint8_t state)
 {
   channel_state = state;
+  staged_state = state;
 
   Wire.beginTransmission(_i2cAddr); 
   Wire.write(CMD_CHANNEL_CTRL);
@@ -75,22 +89,62 @@ void Multi_Channel_Relay::channelCtrl(uint8_t state)
 
 void Multi_Channel_Relay::turn_on_channel(uint8_t channel)
 {
-  channel_state |= (1 << (channel-1));
-
-  Wire.beginTransmission(_i2cAddr); 
-  Wire.write(CMD_CHANNEL_CTRL);
-  Wire.write(channel_state);
-  Wire.endTransmission();
+  stage(channel, true);
+  commit();
 }
 
 void Multi_Channel_Relay::turn_off_channel(uint8_t channel)
 {
-  channel_state &= ~(1 << (channel-1));
-  
-  Wire.beginTransmission(_i2cAddr); 
-  Wire.write(CMD_CHANNEL_CTRL);
-  Wire.write(channel_state);
-  Wire.endTransmission();
+  stage(channel, false);
+  commit();
+}
+
+void Multi_Channel_Relay::stage(uint8_t channel, bool on)
+{
+  if (on) {
+    staged_state |= (1 << (channel-1));
+  }
+  else {
+    staged_state &= ~(1 << (channel-1));
+  }
+}
+
+bool Multi_Channel_Relay::commit(void)
+{
+  // A board that was reset or missed a write is told its state again
+  bool mismatch = false;
+  if (verify_interval > 0 && millis() - verified_at >= verify_interval) {
+    verified_at = millis();
+    uint8_t state;
+    if (!getChannelState(state)) {
+      read_failures++;
+    }
+    else if (state != (uint8_t)channel_state) {
+      verify_failures++;
+      mismatch = true;
+    }
+  }
+
+  if (staged_state == (uint8_t)channel_state && !mismatch) {
+    return false;
+  }
+  channelCtrl(staged_state);
+  return true;
+}
+
+void Multi_Channel_Relay::setVerifyInterval(unsigned long interval)
+{
+  verify_interval = interval;
+}
+
+uint16_t Multi_Channel_Relay::getVerifyFailures(void)
+{
+  return verify_failures;
+}
+
+uint16_t Multi_Channel_Relay::getReadFailures(void)
+{
+  return read_failures;
 }
 
 uint8_t Multi_Channel_Relay::scanI2CDevice(void)
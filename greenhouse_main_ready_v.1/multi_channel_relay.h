@@ -36,6 +36,8 @@
 	#define DEBUG_PRINT SerialUSB
 #elif defined(ARDUINO_ARCH_STM32F4)	
 	#define DEBUG_PRINT SerialUSB
+#elif defined(ARDUINO_ARCH_MEGAAVR)
+	#define DEBUG_PRINT Serial
 #else
 	#pragma message("Not match any architecture.")
 	#define DEBUG_PRINT Serial
@@ -78,11 +80,12 @@ class Multi_Channel_Relay{
 		void changeI2CAddress(uint8_t new_addr, uint8_t old_addr);
 
 		/** 
-		 * /brief Get channel state
-		 * /return One byte value to indicate channel state
+		 * /brief Get channel state, read back from the relay board
+		 * /param state One byte value to indicate channel state
 		 * 				 the bits range from 0 to 7 represents channel 1 to 8 
+		 * /return false if the board did not answer, state is then unchanged
 		*/
-		uint8_t getChannelState(void);
+		bool getChannelState(uint8_t &state);
 
 		/**
 		 * @brief Read firmware version from on board MCU  
@@ -99,19 +102,60 @@ class Multi_Channel_Relay{
 		void channelCtrl(uint8_t state);
 
 		/**
-		 * @brief Turn on one of 8 channels
+		 * @brief Turn on one of 8 channels, written only if it is off
 		 * @param channel, channel to control with (range form 1 to 8)
 		 * @return None  
 		*/
 		void turn_on_channel(uint8_t channel);
 
 		/**
-		 * @brief Turn off on of 8 channels
+		 * @brief Turn off on of 8 channels, written only if it is on
 		 * @param channel, channel to control with (range form 1 to 8)
 		 * @return None  
 		*/
 		void turn_off_channel(uint8_t channel);
 
+		/**
+		 * @brief Set the state one channel should get at the next commit(),
+		 *        nothing is sent to the board
+		 * @param channel, channel to control with (range form 1 to 8)
+		 *        on, true to turn the channel on
+		 * @return None  
+		*/
+		void stage(uint8_t channel, bool on);
+
+		/**
+		 * @brief Send the staged state of all channels in one write, if it
+		 *        differs from what the board was last told. When the verify
+		 *        interval has passed the board state is read back first and
+		 *        written again if it does not match. A read back that gets
+		 *        no answer is counted apart and not compared.
+		 * @param
+		 * @return true if the state was written  
+		*/
+		bool commit(void);
+
+		/**
+		 * @brief How often commit() reads the board state back
+		 * @param interval, milliseconds, 0 to never read back
+		 * @return None  
+		*/
+		void setVerifyInterval(unsigned long interval);
+
+		/**
+		 * @brief Read backs that did not match the state written
+		 * @param
+		 * @return count  
+		*/
+		uint16_t getVerifyFailures(void);
+
+		/**
+		 * @brief Read backs the board did not answer
+		 * @param
+		 * @return count  
+		*/
+		uint16_t getReadFailures(void);
+
 		/**
 		 * @brief Scan I2C device, return the address if there is only one i2c device
 		 * @param
@@ -121,7 +165,12 @@ class Multi_Channel_Relay{
 	
 	private:
 		int _i2cAddr;  //  This is the I2C address you want to use 
-		int channel_state;  // Value to save channel state
+		int channel_state;  // Value to save channel state, as last written to the board
+		uint8_t staged_state;  // State for the next commit()
+		unsigned long verify_interval;
+		unsigned long verified_at;  // millis() of the last read back
+		uint16_t verify_failures;
+		uint16_t read_failures;
 };
 
 
@@ -0,0 +1,658 @@
+/*
+ * greenhouse_rig.cpp
+ * Device models for the greenhouse hardware, driven in virtual time.
+ */
+
+#include "greenhouse_rig.h"
+#include "hal/Arduino.h"
+#include "hal/sim.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace rig {
+namespace {
+
+//Wiring, see the pin table at the top of the sketch.
+const uint8_t MODE_BUTTON_PIN = 2;
+const uint8_t FLOW_SENSOR_PIN = 3;
+const uint8_t DHT_PIN = 4;
+const uint8_t SET_BUTTON_PIN = 7;
+const uint8_t LIGHT_INT_PIN = 8;
+const uint8_t ENCODER_B_PIN = 10;
+const uint8_t ENCODER_A_PIN = 11;
+const uint8_t WATER_LEVEL_PIN = 12;
+const uint8_t FAN_SENSOR_PIN = 13;
+
+const uint8_t RELAY_ADDRESS = 0x11;
+const uint8_t OLED_ADDRESS = 0x3C;
+const uint8_t SI1145_ADDRESS = 0x60;
+const uint8_t PROBE_ADDRESS[4] = { 0x36, 0x37, 0x38, 0x39 };
+
+const uint8_t RELAY_FAN_LOW = 0x01;     //Channel 1.
+const uint8_t RELAY_FAN = 0x02;         //Channel 2.
+const uint8_t RELAY_LED = 0x04;         //Channel 3.
+const uint8_t RELAY_PUMP = 0x08;        //Channel 4.
+const uint8_t RELAY_VALVE[4] = { 0x10, 0x10, 0x20, 0x20 };   //Channels 5 and 6, valve of each pot with --valves.
+
+//Hardware characteristics.
+const double FLOW_PULSES_PER_LITER = 3467.0;
+const double PUMP_ML_PER_MINUTE = 1000.0;
+const double FAN_PULSES_PER_REV = 2.0;
+const uint64_t PROBE_CONVERSION_US = 1000;   //Touch conversion time of a seesaw probe.
+const double FAN_RPM_HIGH = 1500.0;
+const double FAN_RPM_LOW = 900.0;
+const uint32_t TANK_LOW_ML = 1000;
+const uint32_t PULSE_WIDTH_US = 100;
+const uint64_t SI1145_FORCED_US = 1500;      //Visible, IR and UV conversions of a forced measurement.
+
+const uint64_t US_PER_MINUTE = 60000000ULL;
+
+Options options;
+
+uint32_t lcgState = 12345;
+int noise(int amplitude) {
+  lcgState = lcgState * 1103515245UL + 12345UL;
+  return (int)((lcgState >> 16) % (2 * amplitude + 1)) - amplitude;
+}
+
+/*
+  ===================================
+  || The greenhouse being measured ||
+  =================================== */
+struct Greenhouse {
+  double moisture[4];
+  double potMl[4];
+  double tankMl;
+  double deliveredMl;
+  uint8_t relay;
+  uint64_t pumpOnMicros;
+  uint64_t updatedAt;
+  uint32_t pumpRuns;
+  uint64_t pumpStartedAt;
+  uint64_t dryFrom;             //Since when the pump has run without water flowing, 0 while it has not.
+  uint64_t longestDryMicros;
+
+  double minuteOfDay() const {
+    double m = options.startMinuteOfDay + (double)sim::nowMicros() / US_PER_MINUTE;
+    return fmod(m, 1440.0);
+  }
+
+  double daylight() const {
+    double m = minuteOfDay();
+    if (m < 360.0 || m > 1260.0) {
+      return 0.0;
+    }
+    return sin(M_PI * (m - 360.0) / 900.0);
+  }
+
+  double temperature() const {
+    return 20.0 + 7.0 * sin(2.0 * M_PI * (minuteOfDay() - 540.0) / 1440.0);
+  }
+
+  double humidity() const {
+    return 60.0 - 12.0 * sin(2.0 * M_PI * (minuteOfDay() - 540.0) / 1440.0);
+  }
+
+  //Pot gets water when the pump runs: its valve is open, or there are no valves.
+  bool fed(int pot) const {
+    return !options.valves || (relay & RELAY_VALVE[pot]);
+  }
+
+  int fedPots() const {
+    int n = 0;
+    for (int i = 0; i < 4; i++) {
+      n += fed(i);
+    }
+    return n;
+  }
+
+  //With every valve closed the pump pushes against them and nothing flows.
+  bool pumping() const {
+    return (relay & RELAY_PUMP) && fedPots() > 0 && tankMl > 0.0 &&
+           sim::nowMicros() - pumpStartedAt < options.flowStopsAfterMicros;
+  }
+
+  //Dry running lasts from when the pump runs without water until the sketch stops it.
+  void trackDryRun() {
+    uint64_t now = sim::nowMicros();
+    bool dry = (relay & RELAY_PUMP) && !pumping();
+    if (dry && dryFrom == 0) {
+      dryFrom = now;
+    }
+    else if (!dry && dryFrom != 0) {
+      if (now - dryFrom > longestDryMicros) {
+        longestDryMicros = now - dryFrom;
+      }
+      dryFrom = 0;
+    }
+  }
+
+  //Soil dries continuously and takes up whatever the pump delivers.
+  void update() {
+    static const double DRY_PER_HOUR[4] = { 22.0, 25.0, 30.0, 20.0 };
+    uint64_t now = sim::nowMicros();
+    double hours = (double)(now - updatedAt) / (60.0 * US_PER_MINUTE);
+    if (relay & RELAY_PUMP) {
+      pumpOnMicros += now - updatedAt;
+    }
+    for (int i = 0; i < 4; i++) {
+      moisture[i] -= DRY_PER_HOUR[i] * hours;
+      if (moisture[i] < 300.0) {
+        moisture[i] = 300.0;
+      }
+    }
+    updatedAt = now;
+  }
+
+  void water(double ml) {
+    update();
+    tankMl -= ml;
+    if (tankMl < 0.0) {
+      tankMl = 0.0;
+    }
+    deliveredMl += ml;
+    int pots = fedPots();
+    for (int i = 0; i < 4 && pots > 0; i++) {
+      if (fed(i)) {
+        moisture[i] += ml / pots;
+        potMl[i] += ml / pots;
+      }
+    }
+    trackDryRun();
+    sim::drivePin(WATER_LEVEL_PIN, tankMl < TANK_LOW_ML ? HIGH : LOW);
+  }
+};
+
+Greenhouse house;
+
+/*
+  ==================================================
+  || Pulse trains: flow sensor and fan tachometer ||
+  ================================================== */
+struct PulseTrain {
+  uint8_t pin;
+  double hz;
+  bool scheduled;
+  void (*onPulse)();
+
+  void set(double rate) {
+    hz = rate;
+    if (hz > 0.0 && !scheduled) {
+      scheduled = true;
+      sim::schedule(sim::nowMicros() + (uint64_t)(1000000.0 / hz), [this]() { fire(); });
+    }
+  }
+
+  void fire() {
+    if (hz <= 0.0) {
+      scheduled = false;
+      return;
+    }
+    uint8_t p = pin;
+    sim::drivePin(p, HIGH);
+    sim::schedule(sim::nowMicros() + PULSE_WIDTH_US, [p]() { sim::drivePin(p, LOW); });
+    if (onPulse) {
+      onPulse();
+    }
+    sim::schedule(sim::nowMicros() + (uint64_t)(1000000.0 / hz), [this]() { fire(); });
+  }
+};
+
+void flowPulse();
+
+PulseTrain flow = { FLOW_SENSOR_PIN, 0.0, false, flowPulse };
+PulseTrain fan = { FAN_SENSOR_PIN, 0.0, false, NULL };
+
+//Every pulse is 1/3467 l through the sensor. An empty tank stops the flow.
+void flowPulse() {
+  house.water(1000.0 / FLOW_PULSES_PER_LITER);
+  if (house.tankMl <= 0.0) {
+    flow.set(0.0);
+  }
+}
+
+/*
+  ================================
+  || Multi channel relay (0x11) ||
+  ================================ */
+class RelayBoard : public sim::I2CDevice {
+  public:
+    uint32_t writes;
+    RelayBoard() : writes(0) {}
+    uint8_t address() const { return RELAY_ADDRESS; }
+
+    void write(const uint8_t *data, size_t length) {
+      if (length < 2 || data[0] != 0x10) {
+        return;
+      }
+      writes++;
+      house.update();
+      if ((data[1] & RELAY_PUMP) && !(house.relay & RELAY_PUMP)) {
+        house.pumpRuns++;
+        house.pumpStartedAt = sim::nowMicros();
+        if (options.flowStopsAfterMicros != UINT64_MAX) {
+          uint32_t run = house.pumpRuns;
+          sim::schedule(house.pumpStartedAt + options.flowStopsAfterMicros, [run]() {
+            if (house.pumpRuns == run && (house.relay & RELAY_PUMP)) {
+              house.update();
+              flow.set(0.0);
+              house.trackDryRun();
+            }
+          });
+        }
+      }
+      house.relay = data[1];
+      house.trackDryRun();
+      flow.set(house.pumping() ? PUMP_ML_PER_MINUTE / 60000.0 * FLOW_PULSES_PER_LITER : 0.0);
+      double rpm = (house.relay & RELAY_FAN) ? FAN_RPM_HIGH : (house.relay & RELAY_FAN_LOW) ? FAN_RPM_LOW : 0.0;
+      fan.set(rpm * FAN_PULSES_PER_REV / 60.0);
+    }
+
+    size_t read(uint8_t *data, size_t length) {
+      for (size_t i = 0; i < length; i++) {
+        data[i] = house.relay;
+      }
+      return length;
+    }
+};
+
+/*
+  ===================================================
+  || Seesaw capacitive moisture probes (0x36-0x39) ||
+  =================================================== */
+class MoistureProbe : public sim::I2CDevice {
+  public:
+    MoistureProbe(uint8_t index) : index(index), regHigh(0), regLow(0), selectedAt(0), stuckAt(0) {}
+    uint8_t address() const { return PROBE_ADDRESS[index]; }
+
+    void write(const uint8_t *data, size_t length) {
+      if (length >= 2) {
+        regHigh = data[0];
+        regLow = data[1];
+        selectedAt = sim::nowMicros();
+      }
+    }
+
+    size_t read(uint8_t *data, size_t length) {
+      uint16_t value = 0xFFFF;
+      if (regHigh == 0x00 && regLow == 0x01) {
+        value = 0x55 << 8;                       //HW ID in the first byte.
+      }
+      else if (regHigh == 0x0F && regLow == 0x10 && sim::nowMicros() - selectedAt < PROBE_CONVERSION_US) {
+        value = 0xFFFF;                          //Asked before the conversion is done: no result.
+      }
+      else if (regHigh == 0x0F && regLow == 0x10) {
+        house.update();
+        value = (uint16_t)(house.moisture[index] + noise(4));
+        if (index == options.faultyProbe) {
+          value = faulty(value);
+        }
+      }
+      for (size_t i = 0; i < length; i++) {
+        data[i] = i == 0 ? (uint8_t)(value >> 8) : i == 1 ? (uint8_t)value : 0;
+      }
+      return length;
+    }
+
+  private:
+    uint8_t index;
+    uint8_t regHigh;
+    uint8_t regLow;
+    uint64_t selectedAt;
+    uint16_t stuckAt;
+
+    uint16_t faulty(uint16_t value) {
+      switch (options.probeFault) {
+        case PROBE_DEAD:
+          return 0xFFFF;
+        case PROBE_STUCK:
+          stuckAt = stuckAt != 0 ? stuckAt : value;
+          return stuckAt;
+        case PROBE_NOISY:
+          return (uint16_t)(value + noise(150));
+        default:
+          return value;
+      }
+    }
+};
+
+/*
+  ===================================
+  || SI1145 sunlight sensor (0x60) ||
+  =================================== */
+class SunlightSensor : public sim::I2CDevice {
+  public:
+    SunlightSensor() : pointer(0), autoMode(false), cycle(0) {
+      memset(regs, 0, sizeof(regs));
+      memset(params, 0, sizeof(params));
+      regs[0x00] = 0x45;
+    }
+    uint8_t address() const { return SI1145_ADDRESS; }
+
+    void write(const uint8_t *data, size_t length) {
+      if (length == 0) {
+        return;
+      }
+      pointer = data[0] & 0x3F;
+      for (size_t i = 1; i < length; i++) {
+        store(pointer, data[i]);
+        pointer = (pointer + 1) & 0x3F;
+      }
+    }
+
+    size_t read(uint8_t *data, size_t length) {
+      for (size_t i = 0; i < length; i++) {
+        data[i] = regs[pointer];
+        pointer = (pointer + 1) & 0x3F;
+      }
+      return length;
+    }
+
+  private:
+    uint8_t regs[0x40];
+    uint8_t params[0x20];
+    uint8_t pointer;
+    bool autoMode;
+    uint32_t cycle;                              //Bumped on every auto mode start and stop, so that old cycles end.
+
+    void store(uint8_t reg, uint8_t value) {
+      if (reg == 0x21) {
+        regs[reg] &= ~value;                     //IRQ_STATUS is write-one-to-clear.
+        updateInt();
+        return;
+      }
+      regs[reg] = value;
+      if (reg != 0x18) {
+        return;
+      }
+      //COMMAND register.
+      if ((value & 0xE0) == 0xA0) {
+        params[value & 0x1F] = regs[0x17];
+        regs[0x2E] = regs[0x17];
+      }
+      else if ((value & 0xE0) == 0x80) {
+        regs[0x2E] = params[value & 0x1F];
+      }
+      else if (value == 0x01) {
+        autoMode = false;
+        cycle++;
+      }
+      else if (value == 0x0F || value == 0x0E) {
+        autoMode = true;
+        cycle++;
+        scheduleCycle(cycle);
+      }
+      else if (value == 0x06 || value == 0x07) {
+        uint32_t which = cycle;
+        sim::schedule(sim::nowMicros() + SI1145_FORCED_US, [this, which]() {
+          if (which == cycle) {
+            finishMeasurement();
+          }
+        });
+      }
+    }
+
+    void finishMeasurement() {
+      measure();
+      regs[0x21] |= regs[0x04] & 0x01;           //ALS interrupt, if enabled.
+      updateInt();
+    }
+
+    //Auto mode measures every MEAS_RATE x 31.25 us, read when the next cycle is due.
+    void scheduleCycle(uint32_t which) {
+      uint32_t rate = regs[0x08] | (regs[0x09] << 8);
+      if (rate == 0) {
+        return;
+      }
+      sim::schedule(sim::nowMicros() + rate * 125 / 4, [this, which]() {
+        if (!autoMode || which != cycle) {
+          return;
+        }
+        finishMeasurement();
+        scheduleCycle(which);
+      });
+    }
+
+    //INT is open drain, low while an enabled interrupt is pending.
+    void updateInt() {
+      bool pending = (regs[0x03] & 0x01) && (regs[0x21] & regs[0x04]);
+      sim::drivePin(LIGHT_INT_PIN, pending ? LOW : HIGH);
+    }
+
+    void put16(uint8_t reg, uint16_t value) {
+      regs[reg] = (uint8_t)value;
+      regs[reg + 1] = (uint8_t)(value >> 8);
+    }
+
+    void measure() {
+      double sun = house.daylight();
+      bool led = house.relay & RELAY_LED;
+      put16(0x22, (uint16_t)(260 + 1200 * sun + (led ? 200 : 0) + noise(2)));
+      put16(0x24, (uint16_t)(250 + 2000 * sun + (led ? 40 : 0) + noise(2)));
+      put16(0x2C, (uint16_t)(0.3 * 350 * sun + (led ? 8 : 0)));
+    }
+};
+
+/*
+  =================================
+  || SH1107G 128x128 OLED (0x3C) ||
+  ================================= */
+class Display : public sim::I2CDevice {
+  public:
+    uint8_t ram[16][128];
+
+    Display() : page(0), column(0), pendingArgs(0) {
+      memset(ram, 0, sizeof(ram));
+    }
+    uint8_t address() const { return OLED_ADDRESS; }
+
+    void write(const uint8_t *data, size_t length) {
+      size_t i = 0;
+      while (i < length) {
+        uint8_t control = data[i++];
+        bool continuation = control & 0x80;
+        bool isData = control & 0x40;
+        if (continuation) {
+          if (i < length) {
+            handle(data[i++], isData);
+          }
+        }
+        else {
+          while (i < length) {
+            handle(data[i++], isData);
+          }
+        }
+      }
+    }
+
+    size_t read(uint8_t *data, size_t length) {
+      memset(data, 0, length);
+      return length;
+    }
+
+    uint32_t checksum() const {
+      uint32_t crc = 0xFFFFFFFFUL;
+      const uint8_t *p = &ram[0][0];
+      for (size_t i = 0; i < sizeof(ram); i++) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; b++) {
+          crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+        }
+      }
+      return ~crc;
+    }
+
+  private:
+    uint8_t page;
+    uint8_t column;
+    uint8_t pendingArgs;
+
+    void handle(uint8_t byte, bool isData) {
+      if (isData) {
+        ram[page][column] = byte;
+        column = (column + 1) & 0x7F;
+        return;
+      }
+      if (pendingArgs) {
+        pendingArgs--;
+        return;
+      }
+      if (byte <= 0x0F) {
+        column = (column & 0x70) | byte;
+      }
+      else if (byte >= 0x10 && byte <= 0x17) {
+        column = (uint8_t)(((byte & 0x07) << 4) | (column & 0x0F));
+      }
+      else if (byte >= 0xB0 && byte <= 0xBF) {
+        page = byte & 0x0F;
+      }
+      else if (byte == 0x81 || byte == 0xA8 || byte == 0xD3 || byte == 0xD5 || byte == 0xD9
+               || byte == 0xDB || byte == 0xDC || byte == 0xAD) {
+        pendingArgs = 1;
+      }
+    }
+};
+
+/*
+  ==========================================
+  || DHT11 temperature & humidity (pin 4) ||
+  ========================================== */
+class Dht11 {
+  public:
+    Dht11() : lowSince(0), lowActive(false) {}
+
+    void pinChanged(uint8_t mode, uint8_t level) {
+      if (mode == OUTPUT && level == LOW) {
+        lowActive = true;
+        lowSince = sim::nowMicros();
+      }
+      else if (lowActive) {
+        lowActive = false;
+        if (sim::nowMicros() - lowSince >= 18000) {
+          respond();
+        }
+      }
+    }
+
+  private:
+    uint64_t lowSince;
+    bool lowActive;
+
+    //Response: 80 us low, 80 us high, then 40 bits of 50 us low followed by
+    //28 us (0) or 70 us (1) high, then a final 50 us low.
+    void respond() {
+      uint8_t data[5];
+      data[0] = (uint8_t)lround(house.humidity());
+      data[1] = 0;
+      data[2] = (uint8_t)lround(house.temperature());
+      data[3] = 0;
+      data[4] = (uint8_t)(data[0] + data[1] + data[2] + data[3]);
+
+      uint64_t t = sim::nowMicros() + 60;
+      t = edge(t, LOW, 80);
+      t = edge(t, HIGH, 80);
+      for (int i = 0; i < 40; i++) {
+        bool one = (data[i / 8] >> (7 - i % 8)) & 1;
+        t = edge(t, LOW, 50);
+        t = edge(t, HIGH, one ? 70 : 28);
+      }
+      t = edge(t, LOW, 50);
+      edge(t, HIGH, 0);
+    }
+
+    uint64_t edge(uint64_t at, uint8_t level, uint32_t length) {
+      sim::schedule(at, [level]() { sim::drivePin(DHT_PIN, level); });
+      return at + length;
+    }
+};
+
+RelayBoard relayBoard;
+MoistureProbe probes[4] = { MoistureProbe(0), MoistureProbe(1), MoistureProbe(2), MoistureProbe(3) };
+SunlightSensor sunlight;
+Display display;
+Dht11 dht;
+
+}  // namespace
+
+void build(const Options &opts) {
+  options = opts;
+  static const double START_MOISTURE[4] = { 1080.0, 1060.0, 1040.0, 1100.0 };
+  for (int i = 0; i < 4; i++) {
+    house.moisture[i] = START_MOISTURE[i];
+    house.potMl[i] = 0.0;
+    sim::attachI2C(&probes[i]);
+  }
+  house.tankMl = options.tankMilliliters;
+  house.deliveredMl = 0.0;
+  house.relay = 0;
+  house.pumpOnMicros = 0;
+  house.updatedAt = 0;
+  house.pumpRuns = 0;
+  house.pumpStartedAt = 0;
+  house.dryFrom = 0;
+  house.longestDryMicros = 0;
+
+  sim::attachI2C(&relayBoard);
+  sim::attachI2C(&sunlight);
+  sim::attachI2C(&display);
+
+  //Idle levels: buttons pulled down, encoder, DHT bus and light sensor INT pulled up.
+  sim::drivePin(MODE_BUTTON_PIN, LOW);
+  sim::drivePin(SET_BUTTON_PIN, LOW);
+  sim::drivePin(ENCODER_A_PIN, HIGH);
+  sim::drivePin(ENCODER_B_PIN, HIGH);
+  sim::drivePin(DHT_PIN, HIGH);
+  sim::drivePin(LIGHT_INT_PIN, HIGH);
+  sim::drivePin(WATER_LEVEL_PIN, house.tankMl < TANK_LOW_ML ? HIGH : LOW);
+  sim::onPinChange(DHT_PIN, [](uint8_t mode, uint8_t level) { dht.pinChanged(mode, level); });
+}
+
+void pressModeButton(uint64_t atMicros) {
+  sim::schedule(atMicros, []() { sim::drivePin(MODE_BUTTON_PIN, HIGH); });
+  sim::schedule(atMicros + 100000, []() { sim::drivePin(MODE_BUTTON_PIN, LOW); });
+}
+
+void pressSetButton(uint64_t atMicros, uint32_t holdMicros) {
+  sim::schedule(atMicros, []() { sim::drivePin(SET_BUTTON_PIN, HIGH); });
+  sim::schedule(atMicros + holdMicros, []() { sim::drivePin(SET_BUTTON_PIN, LOW); });
+}
+
+Observations observe() {
+  house.update();
+  Observations o;
+  o.relayState = house.relay;
+  o.relayWrites = relayBoard.writes;
+  o.pumpOnMicros = house.pumpOnMicros;
+  o.pumpRuns = house.pumpRuns;
+  o.longestDryRunMicros = house.longestDryMicros;
+  if (house.dryFrom != 0 && sim::nowMicros() - house.dryFrom > o.longestDryRunMicros) {
+    o.longestDryRunMicros = sim::nowMicros() - house.dryFrom;     //Still running dry.
+  }
+  o.waterDeliveredMl = (uint32_t)lround(house.deliveredMl);
+  o.displayChecksum = display.checksum();
+  for (int i = 0; i < 4; i++) {
+    o.moisture[i] = (int)lround(house.moisture[i]);
+    o.potWaterMl[i] = (uint32_t)lround(house.potMl[i]);
+  }
+  o.temperature = (float)house.temperature();
+  o.humidity = (float)house.humidity();
+  return o;
+}
+
+void printDisplay() {
+  static const char SHADE[4] = { ' ', '\'', '.', '#' };
+  for (int y = 0; y < 128; y += 2) {
+    char line[129];
+    for (int x = 0; x < 128; x++) {
+      int top = (display.ram[y / 8][x] >> (y % 8)) & 1;
+      int bottom = (display.ram[(y + 1) / 8][x] >> ((y + 1) % 8)) & 1;
+      line[x] = SHADE[top | (bottom << 1)];
+    }
+    line[128] = '\0';
+    printf("|%s|\n", line);
+  }
+}
+
+}  // namespace rig
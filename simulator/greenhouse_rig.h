@@ -0,0 +1,62 @@
+/*
+ * greenhouse_rig.h
+ * Models of everything wired to the Arduino: sensors, relay board, display,
+ * buttons and the greenhouse they measure. Pin numbers, relay channels and
+ * I2C addresses follow the wiring table at the top of the sketch.
+ */
+
+#ifndef GREENHOUSE_RIG_H
+#define GREENHOUSE_RIG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace rig {
+
+enum ProbeFault {
+  PROBE_OK,
+  PROBE_DEAD,                   //Does not convert, reads 65535.
+  PROBE_STUCK,                  //Reads its first value forever.
+  PROBE_NOISY                   //Reads with +-150 noise.
+};
+
+struct Options {
+  uint32_t startMinuteOfDay;    //Local time (CEST, UTC+2) when the board powers up.
+  uint32_t tankMilliliters;     //Water in the tank at start.
+  uint64_t flowStopsAfterMicros;  //In every pump run, water stops flowing and the flow sensor stops pulsing this long after the pump starts (dry-run, blocked hose). UINT64_MAX: never.
+  int faultyProbe;              //Moisture probe 0-3 that reads wrong from the start, -1 for none.
+  ProbeFault probeFault;
+  bool valves;                  //Pots 1-2 behind a valve on relay channel 5, pots 3-4 behind channel 6. Without, the pump waters all four.
+};
+
+//Build every device model, hook it to the simulated pins and I2C bus.
+void build(const Options &options);
+
+//Press the MODE-button (pin 2) at the given virtual time.
+void pressModeButton(uint64_t atMicros);
+
+//Press and hold the SET-button (pin 7).
+void pressSetButton(uint64_t atMicros, uint32_t holdMicros);
+
+struct Observations {
+  uint8_t relayState;           //Bit n = relay channel n+1.
+  uint32_t relayWrites;
+  uint64_t pumpOnMicros;
+  uint32_t pumpRuns;
+  uint64_t longestDryRunMicros; //Longest time the pump ran without water flowing before it was stopped.
+  uint32_t waterDeliveredMl;
+  uint32_t displayChecksum;     //CRC-32 over the display RAM.
+  int moisture[4];
+  uint32_t potWaterMl[4];       //Water each pot got.
+  float temperature;
+  float humidity;
+};
+
+Observations observe();
+
+//ASCII rendering of the 128x128 display, two pixel rows per text line.
+void printDisplay();
+
+}  // namespace rig
+
+#endif  /* GREENHOUSE_RIG_H */
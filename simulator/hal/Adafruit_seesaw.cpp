@@ -0,0 +1,67 @@
+/*
+ * Adafruit_seesaw.cpp
+ * Host-native stand-in for the parts of Adafruit_seesaw the moisture sensors
+ * use.
+ */
+
+#include "Adafruit_seesaw.h"
+
+Adafruit_seesaw::Adafruit_seesaw(TwoWire *i2c_bus) : _i2caddr(SEESAW_ADDRESS) {
+  _i2cbus = i2c_bus ? i2c_bus : &Wire;
+}
+
+bool Adafruit_seesaw::begin(uint8_t addr, int8_t flow, bool reset) {
+  (void)flow;
+  _i2caddr = addr;
+  _i2cbus->begin();
+  if (reset) {
+    SWReset();
+    delay(500);
+  }
+  return read8(SEESAW_STATUS_BASE, SEESAW_STATUS_HW_ID) == SEESAW_HW_ID_CODE;
+}
+
+void Adafruit_seesaw::SWReset(void) {
+  write8(SEESAW_STATUS_BASE, SEESAW_STATUS_SWRST, 0xFF);
+}
+
+uint16_t Adafruit_seesaw::touchRead(uint8_t pin) {
+  uint8_t buf[2];
+  uint8_t p = pin;
+  read(SEESAW_TOUCH_BASE, SEESAW_TOUCH_CHANNEL_OFFSET + p, buf, 2, 1000);
+  return ((uint16_t)buf[0] << 8) | buf[1];
+}
+
+void Adafruit_seesaw::write8(uint8_t regHigh, uint8_t regLow, uint8_t value) {
+  write(regHigh, regLow, &value, 1);
+}
+
+uint8_t Adafruit_seesaw::read8(uint8_t regHigh, uint8_t regLow) {
+  uint8_t ret;
+  read(regHigh, regLow, &ret, 1);
+  return ret;
+}
+
+void Adafruit_seesaw::read(uint8_t regHigh, uint8_t regLow, uint8_t *buf, uint8_t num, uint16_t delay) {
+  _i2cbus->beginTransmission(_i2caddr);
+  _i2cbus->write(regHigh);
+  _i2cbus->write(regLow);
+  _i2cbus->endTransmission();
+
+  //The seesaw needs the conversion delay before it can answer.
+  delayMicroseconds(delay);
+
+  _i2cbus->requestFrom(_i2caddr, num);
+  for (uint8_t i = 0; i < num; i++) {
+    int value = _i2cbus->read();
+    buf[i] = value < 0 ? 0xFF : (uint8_t)value;
+  }
+}
+
+void Adafruit_seesaw::write(uint8_t regHigh, uint8_t regLow, uint8_t *buf, uint8_t num) {
+  _i2cbus->beginTransmission(_i2caddr);
+  _i2cbus->write(regHigh);
+  _i2cbus->write(regLow);
+  _i2cbus->write(buf, num);
+  _i2cbus->endTransmission();
+}
@@ -0,0 +1,42 @@
+/*
+ * Adafruit_seesaw.h
+ * Host-native stand-in for the parts of Adafruit_seesaw the moisture sensors
+ * use. The register protocol and its conversion delays match the 2019
+ * release of the library.
+ */
+
+#ifndef LIB_SEESAW_H
+#define LIB_SEESAW_H
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define SEESAW_ADDRESS 0x49
+
+#define SEESAW_STATUS_BASE 0x00
+#define SEESAW_TOUCH_BASE 0x0F
+
+#define SEESAW_STATUS_HW_ID 0x01
+#define SEESAW_STATUS_SWRST 0x7F
+#define SEESAW_TOUCH_CHANNEL_OFFSET 0x10
+
+#define SEESAW_HW_ID_CODE 0x55
+
+class Adafruit_seesaw {
+  public:
+    Adafruit_seesaw(TwoWire *i2c_bus = NULL);
+    bool begin(uint8_t addr = SEESAW_ADDRESS, int8_t flow = -1, bool reset = true);
+    void SWReset(void);
+    uint16_t touchRead(uint8_t pin);
+
+  protected:
+    uint8_t _i2caddr;
+    TwoWire *_i2cbus;
+
+    void write8(uint8_t regHigh, uint8_t regLow, uint8_t v);
+    uint8_t read8(uint8_t regHigh, uint8_t regLow);
+    void read(uint8_t regHigh, uint8_t regLow, uint8_t *buf, uint8_t num, uint16_t delay = 125);
+    void write(uint8_t regHigh, uint8_t regLow, uint8_t *buf, uint8_t num);
+};
+
+#endif  /* LIB_SEESAW_H */
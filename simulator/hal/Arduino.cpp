@@ -0,0 +1,437 @@
+/*
+ * Arduino.cpp
+ * Virtual time kernel and the stand-in Arduino core built on top of it.
+ */
+
+#include "Arduino.h"
+#include "sim.h"
+#include "avr/sleep.h"
+
+#include <stdio.h>
+#include <queue>
+#include <vector>
+
+namespace {
+
+//Costs charged for core calls, measured on an ATmega4809 at 16 MHz.
+const uint32_t DIGITAL_IO_US = 4;             //digitalRead()/digitalWrite() incl. pin lookup.
+const uint32_t SERIAL_BAUD_DEFAULT = 9600;
+const size_t SERIAL_TX_BUFFER_SIZE = 64;
+
+struct Event {
+  uint64_t at;
+  uint64_t seq;
+  std::function<void()> fn;
+  bool operator>(const Event &rhs) const { return at != rhs.at ? at > rhs.at : seq > rhs.seq; }
+};
+
+struct Pin {
+  uint8_t mode;
+  uint8_t output;         //Level written by the sketch.
+  uint8_t external;       //Level driven by the outside world.
+  void (*isr)(void);
+  int isrMode;
+  bool isrPending;
+  sim::PinHook hook;
+};
+
+uint64_t now = 0;
+uint64_t eventSeq = 0;
+std::priority_queue<Event, std::vector<Event>, std::greater<Event> > events;
+Pin pins[sim::NUM_PINS];
+bool interruptsEnabled = true;
+bool inInterrupt = false;
+sim::Stats statistics;
+std::vector<sim::I2CDevice *> i2cDevices;
+FILE *serialOut = NULL;
+uint64_t rtcNextOverflow = 0;
+double rtcErrorPpm = 0;
+double rtcPeriodFraction = 0;  //Microseconds below the resolution of virtual time, carried to the next period.
+
+uint32_t serialByteMicros = 10UL * 1000000UL / SERIAL_BAUD_DEFAULT;
+uint64_t serialTxEmptyAt = 0;  //Virtual time at which the UART shifter drains its buffer.
+
+uint8_t pinLevel(const Pin &p) {
+  return p.mode == OUTPUT ? p.output : p.external;
+}
+
+void runIsr(void (*isr)(void)) {
+  inInterrupt = true;
+  statistics.interrupts++;
+  isr();
+  inInterrupt = false;
+}
+
+void firePending() {
+  for (uint8_t i = 0; i < sim::NUM_PINS; i++) {
+    if (pins[i].isrPending && pins[i].isr) {
+      pins[i].isrPending = false;
+      runIsr(pins[i].isr);
+    }
+  }
+}
+
+void edge(uint8_t pin, uint8_t before, uint8_t after) {
+  Pin &p = pins[pin];
+  if (!p.isr || before == after) {
+    return;
+  }
+  bool match = p.isrMode == CHANGE
+               || (p.isrMode == RISING && after == HIGH)
+               || ((p.isrMode == FALLING || p.isrMode == LOW) && after == LOW);
+  if (!match) {
+    return;
+  }
+  if (interruptsEnabled && !inInterrupt) {
+    runIsr(p.isr);
+  }
+  else {
+    p.isrPending = true;           //Like the hardware flag, several edges collapse into one.
+  }
+}
+
+//RTC overflow period: (PER + 1) ticks of the 32.768 kHz clock through the prescaler.
+//An oscillator that runs fast gives shorter periods.
+uint64_t rtcPeriodMicros() {
+  uint32_t per = RTC.PERL | ((uint32_t)RTC.PERH << 8);
+  uint32_t prescaler = 1UL << ((RTC.CTRLA >> 3) & 0x0F);
+  double exact = (double)(per + 1) * prescaler * 1e6 / 32768.0 / (1.0 + rtcErrorPpm * 1e-6) + rtcPeriodFraction;
+  uint64_t whole = (uint64_t)exact;
+  rtcPeriodFraction = exact - (double)whole;
+  return whole;
+}
+
+void rtcOverflow() {
+  RTC.INTFLAGS |= 0x01;
+  if ((RTC.INTCTRL & 0x01) && RTC_CNT_vect) {
+    if (interruptsEnabled) {
+      runIsr(RTC_CNT_vect);
+    }
+  }
+}
+
+void advanceTo(uint64_t target) {
+  //Handlers are not nested: inside an ISR time just moves on and events wait.
+  if (inInterrupt) {
+    if (target > now) {
+      now = target;
+    }
+    return;
+  }
+  for (;;) {
+    bool rtcRunning = RTC.CTRLA & 0x01;
+    if (rtcRunning && rtcNextOverflow == 0) {
+      rtcNextOverflow = now + rtcPeriodMicros();
+    }
+    else if (!rtcRunning) {
+      rtcNextOverflow = 0;
+    }
+    bool eventDue = !events.empty() && events.top().at <= target;
+    bool rtcDue = rtcRunning && rtcNextOverflow <= target;
+    if (!eventDue && !rtcDue) {
+      break;
+    }
+    if (rtcDue && (!eventDue || rtcNextOverflow < events.top().at)) {
+      if (rtcNextOverflow > now) {
+        now = rtcNextOverflow;
+      }
+      //PER written by the handler right after the overflow already counts for the period that starts.
+      rtcOverflow();
+      rtcNextOverflow += rtcPeriodMicros();
+      continue;
+    }
+    Event e = events.top();
+    events.pop();
+    if (e.at > now) {
+      now = e.at;
+    }
+    e.fn();
+  }
+  if (target > now) {
+    now = target;
+  }
+}
+
+}  // namespace
+
+/*
+  ===================
+  || Kernel (sim.h) ||
+  =================== */
+namespace sim {
+
+uint64_t nowMicros() {
+  return now;
+}
+
+void advance(uint32_t us) {
+  advanceTo(now + us);
+}
+
+void block(uint32_t us) {
+  statistics.delayMicros += us;
+  advanceTo(now + us);
+}
+
+void idle(uint32_t us) {
+  statistics.sleepMicros += us;
+  advanceTo(now + us);
+}
+
+void schedule(uint64_t atUs, std::function<void()> fn) {
+  Event e = { atUs, eventSeq++, fn };
+  events.push(e);
+}
+
+void setRtcErrorPpm(double ppm) {
+  rtcErrorPpm = ppm;
+}
+
+void drivePin(uint8_t pin, uint8_t level) {
+  if (pin >= NUM_PINS) {
+    return;
+  }
+  Pin &p = pins[pin];
+  uint8_t before = pinLevel(p);
+  p.external = level;
+  edge(pin, before, pinLevel(p));
+}
+
+void onPinChange(uint8_t pin, PinHook hook) {
+  if (pin < NUM_PINS) {
+    pins[pin].hook = hook;
+  }
+}
+
+void attachI2C(I2CDevice *device) {
+  i2cDevices.push_back(device);
+}
+
+I2CDevice *findI2C(uint8_t address) {
+  for (size_t i = 0; i < i2cDevices.size(); i++) {
+    if (i2cDevices[i]->address() == address) {
+      return i2cDevices[i];
+    }
+  }
+  return NULL;
+}
+
+Stats &stats() {
+  return statistics;
+}
+
+void setSerialOutput(FILE *out) {
+  serialOut = out;
+}
+
+FILE *serialOutput() {
+  return serialOut;
+}
+
+}  // namespace sim
+
+/*
+  ====================
+  || Time functions ||
+  ==================== */
+unsigned long millis(void) {
+  return (unsigned long)(now / 1000);
+}
+
+unsigned long micros(void) {
+  return (unsigned long)now;
+}
+
+void delay(unsigned long ms) {
+  sim::block(ms * 1000UL);
+}
+
+void delayMicroseconds(unsigned int us) {
+  sim::block(us);
+}
+
+/*
+  =========================
+  || Sleep (avr/sleep.h) ||
+  ========================= */
+uint8_t sleepMode = SLEEP_MODE_IDLE;
+
+//The millis() timer interrupt wakes the CPU at the next millisecond at the latest.
+void sleep_cpu(void) {
+  uint64_t tick = (now / 1000 + 1) * 1000;
+  sim::idle((uint32_t)(tick - now));
+}
+
+/*
+  =========
+  || I/O ||
+  ========= */
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= sim::NUM_PINS) {
+    return;
+  }
+  Pin &p = pins[pin];
+  uint8_t before = pinLevel(p);
+  p.mode = mode;
+  if (p.hook) {
+    p.hook(p.mode, pinLevel(p));
+  }
+  edge(pin, before, pinLevel(p));
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  sim::advance(DIGITAL_IO_US);
+  if (pin >= sim::NUM_PINS) {
+    return;
+  }
+  Pin &p = pins[pin];
+  uint8_t before = pinLevel(p);
+  p.output = val ? HIGH : LOW;
+  if (p.hook) {
+    p.hook(p.mode, p.output);
+  }
+  edge(pin, before, pinLevel(p));
+}
+
+int digitalRead(uint8_t pin) {
+  sim::advance(DIGITAL_IO_US);
+  if (pin >= sim::NUM_PINS) {
+    return LOW;
+  }
+  return pinLevel(pins[pin]);
+}
+
+void attachInterrupt(uint8_t pin, void (*userFunc)(void), int mode) {
+  if (pin < sim::NUM_PINS) {
+    pins[pin].isr = userFunc;
+    pins[pin].isrMode = mode;
+    pins[pin].isrPending = false;
+  }
+}
+
+void detachInterrupt(uint8_t pin) {
+  if (pin < sim::NUM_PINS) {
+    pins[pin].isr = NULL;
+  }
+}
+
+void interrupts(void) {
+  interruptsEnabled = true;
+  if (!inInterrupt) {
+    firePending();
+  }
+}
+
+void noInterrupts(void) {
+  interruptsEnabled = false;
+}
+
+/*
+  ============
+  || String ||
+  ============ */
+String::String(long value, unsigned char base) {
+  char buf[34];
+  if (base == DEC) {
+    snprintf(buf, sizeof(buf), "%ld", value);
+    s = buf;
+    return;
+  }
+  unsigned long n = (unsigned long)value;
+  char *str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  s = str;
+}
+
+/*
+  ===========
+  || Print ||
+  =========== */
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::print(long n, int base) {
+  if (base == DEC) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%ld", n);
+    return write(buf);
+  }
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2) {
+    base = 10;
+  }
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  return write(str);
+}
+
+size_t Print::print(double n, int digits) {
+  if (isnan(n)) {
+    return write("nan");
+  }
+  if (isinf(n)) {
+    return write("inf");
+  }
+  char buf[40];
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return write(buf);
+}
+
+/*
+  ===========================
+  || Serial (UART at 9600) ||
+  =========================== */
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long baud) {
+  serialByteMicros = 10UL * 1000000UL / baud;   //Start bit, 8 data bits, stop bit.
+}
+
+int HardwareSerial::availableForWrite(void) {
+  uint64_t queued = serialTxEmptyAt > now ? (serialTxEmptyAt - now + serialByteMicros - 1) / serialByteMicros : 0;
+  return (int)(SERIAL_TX_BUFFER_SIZE - (queued < SERIAL_TX_BUFFER_SIZE ? queued : SERIAL_TX_BUFFER_SIZE));
+}
+
+void HardwareSerial::flush(void) {
+  if (serialTxEmptyAt > now) {
+    uint64_t wait = serialTxEmptyAt - now;
+    sim::stats().serialBlockedMicros += wait;
+    sim::advance((uint32_t)wait);
+  }
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  //A full TX buffer makes write() spin until the shifter has made room.
+  while (availableForWrite() == 0) {
+    uint64_t wait = serialTxEmptyAt - now - (SERIAL_TX_BUFFER_SIZE - 1) * serialByteMicros;
+    sim::stats().serialBlockedMicros += wait;
+    sim::advance((uint32_t)wait);
+  }
+  serialTxEmptyAt = (serialTxEmptyAt > now ? serialTxEmptyAt : now) + serialByteMicros;
+  sim::stats().serialBytes++;
+  if (sim::serialOutput() != NULL) {
+    fputc(c, sim::serialOutput());
+  }
+  return 1;
+}
+
+RTC_t RTC;
@@ -0,0 +1,166 @@
+/*
+ * Arduino.h
+ * Host-native stand-in for the Arduino core (megaAVR flavour, as on the
+ * Arduino UNO WiFi Rev2 the greenhouse runs on).
+ *
+ * Only what the sketch and its drivers use is provided. Every blocking call
+ * is charged in virtual time, see sim.h.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+#include "avr/pgmspace.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+//Interrupt modes, numbered as in ArduinoCore-API. LOW is shared with the pin level.
+#define CHANGE  2
+#define FALLING 3
+#define RISING  4
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define F(string_literal) (string_literal)
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+void attachInterrupt(uint8_t pin, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t pin);
+#define digitalPinToInterrupt(p) (p)
+
+void interrupts(void);
+void noInterrupts(void);
+#define sei() interrupts()
+#define cli() noInterrupts()
+
+inline uint16_t word(uint8_t h, uint8_t l) { return (uint16_t)((h << 8) | l); }
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+/*
+  ============
+  || String ||
+  ============ */
+class String {
+  public:
+    String(const char *cstr = "") : s(cstr ? cstr : "") {}
+    String(const std::string &str) : s(str) {}
+    explicit String(long value, unsigned char base = DEC);
+    const char *c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.length(); }
+    String &operator+=(const String &rhs) { s += rhs.s; return *this; }
+    bool operator==(const String &rhs) const { return s == rhs.s; }
+    bool operator!=(const String &rhs) const { return s != rhs.s; }
+    bool operator<(const String &rhs) const { return s < rhs.s; }
+    bool operator>(const String &rhs) const { return s > rhs.s; }
+  private:
+    std::string s;
+};
+
+/*
+  ===========
+  || Print ||
+  =========== */
+class Print;
+
+class Printable {
+  public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+
+    size_t print(const char str[]) { return write(str); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(const String &s) { return write(s.c_str()); }
+    size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(int n, int base = DEC) { return print((long)n, base); }
+    size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+    size_t print(const Printable &x) { return x.printTo(*this); }
+
+    template <typename T> size_t println(const T &value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(const T &value, int format) { size_t n = print(value, format); return n + println(); }
+    size_t println(void) { return write("\r\n"); }
+};
+
+class HardwareSerial : public Print {
+  public:
+    void begin(unsigned long baud);
+    void end() {}
+    int available(void) { return 0; }
+    int read(void) { return -1; }
+    int availableForWrite(void);
+    void flush(void);
+    size_t write(uint8_t c);
+    using Print::write;
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+/*
+  ==================================
+  || megaAVR RTC peripheral (RTC) ||
+  ================================== */
+struct RTC_t {
+  volatile uint8_t CTRLA;
+  volatile uint8_t STATUS;
+  volatile uint8_t INTCTRL;
+  volatile uint8_t INTFLAGS;
+  volatile uint8_t TEMP;
+  volatile uint8_t DBGCTRL;
+  volatile uint8_t CALIB;
+  volatile uint8_t CLKSEL;
+  volatile uint8_t CNTL;
+  volatile uint8_t CNTH;
+  volatile uint8_t PERL;
+  volatile uint8_t PERH;
+  volatile uint8_t CMPL;
+  volatile uint8_t CMPH;
+};
+
+extern RTC_t RTC;
+
+//Interrupt vectors become plain functions that the simulator calls.
+#define ISR(vector) void vector(void)
+void RTC_CNT_vect(void) __attribute__((weak));
+
+#endif  /* Arduino_h */
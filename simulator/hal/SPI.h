@@ -0,0 +1,11 @@
+/*
+ * SPI.h
+ * The WiFiNINA stand-in does not talk SPI, the header only has to exist.
+ */
+
+#ifndef _SPI_H_INCLUDED
+#define _SPI_H_INCLUDED
+
+#include "Arduino.h"
+
+#endif  /* _SPI_H_INCLUDED */
@@ -0,0 +1,240 @@
+/*
+ * WiFiNINA.cpp
+ * Host-native stand-in for WiFiNINA: association, UDP and an NTP server.
+ */
+
+#include "WiFiNINA.h"
+#include "sim.h"
+
+#include <stdio.h>
+
+namespace {
+
+//Every call into the NINA module is an SPI command/response round trip.
+const uint32_t NINA_COMMAND_US = 300;
+const uint32_t ASSOCIATE_US = 2000000UL;
+const uint32_t ASSOCIATE_TIMEOUT_US = 10000000UL;
+
+const uint32_t SEVENTY_YEARS = 2208988800UL;
+const uint16_t NTP_PORT = 123;
+const size_t NTP_PACKET_SIZE = 48;
+
+sim::Network net = { true, true, true, 30000, 0 };
+
+void command() {
+  sim::advance(NINA_COMMAND_US);
+}
+
+//NTP timestamp (seconds since 1900 and 32-bit fraction) of true wall-clock time.
+void ntpTimestamp(uint64_t atMicros, uint8_t *out) {
+  uint64_t seconds = net.utcAtStart + SEVENTY_YEARS + atMicros / 1000000ULL;
+  uint64_t fraction = ((atMicros % 1000000ULL) << 32) / 1000000ULL;
+  for (int i = 0; i < 4; i++) {
+    out[i] = (uint8_t)(seconds >> (24 - 8 * i));
+    out[4 + i] = (uint8_t)(fraction >> (24 - 8 * i));
+  }
+}
+
+}  // namespace
+
+namespace sim {
+
+Network &network() {
+  return net;
+}
+
+}  // namespace sim
+
+size_t IPAddress::printTo(Print &p) const {
+  size_t n = 0;
+  for (int i = 0; i < 4; i++) {
+    n += p.print(bytes[i], DEC);
+    if (i < 3) {
+      n += p.print('.');
+    }
+  }
+  return n;
+}
+
+/*
+  ==========
+  || WiFi ||
+  ========== */
+WiFiClass WiFi;
+
+WiFiClass::WiFiClass() : state(WL_IDLE_STATUS), timeout(50000), joining(false), joinStart(0) {
+  ssid[0] = '\0';
+}
+
+uint8_t WiFiClass::begin(const char *name, const char *passphrase) {
+  (void)passphrase;
+  if (!net.moduleFitted) {
+    return WL_NO_MODULE;
+  }
+  if (timeout == 0) {
+    //Join in the background, status() reports how it went.
+    command();
+    snprintf(ssid, sizeof(ssid), "%s", name);
+    joining = true;
+    joinStart = sim::nowMicros();
+    state = WL_IDLE_STATUS;
+    return state;
+  }
+  if (net.accessPointInRange) {
+    sim::block(ASSOCIATE_US);
+    snprintf(ssid, sizeof(ssid), "%s", name);
+    state = WL_CONNECTED;
+  }
+  else {
+    sim::block(ASSOCIATE_TIMEOUT_US);
+    state = WL_CONNECT_FAILED;
+  }
+  return state;
+}
+
+//Any other timeout than 0 waits like the library default.
+void WiFiClass::setTimeout(unsigned long timeout) {
+  this->timeout = timeout;
+}
+
+void WiFiClass::end(void) {
+  command();
+  ssid[0] = '\0';
+  joining = false;
+  state = WL_IDLE_STATUS;
+}
+
+uint8_t WiFiClass::status(void) {
+  command();
+  if (!net.moduleFitted) {
+    return WL_NO_MODULE;
+  }
+  if (joining && net.accessPointInRange && sim::nowMicros() - joinStart >= ASSOCIATE_US) {
+    joining = false;
+    state = WL_CONNECTED;
+  }
+  else if (joining && sim::nowMicros() - joinStart >= ASSOCIATE_TIMEOUT_US) {
+    joining = false;
+    ssid[0] = '\0';
+    state = WL_CONNECT_FAILED;
+  }
+  if (state == WL_CONNECTED && !net.accessPointInRange) {
+    state = WL_CONNECTION_LOST;
+  }
+  return state;
+}
+
+const char *WiFiClass::SSID(void) {
+  command();
+  return ssid;
+}
+
+IPAddress WiFiClass::localIP(void) {
+  command();
+  return state == WL_CONNECTED ? IPAddress(192, 168, 1, 42) : IPAddress();
+}
+
+int32_t WiFiClass::RSSI(void) {
+  command();
+  return state == WL_CONNECTED ? -61 : 0;
+}
+
+const char *WiFiClass::firmwareVersion(void) {
+  command();
+  return "1.2.1";
+}
+
+/*
+  =========
+  || UDP ||
+  ========= */
+WiFiUDP::WiFiUDP() : localPort(0), remotePort(0), txLength(0), rxLength(0), rxIndex(0), replyPending(false), replyAt(0) {
+}
+
+uint8_t WiFiUDP::begin(uint16_t port) {
+  command();
+  localPort = port;
+  return WiFi.status() == WL_CONNECTED ? 1 : 0;
+}
+
+void WiFiUDP::stop(void) {
+  command();
+  localPort = 0;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+  (void)ip;
+  command();
+  remotePort = port;
+  txLength = 0;
+  return 1;
+}
+
+size_t WiFiUDP::write(uint8_t byte) {
+  return write(&byte, 1);
+}
+
+size_t WiFiUDP::write(const uint8_t *buffer, size_t size) {
+  command();
+  size_t n = 0;
+  while (n < size && txLength < sizeof(tx)) {
+    tx[txLength++] = buffer[n++];
+  }
+  return n;
+}
+
+int WiFiUDP::endPacket(void) {
+  command();
+  if (WiFi.status() != WL_CONNECTED) {
+    return 0;
+  }
+  //The NTP server answers a client request (mode 3) with a server reply (mode 4).
+  if (remotePort == NTP_PORT && txLength == NTP_PACKET_SIZE && (tx[0] & 0x07) == 3 && net.ntpReachable) {
+    uint64_t sentAt = sim::nowMicros();
+    uint64_t receivedAt = sentAt + net.ntpRoundTripMicros / 2;
+    memset(rx, 0, NTP_PACKET_SIZE);
+    rx[0] = 0x24;                                 //LI 0, version 4, mode 4 (server).
+    rx[1] = 1;                                    //Stratum 1.
+    rx[2] = tx[2];
+    rx[3] = 0xEC;
+    memcpy(&rx[24], &tx[40], 8);                  //Originate timestamp = client transmit timestamp.
+    ntpTimestamp(receivedAt, &rx[32]);            //Receive timestamp.
+    ntpTimestamp(receivedAt + 50, &rx[40]);       //Transmit timestamp.
+    rxLength = NTP_PACKET_SIZE;
+    rxIndex = 0;
+    replyPending = true;
+    replyAt = sentAt + net.ntpRoundTripMicros;
+  }
+  return 1;
+}
+
+int WiFiUDP::parsePacket(void) {
+  command();
+  if (!replyPending || sim::nowMicros() < replyAt) {
+    return 0;
+  }
+  replyPending = false;
+  rxIndex = 0;
+  return (int)rxLength;
+}
+
+int WiFiUDP::available(void) {
+  return (int)(rxLength - rxIndex);
+}
+
+int WiFiUDP::read(void) {
+  return rxIndex < rxLength ? rx[rxIndex++] : -1;
+}
+
+int WiFiUDP::read(unsigned char *buffer, size_t len) {
+  command();
+  size_t n = 0;
+  while (n < len && rxIndex < rxLength) {
+    buffer[n++] = rx[rxIndex++];
+  }
+  return (int)n;
+}
+
+void WiFiUDP::flush(void) {
+  rxIndex = rxLength;
+}
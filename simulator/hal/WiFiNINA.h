@@ -0,0 +1,55 @@
+/*
+ * WiFiNINA.h
+ * Host-native stand-in for the WiFiNINA library. Association and the NTP
+ * server on the other side are modelled by the simulator, see sim::network().
+ */
+
+#ifndef WiFiNINA_h
+#define WiFiNINA_h
+
+#include "Arduino.h"
+
+#define WL_NO_SHIELD        255
+#define WL_NO_MODULE        WL_NO_SHIELD
+#define WL_IDLE_STATUS      0
+#define WL_NO_SSID_AVAIL    1
+#define WL_SCAN_COMPLETED   2
+#define WL_CONNECTED        3
+#define WL_CONNECT_FAILED   4
+#define WL_CONNECTION_LOST  5
+#define WL_DISCONNECTED     6
+
+class IPAddress : public Printable {
+  public:
+    IPAddress() { bytes[0] = bytes[1] = bytes[2] = bytes[3] = 0; }
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { bytes[0] = a; bytes[1] = b; bytes[2] = c; bytes[3] = d; }
+    uint8_t operator[](int index) const { return bytes[index]; }
+    size_t printTo(Print &p) const;
+  private:
+    uint8_t bytes[4];
+};
+
+class WiFiClass {
+  public:
+    WiFiClass();
+    uint8_t begin(const char *ssid, const char *passphrase);
+    void setTimeout(unsigned long timeout);
+    void end(void);
+    uint8_t status(void);
+    const char *SSID(void);
+    IPAddress localIP(void);
+    int32_t RSSI(void);
+    const char *firmwareVersion(void);
+  private:
+    uint8_t state;
+    char ssid[33];
+    unsigned long timeout;          //ms begin() may wait, 0: begin() returns at once and status() tells.
+    bool joining;
+    uint64_t joinStart;
+};
+
+extern WiFiClass WiFi;
+
+#include "WiFiUdp.h"
+
+#endif  /* WiFiNINA_h */
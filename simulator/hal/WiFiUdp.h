@@ -0,0 +1,40 @@
+/*
+ * WiFiUdp.h
+ * Host-native stand-in for the WiFiNINA UDP socket.
+ */
+
+#ifndef wifiudp_h
+#define wifiudp_h
+
+#include "Arduino.h"
+
+class IPAddress;
+
+class WiFiUDP {
+  public:
+    WiFiUDP();
+    uint8_t begin(uint16_t port);
+    void stop(void);
+    int beginPacket(IPAddress ip, uint16_t port);
+    int endPacket(void);
+    size_t write(uint8_t byte);
+    size_t write(const uint8_t *buffer, size_t size);
+    int parsePacket(void);
+    int available(void);
+    int read(void);
+    int read(unsigned char *buffer, size_t len);
+    void flush(void);
+
+  private:
+    uint16_t localPort;
+    uint16_t remotePort;
+    uint8_t tx[64];
+    size_t txLength;
+    uint8_t rx[64];
+    size_t rxLength;
+    size_t rxIndex;
+    bool replyPending;
+    uint64_t replyAt;
+};
+
+#endif  /* wifiudp_h */
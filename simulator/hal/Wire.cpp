@@ -0,0 +1,105 @@
+/*
+ * Wire.cpp
+ * Host-native stand-in for the Arduino I2C master.
+ */
+
+#include "Wire.h"
+#include "sim.h"
+
+namespace {
+
+//START, STOP and the gaps around them, in bit times.
+const uint32_t FRAMING_BITS = 2;
+
+//Every byte on the bus is eight data bits plus the ACK bit.
+uint32_t transferMicros(uint32_t bytes, uint32_t bitMicros) {
+  return (FRAMING_BITS + bytes * 9) * bitMicros;
+}
+
+}  // namespace
+
+TwoWire::TwoWire() : txAddress(0), txLength(0), rxIndex(0), rxLength(0), bitMicros(10) {
+}
+
+void TwoWire::begin(void) {
+}
+
+void TwoWire::setClock(uint32_t clock) {
+  bitMicros = clock >= 1000000UL ? 1 : 1000000UL / clock;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddress = address;
+  txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (txLength >= BUFFER_LENGTH) {
+    return 0;                      //Buffer full, byte is dropped exactly as on target.
+  }
+  txBuffer[txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity) {
+  size_t n = 0;
+  while (quantity-- && write(*data++)) {
+    n++;
+  }
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  sim::I2CDevice *device = sim::findI2C(txAddress);
+  //A missing device NACKs its address, the payload is never clocked out.
+  uint32_t bytes = device ? txLength + 1 : 1;
+  uint32_t us = transferMicros(bytes, bitMicros);
+
+  sim::Stats &stats = sim::stats();
+  stats.i2cTransactions++;
+  stats.i2cBytes += bytes;
+  stats.i2cMicros += us;
+  sim::advance(us);
+
+  uint8_t length = txLength;
+  txLength = 0;
+  if (!device) {
+    return 2;
+  }
+  device->write(txBuffer, length);
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop) {
+  (void)sendStop;
+  if (quantity > BUFFER_LENGTH) {
+    quantity = BUFFER_LENGTH;
+  }
+  sim::I2CDevice *device = sim::findI2C(address);
+  rxIndex = 0;
+  rxLength = device ? (uint8_t)device->read(rxBuffer, quantity) : 0;
+
+  uint32_t bytes = 1 + rxLength;
+  uint32_t us = transferMicros(bytes, bitMicros);
+  sim::Stats &stats = sim::stats();
+  stats.i2cTransactions++;
+  stats.i2cBytes += bytes;
+  stats.i2cMicros += us;
+  sim::advance(us);
+  return rxLength;
+}
+
+int TwoWire::available(void) {
+  return rxLength - rxIndex;
+}
+
+int TwoWire::read(void) {
+  return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1;
+}
+
+int TwoWire::peek(void) {
+  return rxIndex < rxLength ? rxBuffer[rxIndex] : -1;
+}
+
+TwoWire Wire;
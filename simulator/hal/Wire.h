@@ -0,0 +1,45 @@
+/*
+ * Wire.h
+ * Host-native stand-in for the Arduino I2C master. Transactions are routed to
+ * the device models attached with sim::attachI2C() and charged bus time at
+ * 100 kHz.
+ */
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include "Arduino.h"
+
+//Same transmit/receive buffer size as the classic AVR Wire library.
+#define BUFFER_LENGTH 32
+
+class TwoWire : public Print {
+  public:
+    TwoWire();
+    void begin(void);
+    void setClock(uint32_t clock);
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+    uint8_t requestFrom(int address, int quantity) { return requestFrom((uint8_t)address, (uint8_t)quantity); }
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t quantity);
+    using Print::write;
+    int available(void);
+    int read(void);
+    int peek(void);
+
+  private:
+    uint8_t txAddress;
+    uint8_t txBuffer[BUFFER_LENGTH];
+    uint8_t txLength;
+    uint8_t rxBuffer[BUFFER_LENGTH];
+    uint8_t rxIndex;
+    uint8_t rxLength;
+    uint32_t bitMicros;
+};
+
+extern TwoWire Wire;
+
+#endif  /* TwoWire_h */
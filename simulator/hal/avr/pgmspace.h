@@ -0,0 +1,20 @@
+/*
+ * avr/pgmspace.h
+ * On the host flash and RAM share one address space, so PROGMEM data is
+ * read straight through the pointer.
+ */
+
+#ifndef PGMSPACE_H
+#define PGMSPACE_H
+
+#include <stdint.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#endif  /* PGMSPACE_H */
@@ -0,0 +1,24 @@
+/*
+ * avr/sleep.h
+ * Sleep modes. sleep_cpu() idles in virtual time until the next interrupt,
+ * which at the latest is the millis() timer tick.
+ */
+
+#ifndef SLEEP_H
+#define SLEEP_H
+
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE     0
+#define SLEEP_MODE_STANDBY  1
+#define SLEEP_MODE_PWR_DOWN 2
+
+extern uint8_t sleepMode;
+
+#define set_sleep_mode(mode) (sleepMode = (mode))
+#define sleep_enable()
+#define sleep_disable()
+void sleep_cpu(void);
+#define sleep_mode() sleep_cpu()
+
+#endif  /* SLEEP_H */
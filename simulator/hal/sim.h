@@ -0,0 +1,112 @@
+/*
+ * sim.h
+ * Virtual time kernel behind the host-native Arduino stand-in.
+ *
+ * Nothing in here is visible to the sketch. The stand-in core (Arduino.cpp,
+ * Wire.cpp, ...) uses it to charge virtual time for every blocking call, and
+ * the device models use it to schedule pin edges and answer I2C traffic.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <functional>
+
+namespace sim {
+
+/*
+  =================
+  || Virtual time ||
+  ================= */
+uint64_t nowMicros();
+
+//Consume 'us' microseconds of virtual time. Every event that falls due on
+//the way is delivered, including interrupt handlers attached by the sketch.
+void advance(uint32_t us);
+
+//Same as advance(), but the time is booked as blocked in delay() and friends.
+void block(uint32_t us);
+
+//Same as advance(), but the time is booked as spent in a sleep mode.
+void idle(uint32_t us);
+
+//Run 'fn' once virtual time has reached 'atUs'.
+void schedule(uint64_t atUs, std::function<void()> fn);
+
+//Frequency error of the 32.768 kHz oscillator behind the RTC peripheral, in
+//ppm. Positive runs fast. The CPU clock (millis(), micros()) stays exact.
+void setRtcErrorPpm(double ppm);
+
+/*
+  ==========
+  || Pins ||
+  ========== */
+const uint8_t NUM_PINS = 22;
+
+//Level driven onto a pin by the outside world (sensor, button, ...). Edges
+//are delivered to interrupt handlers attached with attachInterrupt().
+void drivePin(uint8_t pin, uint8_t level);
+
+//Called whenever the sketch changes pin mode or output level, so that models
+//such as the DHT11 can see the host start pulse.
+typedef std::function<void(uint8_t mode, uint8_t level)> PinHook;
+void onPinChange(uint8_t pin, PinHook hook);
+
+/*
+  =================
+  || I2C devices ||
+  ================= */
+class I2CDevice {
+  public:
+    virtual ~I2CDevice() {}
+    virtual uint8_t address() const = 0;
+    //A master write transaction (beginTransmission() ... endTransmission()).
+    virtual void write(const uint8_t *data, size_t length) = 0;
+    //A master read transaction (requestFrom()). Returns bytes supplied.
+    virtual size_t read(uint8_t *data, size_t length) = 0;
+};
+
+void attachI2C(I2CDevice *device);
+I2CDevice *findI2C(uint8_t address);
+
+/*
+  =============
+  || Network ||
+  ============= */
+struct Network {
+  bool moduleFitted;            //WiFiNINA module answers on SPI.
+  bool accessPointInRange;      //WiFi.begin() succeeds.
+  bool ntpReachable;            //NTP server answers requests.
+  uint32_t ntpRoundTripMicros;
+  uint32_t utcAtStart;          //Wall clock (Unix time) when virtual time is zero.
+};
+
+Network &network();
+
+/*
+  ================
+  || Statistics ||
+  ================ */
+struct Stats {
+  uint64_t i2cTransactions;
+  uint64_t i2cBytes;
+  uint64_t i2cMicros;           //Time the sketch spent clocking the I2C bus.
+  uint64_t delayMicros;         //Time the sketch spent in delay()/delayMicroseconds().
+  uint64_t sleepMicros;         //Time the CPU spent in sleep_cpu() waiting for an interrupt.
+  uint64_t serialBytes;
+  uint64_t serialBlockedMicros; //Time the sketch spent waiting for a full UART TX buffer.
+  uint64_t interrupts;
+};
+
+Stats &stats();
+
+//Serial output is swallowed unless it is sent to a file (stdout to echo it).
+void setSerialOutput(FILE *out);
+FILE *serialOutput();
+
+}  // namespace sim
+
+#endif  /* SIM_H */
@@ -0,0 +1,39 @@
+# ino2cpp.awk
+# Turn an Arduino sketch into a C++ translation unit the way the Arduino
+# builder does: include Arduino.h and declare every top-level function just
+# before the first function definition.
+#
+# Usage: awk -f ino2cpp.awk sketch.ino sketch.ino > sketch.cpp
+
+function isDefinition(line) {
+  if (line ~ /^ISR[ \t]*\(/) {
+    return 0
+  }
+  return line ~ /^[A-Za-z_][A-Za-z0-9_]*([ \t]+[A-Za-z_][A-Za-z0-9_]*)*[ \t*&]+[A-Za-z_][A-Za-z0-9_]*[ \t]*\([^;]*\)[ \t]*\{/
+}
+
+# First pass: collect the prototypes.
+NR == FNR {
+  if (isDefinition($0)) {
+    proto = $0
+    sub(/[ \t]*\{.*$/, ";", proto)
+    prototypes[++count] = proto
+  }
+  next
+}
+
+FNR == 1 {
+  print "#include <Arduino.h>"
+  printf "#line 1 \"%s\"\n", FILENAME
+}
+
+{
+  if (!emitted && isDefinition($0)) {
+    for (i = 1; i <= count; i++) {
+      print prototypes[i]
+    }
+    printf "#line %d \"%s\"\n", FNR, FILENAME
+    emitted = 1
+  }
+  print
+}
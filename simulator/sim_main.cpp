@@ -0,0 +1,222 @@
+/*
+ * sim_main.cpp
+ * Runs the greenhouse sketch against the device models in virtual time and
+ * reports where each loop() pass spends its time.
+ *
+ * Usage: greenhouse_sim [--hours H] [--start HH:MM] [--no-wifi] [--no-ntp]
+ *                       [--rtc-ppm PPM] [--tank ML] [--flow-stops MS]
+ *                       [--probe-fault N:dead|stuck|noisy] [--valves]
+ *                       [--serial] [--serial-out FILE] [--screen]
+ */
+
+#include "greenhouse_rig.h"
+#include "hal/Arduino.h"
+#include "hal/sim.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+void setup();
+void loop();
+
+namespace {
+
+const uint32_t JUNE_15_2026_UTC = 1781481600UL;
+const uint32_t LOCAL_OFFSET_MINUTES = 120;        //CEST, local time on the simulated date.
+const uint32_t LOOP_OVERHEAD_US = 10;             //Arduino main() around each loop() call.
+
+struct Config {
+  double hours;
+  uint32_t startMinuteOfDay;
+  bool wifi;
+  bool ntp;
+  double rtcPpm;
+  uint32_t tankMl;
+  long flowStopsMs;             //Milliseconds into every pump run when water stops flowing, 0 for a pump that runs dry. Negative: never.
+  int faultyProbe;              //Moisture probe 1-4 that reads wrong, 0 for none.
+  rig::ProbeFault probeFault;
+  bool valves;                  //Two zones: pots 1-2 and 3-4 each behind a valve.
+  bool serial;
+  const char *serialFile;       //Serial output is written here, e.g. binary telemetry for telemetry2csv.
+  bool screen;
+};
+
+void usage() {
+  fprintf(stderr,
+          "usage: greenhouse_sim [--hours H] [--start HH:MM] [--no-wifi] [--no-ntp]\n"
+          "                      [--rtc-ppm PPM] [--tank ML] [--flow-stops MS]\n"
+          "                      [--probe-fault N:dead|stuck|noisy] [--valves]\n"
+          "                      [--serial] [--serial-out FILE] [--screen]\n");
+  exit(2);
+}
+
+Config parse(int argc, char **argv) {
+  Config c = { 24.0, 6 * 60, true, true, 0.0, 20000, -1, 0, rig::PROBE_OK, false, false, NULL, false };
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(arg, "--hours") && hasValue) {
+      c.hours = atof(argv[++i]);
+    }
+    else if (!strcmp(arg, "--start") && hasValue) {
+      unsigned h, m;
+      if (sscanf(argv[++i], "%u:%u", &h, &m) != 2 || h > 23 || m > 59) {
+        usage();
+      }
+      c.startMinuteOfDay = h * 60 + m;
+    }
+    else if (!strcmp(arg, "--rtc-ppm") && hasValue) {
+      c.rtcPpm = atof(argv[++i]);
+    }
+    else if (!strcmp(arg, "--tank") && hasValue) {
+      c.tankMl = (uint32_t)atol(argv[++i]);
+    }
+    else if (!strcmp(arg, "--flow-stops") && hasValue) {
+      c.flowStopsMs = atol(argv[++i]);
+    }
+    else if (!strcmp(arg, "--probe-fault") && hasValue) {
+      char kind[8];
+      if (sscanf(argv[++i], "%d:%7s", &c.faultyProbe, kind) != 2 || c.faultyProbe < 1 || c.faultyProbe > 4) {
+        usage();
+      }
+      if (!strcmp(kind, "dead")) {
+        c.probeFault = rig::PROBE_DEAD;
+      }
+      else if (!strcmp(kind, "stuck")) {
+        c.probeFault = rig::PROBE_STUCK;
+      }
+      else if (!strcmp(kind, "noisy")) {
+        c.probeFault = rig::PROBE_NOISY;
+      }
+      else {
+        usage();
+      }
+    }
+    else if (!strcmp(arg, "--valves")) {
+      c.valves = true;
+    }
+    else if (!strcmp(arg, "--no-wifi")) {
+      c.wifi = false;
+    }
+    else if (!strcmp(arg, "--no-ntp")) {
+      c.ntp = false;
+    }
+    else if (!strcmp(arg, "--serial")) {
+      c.serial = true;
+    }
+    else if (!strcmp(arg, "--serial-out") && hasValue) {
+      c.serialFile = argv[++i];
+    }
+    else if (!strcmp(arg, "--screen")) {
+      c.screen = true;
+    }
+    else {
+      usage();
+    }
+  }
+  return c;
+}
+
+double percentOf(uint64_t part, uint64_t whole) {
+  return whole ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Config config = parse(argc, argv);
+
+  sim::Network &net = sim::network();
+  net.accessPointInRange = config.wifi;
+  net.ntpReachable = config.ntp;
+  net.utcAtStart = JUNE_15_2026_UTC + (config.startMinuteOfDay + 1440 - LOCAL_OFFSET_MINUTES) % 1440 * 60;
+  FILE *serialFile = NULL;
+  if (config.serialFile != NULL) {
+    serialFile = fopen(config.serialFile, "wb");
+    if (serialFile == NULL) {
+      perror(config.serialFile);
+      return 1;
+    }
+  }
+  sim::setSerialOutput(serialFile != NULL ? serialFile : config.serial ? stdout : NULL);
+  sim::setRtcErrorPpm(config.rtcPpm);
+
+  rig::Options options;
+  options.startMinuteOfDay = config.startMinuteOfDay;
+  options.tankMilliliters = config.tankMl;
+  options.flowStopsAfterMicros = config.flowStopsMs < 0 ? UINT64_MAX : (uint64_t)config.flowStopsMs * 1000;
+  options.faultyProbe = config.faultyProbe - 1;
+  options.probeFault = config.probeFault;
+  options.valves = config.valves;
+  rig::build(options);
+
+  std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+  setup();
+  uint64_t setupMicros = sim::nowMicros();
+
+  //Operator: after the boot screens, MODE confirms the clock and starts the
+  //program. Without WiFi the clock digits are stepped through first.
+  int presses = config.wifi ? 1 : 5;
+  for (int i = 0; i < presses; i++) {
+    rig::pressModeButton(setupMicros + 15000000ULL + i * 1000000ULL);
+  }
+  sim::Stats atLoopStart = sim::stats();
+
+  uint64_t endMicros = (uint64_t)(config.hours * 3600.0 * 1e6);
+  std::vector<uint32_t> latency;
+  while (sim::nowMicros() < endMicros) {
+    uint64_t passStart = sim::nowMicros();
+    loop();
+    sim::advance(LOOP_OVERHEAD_US);
+    latency.push_back((uint32_t)(sim::nowMicros() - passStart));
+  }
+  double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+  sim::Stats s = sim::stats();
+  uint64_t loopMicros = sim::nowMicros() - setupMicros;
+  size_t passes = latency.size() ? latency.size() : 1;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < latency.size(); i++) {
+    sum += latency[i];
+  }
+  std::vector<uint32_t> sorted(latency);
+  std::sort(sorted.begin(), sorted.end());
+  uint32_t p99 = sorted.empty() ? 0 : sorted[sorted.size() * 99 / 100];
+  uint32_t worst = sorted.empty() ? 0 : sorted.back();
+  rig::Observations o = rig::observe();
+
+  printf("simulated        %.2f h virtual in %.2f s host (setup() %.1f s)\n",
+         (double)sim::nowMicros() / 3.6e9, wallSeconds, (double)setupMicros / 1e6);
+  printf("loop() passes    %zu\n", latency.size());
+  printf("loop latency     mean %.1f ms, p99 %.1f ms, max %.1f ms\n",
+         (double)sum / passes / 1000.0, p99 / 1000.0, worst / 1000.0);
+  printf("I2C per pass     %.1f transactions, %.1f bytes, %.1f ms on the bus\n",
+         (double)(s.i2cTransactions - atLoopStart.i2cTransactions) / passes,
+         (double)(s.i2cBytes - atLoopStart.i2cBytes) / passes,
+         (double)(s.i2cMicros - atLoopStart.i2cMicros) / passes / 1000.0);
+  printf("serial per pass  %.1f bytes\n", (double)(s.serialBytes - atLoopStart.serialBytes) / passes);
+  printf("time in loop()   %.1f%% I2C, %.1f%% delay(), %.1f%% asleep, %.1f%% serial TX full\n",
+         percentOf(s.i2cMicros - atLoopStart.i2cMicros, loopMicros),
+         percentOf(s.delayMicros - atLoopStart.delayMicros, loopMicros),
+         percentOf(s.sleepMicros - atLoopStart.sleepMicros, loopMicros),
+         percentOf(s.serialBlockedMicros - atLoopStart.serialBlockedMicros, loopMicros));
+  printf("interrupts       %llu\n", (unsigned long long)s.interrupts);
+  printf("relay writes     %u (state 0x%02X)\n", o.relayWrites, o.relayState);
+  printf("pump             %.1f s on, %u ml delivered\n", o.pumpOnMicros / 1e6, o.waterDeliveredMl);
+  printf("pump runs        %u, longest dry run %.0f ms\n", o.pumpRuns, o.longestDryRunMicros / 1e3);
+  printf("soil moisture    %d %d %d %d\n", o.moisture[0], o.moisture[1], o.moisture[2], o.moisture[3]);
+  printf("water per pot    %u %u %u %u ml\n", o.potWaterMl[0], o.potWaterMl[1], o.potWaterMl[2], o.potWaterMl[3]);
+  printf("display crc32    %08X\n", o.displayChecksum);
+
+  if (config.screen) {
+    rig::printDisplay();
+  }
+  if (serialFile != NULL) {
+    fclose(serialFile);
+  }
+  return 0;
+}
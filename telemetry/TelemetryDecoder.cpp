@@ -0,0 +1,95 @@
+/*
+ * TelemetryDecoder.cpp
+ */
+
+#include "TelemetryDecoder.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+namespace telemetry {
+
+Decoder::Decoder()
+    : length(0), overflow(false), started(false), haveSequence(false), nextSequence(0),
+      good(0), bad(0), lost(0) {}
+
+bool Decoder::feed(uint8_t byte, TelemetryRecord &record) {
+  if (byte != 0) {
+    if (length < sizeof(frame)) {
+      frame[length++] = byte;
+    }
+    else {
+      overflow = true;
+    }
+    return false;
+  }
+
+  //End of frame. Bytes before the first zero may be the tail of a frame sent before the capture started.
+  bool decoded = length > 0 && !overflow && telemetryDecode(frame, length, record);
+  bool counted = started && length > 0;
+  started = true;
+  length = 0;
+  overflow = false;
+  if (!decoded) {
+    bad += counted ? 1 : 0;
+    return false;
+  }
+
+  if (haveSequence) {
+    lost += (uint8_t)(record.sequence - nextSequence);
+  }
+  haveSequence = true;
+  nextSequence = record.sequence + 1;
+  good++;
+  return true;
+}
+
+/*
+  =========
+  || CSV ||
+  ========= */
+namespace {
+
+void writeTenths(FILE *out, int16_t value) {
+  if (value != TELEMETRY_NO_VALUE) {
+    fprintf(out, "%s%d.%d", value < 0 ? "-" : "", abs(value) / 10, abs(value) % 10);
+  }
+}
+
+int bit(uint8_t bits, uint8_t mask) {
+  return (bits & mask) != 0;
+}
+
+}  // namespace
+
+void writeCsvHeader(FILE *out) {
+  fprintf(out,
+          "time,sequence,moisture1,moisture2,moisture3,moisture4,temperature,humidity,"
+          "light,uv,water_flow_ml_min,fan_speed,water_today,temp_threshold,"
+          "pump,led_lighting,fan,fan_low_speed,"
+          "moisture_dry,moisture_wet,temperature_high,water_flow_fault,water_level_low,led_lighting_fault,"
+          "program_started,wifi_connected,clock_synced,action\n");
+}
+
+void writeCsvRow(FILE *out, const TelemetryRecord &r) {
+  time_t t = (time_t)r.time;
+  struct tm utc;
+  gmtime_r(&t, &utc);
+  char stamp[32];
+  strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+  fprintf(out, "%s,%u,%d,%d,%d,%d,", stamp, r.sequence, r.moisture[0], r.moisture[1], r.moisture[2], r.moisture[3]);
+  writeTenths(out, r.temperature);
+  fputc(',', out);
+  writeTenths(out, r.humidity);
+  fprintf(out, ",%u,%u,%u,%u,%u,%u,", r.light, r.uv, r.waterFlow, r.fanSpeed, r.waterToday, r.tempThreshold);
+  fprintf(out, "%d,%d,%d,%d,", bit(r.outputs, TELEMETRY_PUMP), bit(r.outputs, TELEMETRY_LED_LIGHTING),
+          bit(r.outputs, TELEMETRY_FAN), bit(r.outputs, TELEMETRY_FAN_LOW_SPEED));
+  fprintf(out, "%d,%d,%d,%d,%d,%d,", bit(r.faults, TELEMETRY_MOISTURE_DRY), bit(r.faults, TELEMETRY_MOISTURE_WET),
+          bit(r.faults, TELEMETRY_TEMPERATURE_HIGH), bit(r.faults, TELEMETRY_WATER_FLOW),
+          bit(r.faults, TELEMETRY_WATER_LEVEL), bit(r.faults, TELEMETRY_LED_LIGHTING_FAULT));
+  fprintf(out, "%d,%d,%d,%u\n", bit(r.status, TELEMETRY_PROGRAM_STARTED), bit(r.status, TELEMETRY_WIFI_CONNECTED),
+          bit(r.status, TELEMETRY_CLOCK_SYNCED), r.action);
+}
+
+}  // namespace telemetry
@@ -0,0 +1,51 @@
+/*
+ * TelemetryDecoder.h
+ * Turns the byte stream from the greenhouse serial port back into telemetry
+ * records, and records into CSV.
+ *
+ * Bytes are collected up to each zero byte and the frame is checked by
+ * telemetryDecode(). A stream that starts in the middle of a frame, or bytes
+ * lost on the line, cost the broken frame only. Gaps in the record sequence
+ * count the frames that never arrived.
+ */
+
+#ifndef TELEMETRY_DECODER_H
+#define TELEMETRY_DECODER_H
+
+#include "TelemetryFrame.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+namespace telemetry {
+
+class Decoder {
+  public:
+    Decoder();
+
+    //Feed one byte. Returns true when it completed a good frame, then 'record' holds it.
+    bool feed(uint8_t byte, TelemetryRecord &record);
+
+    unsigned long records() const { return good; }
+    unsigned long badFrames() const { return bad; }
+    unsigned long lostRecords() const { return lost; }
+
+  private:
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    size_t length;
+    bool overflow;                //Frame longer than any good one, dropped at its end.
+    bool started;                 //False until the first zero: a capture may start mid-frame.
+    bool haveSequence;
+    uint8_t nextSequence;
+    unsigned long good;
+    unsigned long bad;
+    unsigned long lost;
+};
+
+//One line per record. Values that could not be read are left empty.
+void writeCsvHeader(FILE *out);
+void writeCsvRow(FILE *out, const TelemetryRecord &record);
+
+}  // namespace telemetry
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * telemetry2csv.cpp
+ * Decodes binary greenhouse telemetry into CSV on stdout, one line per
+ * record. Reads a capture file, or stdin when no file is given, so a serial
+ * port can be piped in live. Frame counts go to stderr at the end.
+ *
+ * Usage: telemetry2csv [FILE]
+ */
+
+#include "TelemetryDecoder.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int main(int argc, char **argv) {
+  if (argc > 2 || (argc == 2 && !strcmp(argv[1], "--help"))) {
+    fprintf(stderr, "usage: telemetry2csv [FILE]\n");
+    return 2;
+  }
+  FILE *in = stdin;
+  if (argc == 2) {
+    in = fopen(argv[1], "rb");
+    if (in == NULL) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+
+  telemetry::Decoder decoder;
+  TelemetryRecord record;
+  telemetry::writeCsvHeader(stdout);
+  int c;
+  while ((c = fgetc(in)) != EOF) {
+    if (decoder.feed((uint8_t)c, record)) {
+      telemetry::writeCsvRow(stdout, record);
+      if (in == stdin) {
+        fflush(stdout);             //Live port: show each record as it comes.
+      }
+    }
+  }
+
+  fprintf(stderr, "%lu records, %lu bad frames, %lu records lost\n",
+          decoder.records(), decoder.badFrames(), decoder.lostRecords());
+  if (in != stdin) {
+    fclose(in);
+  }
+  return 0;
+}